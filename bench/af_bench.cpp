@@ -0,0 +1,165 @@
+// 房颤检测基准: 合成ECG经 RPeakDetector -> AfDetector, 统计发作检出、
+// 起止时刻误差、窦律误报, 以及单搏耗时与单核可支撑的床位数
+//
+// 用法: af_bench [每段分钟=10] [采样率=200]
+// 漏检发作、窦律误报或起始误差超过60秒时返回非零
+#include "rpeakdetector.h"
+#include "afdetector.h"
+#include "ecgsimulator.h"
+#include <QElapsedTimer>
+#include <QtMath>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+constexpr double kMaxOnsetErrorSec = 60.0;
+
+struct Segment {
+    bool af;
+    double heartRate;
+    double hrVariability;
+    double ectopicRate;
+};
+
+struct Scenario {
+    const char* name;
+    QVector<Segment> segments;
+};
+
+struct Interval {
+    double start;
+    double end;
+};
+
+// 各段独立生成后拼接, 返回房颤段的真实区间
+QVector<double> makeRecord(const Scenario& scenario, int minutes, int sampleRate,
+                           QVector<Interval>& afTruth)
+{
+    QVector<double> record;
+    quint32 seed = 777;
+    for (const Segment& seg : scenario.segments) {
+        EcgSimulator::Config config;
+        config.sampleRate = sampleRate;
+        config.heartRate = seg.heartRate;
+        config.hrVariability = seg.hrVariability;
+        config.ectopicRate = seg.ectopicRate;
+        config.atrialFibrillation = seg.af;
+        config.seed = seed++;
+
+        double start = static_cast<double>(record.size()) / sampleRate;
+        EcgSimulator simulator(config);
+        record += simulator.generate(minutes * 60 * sampleRate);
+        if (seg.af) {
+            afTruth.append({ start, static_cast<double>(record.size()) / sampleRate });
+        }
+    }
+    return record;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    int minutes = argc > 1 ? std::atoi(argv[1]) : 10;
+    int sampleRate = argc > 2 ? std::atoi(argv[2]) : 200;
+    if (minutes <= 0) minutes = 10;
+    if (sampleRate <= 0) sampleRate = 200;
+
+    const QVector<Scenario> scenarios = {
+        { "sinus-70",        { { false, 70.0, 0.03, 0.00 } } },
+        { "sinus-hrv-5%",    { { false, 65.0, 0.05, 0.00 } } },
+        { "sinus-pvc-10%",   { { false, 72.0, 0.03, 0.10 } } },
+        { "paroxysmal-af",   { { false, 70.0, 0.03, 0.00 },
+                               { true,  95.0, 0.00, 0.00 },
+                               { false, 70.0, 0.03, 0.00 } } },
+        { "persistent-af",   { { true,  85.0, 0.00, 0.00 } } },
+        { "af-pvc",          { { false, 72.0, 0.03, 0.05 },
+                               { true,  90.0, 0.00, 0.05 } } },
+    };
+
+    std::printf("af_bench: %d min per segment @ %d Hz, window %d RR\n",
+                minutes, sampleRate, AfDetector::kWindow);
+    std::printf("%-15s %6s %6s %6s %10s %10s %8s\n",
+                "scenario", "beats", "truth", "found", "onset s", "end s", "false");
+
+    bool ok = true;
+    QVector<RPeakInfo> allPeaks;
+
+    for (const Scenario& scenario : scenarios) {
+        QVector<Interval> truth;
+        QVector<double> record = makeRecord(scenario, minutes, sampleRate, truth);
+
+        RPeakDetector detector;
+        detector.setSampleRate(sampleRate);
+        detector.processSamples(record);
+        const QVector<RPeakInfo>& peaks = detector.detectedPeaks();
+        allPeaks += peaks;
+
+        // 逐搏输入, 记录状态机的起止转换
+        AfDetector af;
+        QVector<AfEpisode> episodes;
+        bool wasInAf = false;
+        for (const RPeakInfo& peak : peaks) {
+            af.addBeat(peak);
+            if (af.inAtrialFibrillation() != wasInAf) {
+                wasInAf = af.inAtrialFibrillation();
+                if (wasInAf) {
+                    episodes.append(af.currentEpisode());
+                } else {
+                    episodes.last().endTime = af.currentEpisode().endTime;
+                }
+            }
+        }
+
+        // 与真实区间匹配: 有重叠即视为检出
+        int found = 0;
+        int falseEpisodes = 0;
+        double maxOnsetErr = 0.0;
+        double maxEndErr = 0.0;
+        double recordEnd = static_cast<double>(record.size()) / sampleRate;
+        for (const AfEpisode& ep : episodes) {
+            double epEnd = ep.endTime > 0.0 ? ep.endTime : recordEnd;
+            bool matched = false;
+            for (const Interval& t : truth) {
+                if (ep.onsetTime < t.end && epEnd > t.start) {
+                    matched = true;
+                    maxOnsetErr = qMax(maxOnsetErr, qAbs(ep.onsetTime - t.start));
+                    // 记录末尾仍在发作的不计结束误差
+                    if (t.end < recordEnd) {
+                        maxEndErr = qMax(maxEndErr, qAbs(epEnd - t.end));
+                    }
+                }
+            }
+            if (matched) ++found; else ++falseEpisodes;
+        }
+
+        std::printf("%-15s %6d %6d %6d %10.1f %10.1f %8d\n",
+                    scenario.name, peaks.size(), truth.size(), found,
+                    maxOnsetErr, maxEndErr, falseEpisodes);
+
+        if (found != truth.size() || falseEpisodes > 0 || maxOnsetErr > kMaxOnsetErrorSec) {
+            ok = false;
+        }
+    }
+
+    // 吞吐量: 反复输入全部心搏, 时间回退时检测器自动重置
+    const int passes = qMax(1, 2000000 / qMax(1, allPeaks.size()));
+    AfDetector af;
+    QElapsedTimer timer;
+    timer.start();
+    for (int p = 0; p < passes; ++p) {
+        for (const RPeakInfo& peak : allPeaks) {
+            af.addBeat(peak);
+        }
+    }
+    qint64 elapsedNs = qMax<qint64>(1, timer.nsecsElapsed());
+    double nsPerBeat = static_cast<double>(elapsedNs) / (static_cast<double>(passes) * allPeaks.size());
+
+    // 按120bpm (2搏/秒) 估算单核可同时监护的床位数
+    std::printf("throughput: %.1f ns/beat, %.0f beds/core at 120 bpm\n",
+                nsPerBeat, 1e9 / (nsPerBeat * 2.0));
+
+    std::printf("%s\n", ok ? "PASS" : "FAIL: missed/false AF episode or onset error too large");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+// 特征点定位基准: 合成ECG (已知各波起止) 上统计 QRS宽度、PR、QT、QTc 的误差,
+// 以及每搏定位耗时
+//
+// 用法: delineator_bench [分钟=5] [采样率=200]
+// 平均误差超过 kMaxBiasMs, 或标准差超过CSE容差 (各间期两端点容差的平方和根) 时返回非零
+#include "rpeakdetector.h"
+#include "ecgdelineator.h"
+#include "ecgsimulator.h"
+#include <QElapsedTimer>
+#include <QtMath>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+constexpr double kMaxBiasMs = 10.0;
+
+// CSE 工作组给出的特征点标准差容差 (ms)
+constexpr double kCsePOnset = 10.2;
+constexpr double kCseQrsOnset = 6.5;
+constexpr double kCseQrsOffset = 11.6;
+constexpr double kCseTEnd = 30.6;
+constexpr double kWarmupSec = 3.0;
+
+struct ErrorStats {
+    double maxSd = 0.0;
+    int n = 0;
+    double sum = 0.0;
+    double sum2 = 0.0;
+
+    void add(double err)
+    {
+        ++n;
+        sum += err;
+        sum2 += err * err;
+    }
+    double mean() const { return n > 0 ? sum / n : 0.0; }
+    double sd() const { return n > 0 ? qSqrt(qMax(0.0, sum2 / n - mean() * mean())) : 0.0; }
+    bool ok() const { return n > 0 && qAbs(mean()) <= kMaxBiasMs && sd() <= maxSd; }
+};
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    int minutes = argc > 1 ? std::atoi(argv[1]) : 5;
+    int sampleRate = argc > 2 ? std::atoi(argv[2]) : 200;
+    if (minutes <= 0) minutes = 5;
+    if (sampleRate <= 0) sampleRate = 200;
+
+    struct Scenario { const char* name; double heartRate; double noiseLevel; };
+    const Scenario scenarios[] = {
+        { "hr-50",       50.0,  5.0 },
+        { "hr-60",       60.0,  5.0 },
+        { "hr-75",       75.0,  5.0 },
+        { "hr-100",     100.0,  5.0 },
+        { "hr-130",     130.0,  5.0 },
+        { "noise-10mV",  70.0, 10.0 },
+    };
+
+    std::printf("delineator_bench: %d min @ %d Hz, errors in ms as mean/sd\n", minutes, sampleRate);
+    std::printf("%-11s %6s %5s %13s %13s %13s %13s %9s\n",
+                "scenario", "beats", "P %", "QRS", "PR", "QT", "QTc", "ns/beat");
+
+    bool ok = true;
+    for (const Scenario& sc : scenarios) {
+        EcgSimulator::Config config;
+        config.sampleRate = sampleRate;
+        config.heartRate = sc.heartRate;
+        config.noiseLevel = sc.noiseLevel;
+        config.seed = 4242;
+        EcgSimulator simulator(config);
+        QVector<double> record = simulator.generate(minutes * 60 * sampleRate);
+
+        // 实时路径: 定位在检测器内部随数据流完成; 检测器只保留最近的逐搏结果, 全部心搏从信号收集
+        RPeakDetector detector;
+        detector.setSampleRate(sampleRate);
+        QVector<BeatInfo> delineated;
+        QObject::connect(&detector, &QrsDetector::beatDelineated,
+                         [&delineated](const BeatInfo& beat) { delineated.append(beat); });
+        detector.processSamples(record);
+
+        const double rr = 60.0 / sc.heartRate;
+        const EcgSimulator::BeatTiming truth = EcgSimulator::normalBeatTiming(rr);
+        ErrorStats qrs{ qSqrt(kCseQrsOnset * kCseQrsOnset + kCseQrsOffset * kCseQrsOffset) };
+        ErrorStats pr{ qSqrt(kCsePOnset * kCsePOnset + kCseQrsOnset * kCseQrsOnset) };
+        ErrorStats qt{ qSqrt(kCseQrsOnset * kCseQrsOnset + kCseTEnd * kCseTEnd) };
+        ErrorStats qtc = qt;
+        int beats = 0;
+        int withP = 0;
+        for (const BeatInfo& beat : delineated) {
+            if (beat.timestamp < kWarmupSec || beat.rrInterval <= 0.0) continue;
+            ++beats;
+            qrs.add(beat.qrsWidthMs - truth.qrsWidth * 1000.0);
+            if (beat.hasPWave()) {
+                ++withP;
+                pr.add(beat.prIntervalMs - truth.prInterval * 1000.0);
+            }
+            if (beat.tEnd >= 0) {
+                qt.add(beat.qtIntervalMs - truth.qtInterval * 1000.0);
+                qtc.add(beat.qtcMs - truth.qtInterval * 1000.0 / qSqrt(rr));
+            }
+        }
+
+        // 单独计时: 对全部R波重做一次定位
+        const auto& peaks = detector.detectedPeaks();
+        const int before = EcgDelineator::samplesBefore(sampleRate);
+        EcgDelineator::Workspace work;
+        QElapsedTimer timer;
+        timer.start();
+        double checksum = 0.0;
+        for (const RPeakInfo& peak : peaks) {
+            int start = qMax(0, peak.sampleIndex - before);
+            int end = qMin(record.size() - 1,
+                           peak.sampleIndex + EcgDelineator::samplesAfter(sampleRate, peak.rrInterval));
+            BeatInfo b = EcgDelineator::delineate(peak, record.constData() + start,
+                                                  end - start + 1, start, sampleRate, work);
+            checksum += b.qtIntervalMs;
+        }
+        double nsPerBeat = static_cast<double>(timer.nsecsElapsed()) / qMax(1, peaks.size());
+
+        std::printf("%-11s %6d %5.1f %6.1f/%-6.1f %6.1f/%-6.1f %6.1f/%-6.1f %6.1f/%-6.1f %9.0f\n",
+                    sc.name, beats, beats > 0 ? 100.0 * withP / beats : 0.0,
+                    qrs.mean(), qrs.sd(), pr.mean(), pr.sd(), qt.mean(), qt.sd(),
+                    qtc.mean(), qtc.sd(), nsPerBeat + checksum * 0.0);
+
+        if (!qrs.ok() || !pr.ok() || !qt.ok() || !qtc.ok() || withP < beats * 99 / 100) {
+            ok = false;
+        }
+    }
+
+    std::printf("%s\n", ok ? "PASS" : "FAIL: delineation error above limit");
+    return ok ? 0 : 1;
+}
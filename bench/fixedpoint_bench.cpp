@@ -0,0 +1,90 @@
+// 定点 vs 浮点 R波检测基准: 比较检出一致性与每样本耗时
+//
+// 用法: fixedpoint_bench [秒数=600] [采样率=200]
+#include "rpeakdetector.h"
+#include "fixedrpeakdetector.h"
+#include "ecgsimulator.h"
+#include <QElapsedTimer>
+#include <QtMath>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+// 合成ECG (mV) 量化为 0-4095 ADC计数
+QVector<qint16> makeAdcRecord(int seconds, int sampleRate)
+{
+    EcgSimulator::Config config;
+    config.sampleRate = sampleRate;
+    config.seed = 12345;
+    EcgSimulator simulator(config);
+
+    const QVector<double> mv = simulator.generate(seconds * sampleRate);
+    QVector<qint16> adc(mv.size());
+    for (int i = 0; i < adc.size(); ++i) {
+        int count = FixedPointRPeakDetector::kAdcMid + qRound(mv[i] * 4095.0 / 3300.0);
+        adc[i] = static_cast<qint16>(qBound(0, count, 4095));
+    }
+    return adc;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    int seconds = argc > 1 ? std::atoi(argv[1]) : 600;
+    int sampleRate = argc > 2 ? std::atoi(argv[2]) : 200;
+    if (seconds <= 0) seconds = 600;
+    if (sampleRate <= 0) sampleRate = 200;
+
+    QVector<qint16> adc = makeAdcRecord(seconds, sampleRate);
+    QVector<double> mv(adc.size());
+    for (int i = 0; i < adc.size(); ++i) {
+        mv[i] = FixedPointRPeakDetector::adcToMillivolts(adc[i]);
+    }
+
+    RPeakDetector floatDetector;
+    floatDetector.setSampleRate(sampleRate);
+    FixedPointRPeakDetector fixedDetector;
+    fixedDetector.setSampleRate(sampleRate);
+
+    QElapsedTimer timer;
+    timer.start();
+    floatDetector.processSamples(mv);
+    qint64 floatNs = timer.nsecsElapsed();
+
+    timer.restart();
+    fixedDetector.processAdcSamples(adc);
+    qint64 fixedNs = timer.nsecsElapsed();
+
+    // 以浮点检出为参考, 允许 ±2 个样本的位置偏差
+    const auto& ref = floatDetector.detectedPeaks();
+    const auto& fix = fixedDetector.detectedPeaks();
+    int matched = 0;
+    int maxOffset = 0;
+    double maxAmpErr = 0.0;
+    int j = 0;
+    for (const RPeakInfo& r : ref) {
+        while (j < fix.size() && fix[j].sampleIndex < r.sampleIndex - 2) ++j;
+        if (j < fix.size() && qAbs(fix[j].sampleIndex - r.sampleIndex) <= 2) {
+            ++matched;
+            maxOffset = qMax(maxOffset, qAbs(fix[j].sampleIndex - r.sampleIndex));
+            maxAmpErr = qMax(maxAmpErr, qAbs(fix[j].amplitude - r.amplitude));
+            ++j;
+        }
+    }
+
+    int total = adc.size();
+    std::printf("fixedpoint_bench: %d s @ %d Hz (%d samples)\n", seconds, sampleRate, total);
+    std::printf("  float : %6d peaks  HR %3d bpm  %8.2f ns/sample\n",
+                ref.size(), floatDetector.currentHeartRate(), static_cast<double>(floatNs) / total);
+    std::printf("  fixed : %6d peaks  HR %3d bpm  %8.2f ns/sample  (%.2fx)\n",
+                fix.size(), fixedDetector.currentHeartRate(), static_cast<double>(fixedNs) / total,
+                static_cast<double>(floatNs) / qMax<qint64>(1, fixedNs));
+    std::printf("  match : %d/%d  max offset %d samples  max amplitude error %.2f mV\n",
+                matched, ref.size(), maxOffset, maxAmpErr);
+
+    // 一致性低于99%视为回归
+    bool ok = !ref.isEmpty() && matched >= ref.size() * 99 / 100 && qAbs(fix.size() - ref.size()) <= ref.size() / 100;
+    return ok ? 0 : 1;
+}
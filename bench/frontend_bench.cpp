@@ -0,0 +1,68 @@
+// Pan-Tompkins 前端基准: 编译期特化与通用实现的吞吐量对比, 并校验两者输出一致
+//
+// 用法: frontend_bench [秒数=600] [每包样本数=10]
+// 特化版本输出与通用版本不一致时返回非零
+#include "qrsfrontend.h"
+#include "ecgsimulator.h"
+#include <QElapsedTimer>
+#include <QVector>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+// 按包喂入前端, 返回每样本耗时 (ns)
+double runPackets(QrsFrontEnd& frontEnd, const QVector<double>& input, QVector<double>& output,
+                  int packetSize)
+{
+    frontEnd.reset();
+    output.resize(input.size());
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < input.size(); i += packetSize) {
+        int n = qMin(packetSize, input.size() - i);
+        frontEnd.process(input.constData() + i, output.data() + i, n);
+    }
+    return static_cast<double>(timer.nsecsElapsed()) / qMax(1, input.size());
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    int seconds = argc > 1 ? std::atoi(argv[1]) : 600;
+    int packetSize = argc > 2 ? std::atoi(argv[2]) : 10;
+    if (seconds <= 0) seconds = 600;
+    if (packetSize <= 0) packetSize = 10;
+
+    std::printf("frontend_bench: %d s per rate, %d samples/packet\n", seconds, packetSize);
+    std::printf("%6s %13s %11s %11s %8s %9s\n",
+                "rate", "specialised", "generic ns", "fixed ns", "speedup", "identical");
+
+    bool ok = true;
+    for (int sampleRate : {125, 200, 250, 360, 500, 1000}) {
+        EcgSimulator::Config config;
+        config.sampleRate = sampleRate;
+        config.seed = 1234;
+        EcgSimulator simulator(config);
+        QVector<double> input = simulator.generate(sampleRate * seconds);
+
+        auto generic = QrsFrontEnd::createGeneric(sampleRate);
+        auto dispatched = QrsFrontEnd::create(sampleRate);
+
+        QVector<double> genericOut, dispatchedOut;
+        double genericNs = runPackets(*generic, input, genericOut, packetSize);
+        double dispatchedNs = runPackets(*dispatched, input, dispatchedOut, packetSize);
+
+        bool identical = genericOut == dispatchedOut;
+        ok = ok && identical;
+
+        std::printf("%6d %13s %11.2f %11.2f %7.2fx %9s\n",
+                    sampleRate, dispatched->isSpecialised() ? "yes" : "no (fallback)",
+                    genericNs, dispatchedNs, genericNs / qMax(1e-9, dispatchedNs),
+                    identical ? "yes" : "NO");
+    }
+
+    std::printf("%s\n", ok ? "PASS" : "FAIL: specialised output differs from generic");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,232 @@
+// 图表渲染基准: EcgChartWidget 与 VitalsChartWidget 在 offscreen 平台下按帧驱动,
+// 每帧按 MQTT 分包送入合成数据, 触发一次渲染节拍, 再把控件整体渲染到 QImage。
+// 统计每帧各阶段耗时分位数、每帧堆分配次数/字节数, 以及每秒数据消耗的 CPU 时间
+//
+// 用法: render_bench [采样率=250] [显示窗口秒数=5] [数据秒数=20] [帧率=30]
+//                    [趋势分钟=60] [体征频率Hz=1] [chart|sweep]
+// 按模拟时间推进 (不等待墙钟), 结果只反映渲染路径本身的开销; 控件尺寸 1200x400
+#include "ecgchartwidget.h"
+#include "vitalschartwidget.h"
+#include "renderticker.h"
+#include "ecgsimulator.h"
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QImage>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <new>
+
+// ============================================================
+// 分配计数: 替换全局 operator new/delete
+// ============================================================
+
+namespace {
+
+std::atomic<qint64> g_allocCount{0};
+std::atomic<qint64> g_allocBytes{0};
+
+void* countedAlloc(std::size_t size)
+{
+    g_allocCount.fetch_add(1, std::memory_order_relaxed);
+    g_allocBytes.fetch_add(static_cast<qint64>(size), std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+} // namespace
+
+void* operator new(std::size_t size) { return countedAlloc(size); }
+void* operator new[](std::size_t size) { return countedAlloc(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+constexpr int kPacketMs = 40;
+constexpr int kWidth = 1200;
+constexpr int kHeight = 400;
+
+struct FrameStats {
+    QVector<qint64> ingestNs;   // 送入数据
+    QVector<qint64> updateNs;   // 渲染节拍 + 挂起事件 (曲线替换、坐标轴、布局)
+    QVector<qint64> renderNs;   // 渲染到 QImage
+    QVector<qint64> totalNs;
+    qint64 allocCount = 0;
+    qint64 allocBytes = 0;
+    double cpuSec = 0.0;
+};
+
+double percentileMs(QVector<qint64> ns, int percent)
+{
+    if (ns.isEmpty()) return 0.0;
+    std::sort(ns.begin(), ns.end());
+    return ns[qMin(ns.size() - 1, ns.size() * percent / 100)] / 1e6;
+}
+
+void printRow(const char* name, const QVector<qint64>& ns)
+{
+    std::printf("  %-8s p50 %7.3f ms  p95 %7.3f ms  p99 %7.3f ms  max %7.3f ms\n",
+                name, percentileMs(ns, 50), percentileMs(ns, 95),
+                percentileMs(ns, 99), percentileMs(ns, 100));
+}
+
+void printStats(const char* title, const FrameStats& stats, double dataSeconds)
+{
+    const int frames = stats.totalNs.size();
+    std::printf("%s: %d frames\n", title, frames);
+    printRow("ingest", stats.ingestNs);
+    printRow("update", stats.updateNs);
+    printRow("render", stats.renderNs);
+    printRow("total", stats.totalNs);
+    std::printf("  allocations %.1f /frame, %.1f KB/frame\n",
+                frames ? static_cast<double>(stats.allocCount) / frames : 0.0,
+                frames ? stats.allocBytes / 1024.0 / frames : 0.0);
+    std::printf("  CPU %.2f ms per data second (%.1f%% of one core in real time)\n",
+                1000.0 * stats.cpuSec / dataSeconds, 100.0 * stats.cpuSec / dataSeconds);
+}
+
+// 逐帧: feed 送入该帧的数据, 随后一次渲染节拍与一次完整渲染
+FrameStats runFrames(QWidget& widget, int frames, const std::function<void(int)>& feed)
+{
+    // 控件可见 (节拍中的可见性检查通过) 但不上屏, 绘制只发生在 render() 中
+    widget.setAttribute(Qt::WA_DontShowOnScreen);
+    widget.resize(kWidth, kHeight);
+    widget.show();
+    QCoreApplication::processEvents();
+    // 不由定时器驱动, 节拍由本循环手动发出
+    RenderTicker::shared()->removeClient(&widget);
+
+    const qreal dpr = widget.devicePixelRatioF();
+    QImage image(widget.size() * dpr, QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(dpr);
+
+    FrameStats stats;
+    QElapsedTimer timer;
+    const std::clock_t cpuStart = std::clock();
+    const qint64 allocStart = g_allocCount.load();
+    const qint64 bytesStart = g_allocBytes.load();
+    for (int frame = 0; frame < frames; ++frame) {
+        timer.start();
+        feed(frame);
+        const qint64 ingest = timer.nsecsElapsed();
+
+        timer.start();
+        emit RenderTicker::shared()->tick();
+        QCoreApplication::processEvents();
+        const qint64 update = timer.nsecsElapsed();
+
+        timer.start();
+        widget.render(&image);
+        const qint64 render = timer.nsecsElapsed();
+
+        stats.ingestNs.append(ingest);
+        stats.updateNs.append(update);
+        stats.renderNs.append(render);
+        stats.totalNs.append(ingest + update + render);
+    }
+    stats.cpuSec = static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+    // 统计数组自身的增长也计入, 相对控件开销可以忽略
+    stats.allocCount = g_allocCount.load() - allocStart;
+    stats.allocBytes = g_allocBytes.load() - bytesStart;
+    return stats;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    int sampleRate = argc > 1 ? std::atoi(argv[1]) : 250;
+    int windowSeconds = argc > 2 ? std::atoi(argv[2]) : 5;
+    int seconds = argc > 3 ? std::atoi(argv[3]) : 20;
+    int fps = argc > 4 ? std::atoi(argv[4]) : 30;
+    int trendMinutes = argc > 5 ? std::atoi(argv[5]) : 60;
+    double vitalsHz = argc > 6 ? std::atof(argv[6]) : 1.0;
+    const bool sweep = argc > 7 && std::strcmp(argv[7], "sweep") == 0;
+    if (sampleRate <= 0) sampleRate = 250;
+    if (windowSeconds <= 0) windowSeconds = 5;
+    if (seconds <= 0) seconds = 20;
+    if (fps <= 0) fps = 30;
+    if (trendMinutes <= 0) trendMinutes = 60;
+    if (vitalsHz <= 0.0) vitalsHz = 1.0;
+
+    const int frames = seconds * fps;
+    std::printf("render_bench: %d Hz ECG, %d s window, %d s of data at %d fps, "
+                "trend %d min at %.1f Hz, %dx%d\n",
+                sampleRate, windowSeconds, seconds, fps, trendMinutes, vitalsHz, kWidth, kHeight);
+
+    // ---- 心电 ----
+    {
+        // 预先生成全部数据 (含预热的一屏), 不把发生器开销计入
+        EcgSimulator::Config config;
+        config.sampleRate = sampleRate;
+        EcgSimulator simulator(config);
+        const QVector<double> data = simulator.generate((seconds + windowSeconds + 1) * sampleRate);
+        const int packetSamples = qMax(1, sampleRate * kPacketMs / 1000);
+
+        EcgChartWidget ecg;
+        ecg.setSampleRate(sampleRate);
+        ecg.setInputSampleRate(sampleRate);
+        ecg.setDisplayDuration(windowSeconds);
+        ecg.setAnimationEnabled(false);
+        if (sweep) ecg.setRenderMode(EcgChartWidget::RenderMode::Sweep);
+
+        // 预热: 先填满一屏
+        int fed = windowSeconds * sampleRate;
+        ecg.addDataPoints(data.mid(0, fed));
+
+        const int base = fed;
+        FrameStats stats = runFrames(ecg, frames, [&](int frame) {
+            const int due = base + static_cast<int>(qint64(frame + 1) * sampleRate / fps);
+            while (fed < due) {
+                const int count = qMin(packetSamples, due - fed);
+                ecg.addDataPoints(data.mid(fed, count));
+                fed += count;
+            }
+        });
+        printStats(sweep ? "EcgChartWidget (sweep)" : "EcgChartWidget (chart)", stats, seconds);
+    }
+
+    // ---- 趋势 ----
+    {
+        VitalsChartWidget vitals(VitalsChartWidget::Combined);
+        vitals.setTimeRange(trendMinutes);
+
+        // 预填整个时间范围的历史数据
+        const QDateTime now = QDateTime::currentDateTime();
+        const qint64 stepMs = qMax<qint64>(1, qRound64(1000.0 / vitalsHz));
+        const qint64 historyMs = qint64(trendMinutes) * 60 * 1000;
+        int n = 0;
+        for (qint64 t = historyMs; t > 0; t -= stepMs, ++n) {
+            const QDateTime ts = now.addMSecs(-t);
+            vitals.addTemperaturePoint(36.5 + 0.3 * ((n / 60) % 5) / 4.0, ts);
+            vitals.addHeartRatePoint(70 + n % 15, ts);
+            vitals.addBloodOxygenPoint(96 + n % 4, ts);
+        }
+
+        double pending = 0.0;
+        FrameStats stats = runFrames(vitals, frames, [&](int) {
+            pending += vitalsHz / fps;
+            for (; pending >= 1.0; pending -= 1.0, ++n) {
+                const QDateTime ts = QDateTime::currentDateTime();
+                vitals.addTemperaturePoint(36.5 + 0.3 * ((n / 60) % 5) / 4.0, ts);
+                vitals.addHeartRatePoint(70 + n % 15, ts);
+                vitals.addBloodOxygenPoint(96 + n % 4, ts);
+            }
+        });
+        printStats("VitalsChartWidget", stats, seconds);
+    }
+
+    return 0;
+}
@@ -0,0 +1,189 @@
+// R波检测准确度与吞吐量基准: 合成ECG (已知R波真实位置) 上对每种检测算法统计
+// 敏感度 Se、阳性预测值 +P、定位误差, 以及每样本CPU耗时, 用于按部署环境权衡成本与质量
+// 实时路径关闭特征点定位, 耗时只反映检测算法本身 (定位开销见 delineator_bench)
+//
+// 用法: rpeak_bench [分钟=10] [采样率=200] [最低Se/+P(%)=99] [最低吞吐(Msamp/s)=0] [算法=all]
+// 算法取设置项中的键名 (pan-tompkins / wavelet / envelope), 省略时全部运行
+// 任一场景准确度或吞吐量低于下限时返回非零, 可直接用于回归检查
+#include "qrsdetector.h"
+#include "rpeakdetector.h"
+#include "ecgsimulator.h"
+#include <QElapsedTimer>
+#include <QtMath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+namespace {
+
+// 匹配窗口 ±150ms (ANSI/AAMI EC57)
+constexpr double kMatchToleranceSec = 0.150;
+// 检测器前2秒为阈值学习期, 评估时跳过开头3秒
+constexpr double kWarmupSec = 3.0;
+
+struct Scenario {
+    const char* name;
+    double heartRate;
+    double hrVariability;
+    double noiseLevel;
+    double baselineWander;
+    double ectopicRate;
+};
+
+const Scenario kScenarios[] = {
+    { "baseline-60",   60.0, 0.00,  5.0,   0.0, 0.00 },
+    { "brady-40",      40.0, 0.00,  5.0,   0.0, 0.00 },
+    { "tachy-150",    150.0, 0.00,  5.0,   0.0, 0.00 },
+    { "hrv-70",        70.0, 0.08,  5.0,   0.0, 0.00 },
+    { "noise-25mV",    75.0, 0.03, 25.0,   0.0, 0.00 },
+    { "wander-150mV",  80.0, 0.03,  5.0, 150.0, 0.00 },
+    { "ectopic-10%",   72.0, 0.03,  5.0,   0.0, 0.10 },
+};
+
+struct Accuracy {
+    int truePositives = 0;
+    int falseNegatives = 0;
+    int falsePositives = 0;
+    double meanErrorMs = 0.0;
+    double sdErrorMs = 0.0;
+    double maxErrorMs = 0.0;
+
+    double sensitivity() const
+    {
+        int n = truePositives + falseNegatives;
+        return n > 0 ? 100.0 * truePositives / n : 0.0;
+    }
+    double ppv() const
+    {
+        int n = truePositives + falsePositives;
+        return n > 0 ? 100.0 * truePositives / n : 0.0;
+    }
+};
+
+// 真实R波与检出R波按时间顺序一一匹配 (双指针)
+Accuracy evaluate(const QVector<double>& truth, const QVector<RPeakInfo>& detected, double duration)
+{
+    Accuracy acc;
+    double sumErr = 0.0;
+    double sumErr2 = 0.0;
+
+    auto inRange = [duration](double t) {
+        return t >= kWarmupSec && t <= duration - kMatchToleranceSec;
+    };
+
+    int j = 0;
+    for (double t : truth) {
+        while (j < detected.size() && detected[j].timestamp < t - kMatchToleranceSec) {
+            if (inRange(detected[j].timestamp)) acc.falsePositives++;
+            ++j;
+        }
+        if (!inRange(t)) {
+            if (j < detected.size() && qAbs(detected[j].timestamp - t) <= kMatchToleranceSec) ++j;
+            continue;
+        }
+        if (j < detected.size() && qAbs(detected[j].timestamp - t) <= kMatchToleranceSec) {
+            double errMs = (detected[j].timestamp - t) * 1000.0;
+            acc.truePositives++;
+            sumErr += errMs;
+            sumErr2 += errMs * errMs;
+            acc.maxErrorMs = qMax(acc.maxErrorMs, qAbs(errMs));
+            ++j;
+        } else {
+            acc.falseNegatives++;
+        }
+    }
+    for (; j < detected.size(); ++j) {
+        if (inRange(detected[j].timestamp)) acc.falsePositives++;
+    }
+
+    if (acc.truePositives > 0) {
+        acc.meanErrorMs = sumErr / acc.truePositives;
+        acc.sdErrorMs = qSqrt(qMax(0.0, sumErr2 / acc.truePositives - acc.meanErrorMs * acc.meanErrorMs));
+    }
+    return acc;
+}
+
+void printRow(const char* scenario, const QString& mode, const Accuracy& acc, double nsPerSample)
+{
+    std::printf("%-14s %-20s %7d %5d %5d %8.2f %8.2f %8.2f %8.2f %8.2f %9.1f %9.2f\n",
+                scenario, qPrintable(mode), acc.truePositives, acc.falseNegatives, acc.falsePositives,
+                acc.sensitivity(), acc.ppv(), acc.meanErrorMs, acc.sdErrorMs, acc.maxErrorMs,
+                nsPerSample, 1e3 / nsPerSample);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    int minutes = argc > 1 ? std::atoi(argv[1]) : 10;
+    int sampleRate = argc > 2 ? std::atoi(argv[2]) : 200;
+    double minAccuracy = argc > 3 ? std::atof(argv[3]) : 99.0;
+    double minMsps = argc > 4 ? std::atof(argv[4]) : 0.0;
+    QString only = argc > 5 ? QString::fromLocal8Bit(argv[5]) : QString();
+    if (minutes <= 0) minutes = 10;
+    if (sampleRate <= 0) sampleRate = 200;
+
+    QList<QrsDetector::Algorithm> algorithms;
+    for (QrsDetector::Algorithm algorithm : QrsDetector::algorithms()) {
+        if (only.isEmpty() || only == QStringLiteral("all") || QrsDetector::algorithmKey(algorithm) == only) {
+            algorithms.append(algorithm);
+        }
+    }
+
+    const int total = minutes * 60 * sampleRate;
+    const double duration = static_cast<double>(total) / sampleRate;
+
+    std::printf("rpeak_bench: %d min @ %d Hz per scenario, limits Se/+P >= %.1f%%, >= %.2f Msamp/s\n",
+                minutes, sampleRate, minAccuracy, minMsps);
+    std::printf("%-14s %-20s %7s %5s %5s %8s %8s %8s %8s %8s %9s %9s\n",
+                "scenario", "detector", "TP", "FN", "FP", "Se %", "+P %",
+                "err ms", "sd ms", "max ms", "ns/samp", "Msamp/s");
+
+    bool ok = true;
+    for (const Scenario& s : kScenarios) {
+        EcgSimulator::Config config;
+        config.sampleRate = sampleRate;
+        config.heartRate = s.heartRate;
+        config.hrVariability = s.hrVariability;
+        config.noiseLevel = s.noiseLevel;
+        config.baselineWander = s.baselineWander;
+        config.ectopicRate = s.ectopicRate;
+        config.recordGroundTruth = true;
+        config.seed = 20240601;
+
+        EcgSimulator simulator(config);
+        QVector<double> record = simulator.generate(total);
+        const QVector<double>& truth = simulator.rPeakTimes();
+
+        auto check = [&](const QString& mode, const QVector<RPeakInfo>& peaks, qint64 ns) {
+            Accuracy acc = evaluate(truth, peaks, duration);
+            double nsPerSample = static_cast<double>(qMax<qint64>(1, ns)) / total;
+            printRow(s.name, mode, acc, nsPerSample);
+            if (acc.sensitivity() < minAccuracy || acc.ppv() < minAccuracy) ok = false;
+            if (1e3 / nsPerSample < minMsps) ok = false;
+        };
+
+        // 实时路径: 与 EcgChartWidget 相同的逐点因果检测
+        QElapsedTimer timer;
+        for (QrsDetector::Algorithm algorithm : algorithms) {
+            std::unique_ptr<QrsDetector> streaming(QrsDetector::create(algorithm));
+            streaming->setSampleRate(sampleRate);
+            streaming->setDelineationEnabled(false);
+            timer.start();
+            streaming->processSamples(record);
+            check(QrsDetector::algorithmKey(algorithm), streaming->detectedPeaks(), timer.nsecsElapsed());
+        }
+
+        // 离线路径: 历史回放的零相位整段分析
+        if (algorithms.contains(QrsDetector::Algorithm::PanTompkins)) {
+            RPeakDetector offline;
+            offline.setSampleRate(sampleRate);
+            timer.start();
+            offline.analyzeRecord(record);
+            check(QStringLiteral("pan-tompkins/offline"), offline.detectedPeaks(), timer.nsecsElapsed());
+        }
+    }
+
+    std::printf("%s\n", ok ? "PASS" : "FAIL: accuracy or throughput below limit");
+    return ok ? 0 : 1;
+}
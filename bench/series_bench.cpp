@@ -0,0 +1,164 @@
+// 波形曲线更新基准: 逐点 append + remove(0)、环形缓冲 + replace 与 M4 抽取三种方式下,
+// 每个数据包 (MQTT 分包) 的曲线更新耗时与随后一次重绘的耗时
+//
+// 用法: series_bench [秒数=30] [采样率=200] [显示窗口秒数=5] [每包样本数=10]
+// 默认使用 offscreen 平台, 无需显示器
+#include "waveformbuffer.h"
+#include "waveformdecimator.h"
+#include "ecgsimulator.h"
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QPainter>
+#include <QtCharts/QChartView>
+#include <QtCharts/QLineSeries>
+#include <QtCharts/QValueAxis>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+
+namespace {
+
+struct Timing {
+    double meanUs = 0.0;
+    double p50Us = 0.0;
+    double p95Us = 0.0;
+    double maxUs = 0.0;
+};
+
+Timing summarize(QVector<qint64> ns)
+{
+    Timing t;
+    if (ns.isEmpty()) return t;
+    std::sort(ns.begin(), ns.end());
+    double sum = 0.0;
+    for (qint64 v : ns) sum += v;
+    t.meanUs = sum / ns.size() / 1e3;
+    t.p50Us = ns[ns.size() / 2] / 1e3;
+    t.p95Us = ns[qMin(ns.size() - 1, ns.size() * 95 / 100)] / 1e3;
+    t.maxUs = ns.last() / 1e3;
+    return t;
+}
+
+// 与 EcgChartWidget 相同的图表结构
+struct Scene {
+    QChartView view;
+    QChart* chart = new QChart();
+    QLineSeries* series = new QLineSeries();
+    QValueAxis* axisX = new QValueAxis();
+    QValueAxis* axisY = new QValueAxis();
+
+    explicit Scene(int displaySeconds)
+    {
+        chart->legend()->hide();
+        chart->addSeries(series);
+        axisX->setRange(0, displaySeconds);
+        axisX->setTickCount(11);
+        axisX->setMinorTickCount(4);
+        axisY->setRange(-500.0, 500.0);
+        axisY->setTickCount(11);
+        chart->addAxis(axisX, Qt::AlignBottom);
+        chart->addAxis(axisY, Qt::AlignLeft);
+        series->attachAxis(axisX);
+        series->attachAxis(axisY);
+        view.setChart(chart);
+        view.setRenderHint(QPainter::Antialiasing);
+        view.resize(1000, 300);
+    }
+};
+
+void run(const char* name, const QVector<double>& samples, int sampleRate, int displaySeconds,
+         int packetSize, const std::function<void(Scene&, const double*, int)>& update)
+{
+    Scene scene(displaySeconds);
+    QImage frame(scene.view.size(), QImage::Format_ARGB32_Premultiplied);
+    QVector<qint64> updateNs;
+    QVector<qint64> renderNs;
+    QElapsedTimer timer;
+
+    for (int i = 0; i < samples.size(); i += packetSize) {
+        const int count = qMin(packetSize, samples.size() - i);
+
+        timer.start();
+        update(scene, samples.constData() + i, count);
+        const double maxX = static_cast<double>(i + count - 1) / sampleRate;
+        scene.axisX->setRange(qMax(0.0, maxX - displaySeconds), qMax(double(displaySeconds), maxX));
+        QCoreApplication::processEvents();
+        updateNs.append(timer.nsecsElapsed());
+
+        timer.start();
+        QPainter painter(&frame);
+        scene.view.render(&painter);
+        painter.end();
+        renderNs.append(timer.nsecsElapsed());
+    }
+
+    const Timing u = summarize(updateNs);
+    const Timing r = summarize(renderNs);
+    std::printf("%-16s %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f\n",
+                name, u.meanUs, u.p50Us, u.p95Us, u.maxUs, r.meanUs, r.p50Us, r.p95Us, r.maxUs);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    int seconds = argc > 1 ? std::atoi(argv[1]) : 30;
+    int sampleRate = argc > 2 ? std::atoi(argv[2]) : 200;
+    int displaySeconds = argc > 3 ? std::atoi(argv[3]) : 5;
+    int packetSize = argc > 4 ? std::atoi(argv[4]) : 10;
+    if (seconds <= 0) seconds = 30;
+    if (sampleRate <= 0) sampleRate = 200;
+    if (displaySeconds <= 0) displaySeconds = 5;
+    if (packetSize <= 0) packetSize = 10;
+    const int maxPoints = displaySeconds * sampleRate;
+
+    EcgSimulator::Config config;
+    config.sampleRate = sampleRate;
+    config.heartRate = 75.0;
+    config.seed = 1;
+    EcgSimulator simulator(config);
+    const QVector<double> samples = simulator.generate(seconds * sampleRate);
+
+    std::printf("series_bench: %d s, %d Hz, window %d s (%d points), %d samples/packet\n",
+                seconds, sampleRate, displaySeconds, maxPoints, packetSize);
+    std::printf("%-16s %9s %9s %9s %9s %9s %9s %9s %9s\n", "method",
+                "upd us", "upd p50", "upd p95", "upd max", "draw us", "draw p50", "draw p95", "draw max");
+
+    // 原实现: 每个样本 append, 超出窗口后 remove(0)
+    qint64 appendIndex = 0;
+    run("append/remove0", samples, sampleRate, displaySeconds, packetSize,
+        [&](Scene& scene, const double* values, int count) {
+            for (int k = 0; k < count; ++k) {
+                scene.series->append(static_cast<double>(appendIndex++) / sampleRate, values[k]);
+                while (scene.series->count() > maxPoints) {
+                    scene.series->remove(0);
+                }
+            }
+        });
+
+    // 环形缓冲, 每包一次 replace
+    WaveformBuffer buffer(maxPoints);
+    run("ring/replace", samples, sampleRate, displaySeconds, packetSize,
+        [&](Scene& scene, const double* values, int count) {
+            buffer.append(values, count);
+            scene.series->replace(buffer.toPoints(sampleRate));
+        });
+
+    // 环形缓冲 + 按绘图区像素列 M4 抽取
+    WaveformBuffer decimated(maxPoints);
+    run("ring/m4", samples, sampleRate, displaySeconds, packetSize,
+        [&](Scene& scene, const double* values, int count) {
+            decimated.append(values, count);
+            const int columns = qMax(1, qRound(scene.chart->plotArea().width()));
+            scene.series->replace(WaveformDecimator::decimate(decimated, sampleRate, columns));
+        });
+
+    return 0;
+}
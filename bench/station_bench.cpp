@@ -0,0 +1,117 @@
+// 中央站负载基准: N 个床位 × 采样率的实时心电按 MQTT 分包 (40ms) 到达,
+// CentralStationWidget 按渲染节拍绘制, 统计 GUI 线程每帧 paintEvent 耗时与进程 CPU 占用
+//
+// 用法: station_bench [床位数=32] [采样率=250] [秒数=10] [帧率=30] [光栅化线程数=默认]
+// 线程数为0时在 GUI 线程绘制, 可与多线程光栅化对比 GUI 线程的占用
+// 默认使用 offscreen 平台, 无需显示器; 窗口 1600x1000
+#include "centralstationwidget.h"
+#include "renderticker.h"
+#include "ecgsimulator.h"
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+namespace {
+
+constexpr int kPacketMs = 40;
+
+// 记录每次 paintEvent 的耗时
+class TimedStation : public CentralStationWidget {
+public:
+    QVector<qint64> paintNs;
+
+protected:
+    void paintEvent(QPaintEvent* event) override
+    {
+        QElapsedTimer timer;
+        timer.start();
+        CentralStationWidget::paintEvent(event);
+        paintNs.append(timer.nsecsElapsed());
+    }
+};
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    int beds = argc > 1 ? std::atoi(argv[1]) : 32;
+    int sampleRate = argc > 2 ? std::atoi(argv[2]) : 250;
+    int seconds = argc > 3 ? std::atoi(argv[3]) : 10;
+    int fps = argc > 4 ? std::atoi(argv[4]) : 30;
+    const int threads = argc > 5 ? std::atoi(argv[5]) : -1;
+    if (beds <= 0) beds = 32;
+    if (sampleRate <= 0) sampleRate = 250;
+    if (seconds <= 0) seconds = 10;
+    if (fps <= 0) fps = 30;
+
+    // 预先生成全部数据, 不把发生器开销计入
+    const int total = (seconds + 1) * sampleRate;
+    QVector<QVector<double>> data(beds);
+    for (int b = 0; b < beds; ++b) {
+        EcgSimulator::Config config;
+        config.sampleRate = sampleRate;
+        config.heartRate = 60.0 + (b * 7) % 60;
+        config.seed = b + 1;
+        EcgSimulator simulator(config);
+        data[b] = simulator.generate(total);
+    }
+
+    RenderTicker::shared()->setFrameRate(fps);
+    TimedStation station;
+    station.setSampleRate(sampleRate);
+    if (threads >= 0) station.setRenderThreads(threads);
+    for (int b = 0; b < beds; ++b) {
+        station.addBed(QStringLiteral("Bed %1").arg(b + 1, 2, 10, QLatin1Char('0')));
+        station.setVitals(b, 60 + (b * 7) % 60, 95 + b % 5, 36.5 + (b % 10) / 10.0);
+    }
+    station.resize(1600, 1000);
+    station.show();
+
+    // 按墙钟时间送入数据, 与设备实时到达一致
+    QElapsedTimer wall;
+    qint64 fed = 0;
+    QTimer feeder;
+    feeder.setTimerType(Qt::PreciseTimer);
+    QObject::connect(&feeder, &QTimer::timeout, [&]() {
+        const qint64 due = qMin<qint64>(total, wall.elapsed() * sampleRate / 1000);
+        const int count = static_cast<int>(due - fed);
+        if (count <= 0) return;
+        for (int b = 0; b < beds; ++b) {
+            station.appendEcg(b, data[b].constData() + fed, count);
+        }
+        fed = due;
+    });
+
+    QTimer::singleShot(seconds * 1000, &app, &QCoreApplication::quit);
+    const std::clock_t cpuStart = std::clock();
+    wall.start();
+    feeder.start(kPacketMs);
+    app.exec();
+    const double cpuSec = static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+    const double wallSec = wall.elapsed() / 1000.0;
+
+    QVector<qint64> ns = station.paintNs;
+    std::sort(ns.begin(), ns.end());
+    double sum = 0.0;
+    for (qint64 v : ns) sum += v;
+    const double meanMs = ns.isEmpty() ? 0.0 : sum / ns.size() / 1e6;
+    const double p95Ms = ns.isEmpty() ? 0.0 : ns[qMin(ns.size() - 1, ns.size() * 95 / 100)] / 1e6;
+    const double maxMs = ns.isEmpty() ? 0.0 : ns.last() / 1e6;
+
+    std::printf("station_bench: %d beds x %d Hz, %d fps target, %d render threads, %.1f s\n",
+                beds, sampleRate, fps, station.renderThreads(), wallSec);
+    std::printf("GUI paints %d (%.1f /s), paint mean %.2f ms, p95 %.2f ms, max %.2f ms\n",
+                static_cast<int>(ns.size()), ns.size() / wallSec, meanMs, p95Ms, maxMs);
+    std::printf("process CPU %.1f%% of one core, all threads (%.2f s CPU / %.2f s wall)\n",
+                100.0 * cpuSec / wallSec, cpuSec, wallSec);
+    return 0;
+}
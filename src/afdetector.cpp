@@ -0,0 +1,219 @@
+#include "afdetector.h"
+#include <QtMath>
+
+namespace {
+
+// 判定阈值 (参考 Dash 等的 RMSSD/TPR/ShE 联合判据)
+constexpr double kIrregularityMin = 0.10;
+constexpr double kEntropyMin = 0.55;
+
+// 随机序列转折点数: 均值 2(N-2)/3, 方差 (16N-29)/90; 取 ±3σ 作为接受区间
+// (窗口仅64搏, 比 Dash 原文的128搏短, 用1.96σ会在房颤中频繁出现假阴性)
+const double kTurningPointSigma =
+    qSqrt((16.0 * AfDetector::kWindow - 29.0) / 90.0) / (AfDetector::kWindow - 2);
+const double kTurningPointMin = 2.0 / 3.0 - 3.0 * kTurningPointSigma;
+const double kTurningPointMax = 2.0 / 3.0 + 3.0 * kTurningPointSigma;
+
+// 生理范围外的R-R视为漏检或误检, 不进入窗口
+constexpr double kMinRR = 0.25;
+constexpr double kMaxRR = 3.0;
+
+// 直方图: ln(RR / kMinRR) 等宽分箱, 每箱约4%, 与心率无关
+constexpr double kBinWidthLog = 0.04;
+
+// 浮点累加的漂移控制: 每隔若干搏从窗口重新求和
+constexpr int kResumInterval = 4096;
+
+// c·ln(c) 查表, c 为 0..kWindow
+double cLogC(int c)
+{
+    static const auto table = [] {
+        std::array<double, AfDetector::kWindow + 1> t{};
+        for (int i = 1; i <= AfDetector::kWindow; ++i) {
+            t[i] = i * qLn(static_cast<double>(i));
+        }
+        return t;
+    }();
+    return table[c];
+}
+
+} // namespace
+
+AfDetector::AfDetector(QObject* parent)
+    : QObject(parent)
+{
+}
+
+void AfDetector::reset()
+{
+    m_seq = 0;
+    m_count = 0;
+    m_sumRR = 0.0;
+    m_sumDiff2 = 0.0;
+    m_turningCount = 0;
+    m_hist.fill(0);
+    m_sumCLogC = 0.0;
+    m_lastTime = -1.0;
+    m_inAf = false;
+    m_positiveRun = 0;
+    m_negativeRun = 0;
+    m_candidateOnset = 0.0;
+    m_candidateEnd = 0.0;
+    m_episode = AfEpisode();
+}
+
+int AfDetector::binOf(double rr)
+{
+    int bin = static_cast<int>(qLn(rr / kMinRR) / kBinWidthLog);
+    return qBound(0, bin, kBins - 1);
+}
+
+void AfDetector::histogramAdd(int bin, int delta)
+{
+    int& c = m_hist[bin];
+    m_sumCLogC -= cLogC(c);
+    c += delta;
+    m_sumCLogC += cLogC(c);
+}
+
+double AfDetector::irregularity() const
+{
+    if (m_count < kWindow) return 0.0;
+    double mean = m_sumRR / m_count;
+    return mean > 0.0 ? qSqrt(qMax(0.0, m_sumDiff2) / (m_count - 1)) / mean : 0.0;
+}
+
+double AfDetector::turningPointRatio() const
+{
+    if (m_count < kWindow) return 0.0;
+    return static_cast<double>(m_turningCount) / (m_count - 2);
+}
+
+double AfDetector::entropy() const
+{
+    if (m_count < kWindow) return 0.0;
+    // H = ln(N) - Σ c·ln(c) / N, 以 ln(N) 归一化
+    double logN = qLn(static_cast<double>(m_count));
+    return qMax(0.0, (logN - m_sumCLogC / m_count) / logN);
+}
+
+bool AfDetector::windowIndicatesAf() const
+{
+    if (m_count < kWindow) return false;
+    double tpr = turningPointRatio();
+    return irregularity() > kIrregularityMin &&
+           tpr > kTurningPointMin && tpr < kTurningPointMax &&
+           entropy() > kEntropyMin;
+}
+
+// ============================================================
+// 滑动窗口增量更新
+// ============================================================
+
+void AfDetector::evictOldest()
+{
+    const Entry& oldest = m_ring[(m_seq - m_count) % kWindow];
+    m_sumRR -= oldest.rr;
+    histogramAdd(oldest.bin, -1);
+
+    // 次老元素成为窗口首元素: 其差值与转折点依赖已移出的元素, 一并移出
+    const Entry& next = m_ring[(m_seq - m_count + 1) % kWindow];
+    m_sumDiff2 -= next.diff2;
+    m_turningCount -= next.turning ? 1 : 0;
+
+    m_count--;
+}
+
+void AfDetector::addInterval(double rr, double time)
+{
+    if (m_count == kWindow) {
+        evictOldest();
+    }
+
+    Entry& cur = m_ring[m_seq % kWindow];
+    cur.rr = rr;
+    cur.time = time;
+    cur.diff2 = 0.0;
+    cur.turning = false;
+    cur.bin = binOf(rr);
+
+    if (m_count >= 1) {
+        Entry& prev = m_ring[(m_seq - 1) % kWindow];
+        double d = rr - prev.rr;
+        cur.diff2 = d * d;
+        m_sumDiff2 += cur.diff2;
+
+        // 前一元素的左右邻居都已就位, 确定它是否为转折点
+        if (m_count >= 2) {
+            const Entry& prev2 = m_ring[(m_seq - 2) % kWindow];
+            prev.turning = (prev.rr > prev2.rr && prev.rr > rr) ||
+                           (prev.rr < prev2.rr && prev.rr < rr);
+            m_turningCount += prev.turning ? 1 : 0;
+        }
+    }
+
+    m_sumRR += rr;
+    histogramAdd(cur.bin, 1);
+    m_count++;
+    m_seq++;
+
+    if (m_seq % kResumInterval == 0) {
+        recomputeSums();
+    }
+}
+
+void AfDetector::recomputeSums()
+{
+    m_sumRR = 0.0;
+    m_sumDiff2 = 0.0;
+    for (int i = 0; i < m_count; ++i) {
+        const Entry& e = m_ring[(m_seq - m_count + i) % kWindow];
+        m_sumRR += e.rr;
+        if (i > 0) m_sumDiff2 += e.diff2;
+    }
+}
+
+// ============================================================
+// 逐搏判定与发作状态机
+// ============================================================
+
+void AfDetector::addBeat(const RPeakInfo& peak)
+{
+    // 检测器被重置 (时间回退) 时同步清空
+    if (peak.timestamp <= m_lastTime) {
+        reset();
+    }
+    m_lastTime = peak.timestamp;
+
+    if (peak.rrInterval < kMinRR || peak.rrInterval > kMaxRR) {
+        return;
+    }
+    addInterval(peak.rrInterval, peak.timestamp);
+
+    // 窗口约一半为房颤时判据开始成立 (或不再成立), 起止时刻估计取窗口中点的心搏时刻;
+    // 窗口未满时从最旧的一项起算, 下标始终非负
+    double midTime = m_ring[(m_seq - m_count + m_count / 2) % kWindow].time;
+    if (windowIndicatesAf()) {
+        if (m_positiveRun == 0) m_candidateOnset = midTime;
+        m_positiveRun++;
+        m_negativeRun = 0;
+    } else {
+        if (m_negativeRun == 0) m_candidateEnd = midTime;
+        m_negativeRun++;
+        m_positiveRun = 0;
+    }
+
+    if (!m_inAf && m_positiveRun >= kOnsetBeats) {
+        m_inAf = true;
+        m_episode = AfEpisode();
+        m_episode.onsetTime = m_candidateOnset;
+        m_episode.irregularity = irregularity();
+        m_episode.turningPointRatio = turningPointRatio();
+        m_episode.entropy = entropy();
+        emit afOnsetDetected(m_episode);
+    } else if (m_inAf && m_negativeRun >= kOffsetBeats) {
+        m_inAf = false;
+        m_episode.endTime = m_candidateEnd;
+        emit afEnded(m_episode);
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <QObject>
+#include <array>
+#include "qrsdetector.h"
+
+// 房颤 (AF) 发作信息, 时间与 RPeakInfo::timestamp 同一时间基准 (秒)
+struct AfEpisode {
+    double onsetTime = 0.0;          // 估计起始时刻
+    double endTime = 0.0;            // 结束时刻, 发作中为0
+    double irregularity = 0.0;       // 归一化RMSSD (RMSSD / 平均RR)
+    double turningPointRatio = 0.0;  // 转折点比例, 随机序列期望 2/3
+    double entropy = 0.0;            // RR直方图归一化香农熵 (0-1)
+};
+
+// 流式房颤检测: 在最近 kWindow 个R-R间期的滑动窗口上计算
+// RR不规则度、转折点比例和香农熵, 三项同时满足判为房颤
+// 所有统计量随每个心搏增量更新, 固定大小数组, 单搏 O(1), 无堆分配
+class AfDetector : public QObject {
+    Q_OBJECT
+
+public:
+    explicit AfDetector(QObject* parent = nullptr);
+
+    void reset();
+
+    bool inAtrialFibrillation() const { return m_inAf; }
+    const AfEpisode& currentEpisode() const { return m_episode; }
+
+    // 当前窗口统计 (窗口未满时为0)
+    double irregularity() const;
+    double turningPointRatio() const;
+    double entropy() const;
+
+    static constexpr int kWindow = 64;        // 滑动窗口R-R数
+    static constexpr int kOnsetBeats = 8;     // 连续判为房颤的心搏数后报告发作
+    static constexpr int kOffsetBeats = 16;   // 连续判为非房颤的心搏数后报告结束
+
+public slots:
+    // 连接 QrsDetector::rPeakDetected
+    void addBeat(const RPeakInfo& peak);
+
+signals:
+    void afOnsetDetected(const AfEpisode& episode);
+    void afEnded(const AfEpisode& episode);
+
+private:
+    struct Entry {
+        double rr = 0.0;
+        double time = 0.0;      // 该R-R结束处的R波时刻
+        double diff2 = 0.0;     // 与前一R-R差值的平方
+        int bin = 0;            // 直方图区间
+        bool turning = false;   // 作为三元组中点是否为转折点
+    };
+
+    void addInterval(double rr, double time);
+    void evictOldest();
+    void histogramAdd(int bin, int delta);
+    void recomputeSums();
+    bool windowIndicatesAf() const;
+
+    static int binOf(double rr);
+
+    std::array<Entry, kWindow> m_ring;
+    qint64 m_seq = 0;     // 已加入的R-R总数, 环形位置 = seq % kWindow
+    int m_count = 0;
+
+    // 增量统计
+    double m_sumRR = 0.0;
+    double m_sumDiff2 = 0.0;
+    int m_turningCount = 0;
+
+    // 对数刻度直方图, m_sumCLogC = Σ c·ln(c)
+    static constexpr int kBins = 64;
+    std::array<int, kBins> m_hist{};
+    double m_sumCLogC = 0.0;
+
+    double m_lastTime = -1.0;
+
+    // 发作状态机
+    bool m_inAf = false;
+    int m_positiveRun = 0;
+    int m_negativeRun = 0;
+    double m_candidateOnset = 0.0;
+    double m_candidateEnd = 0.0;
+    AfEpisode m_episode;
+};
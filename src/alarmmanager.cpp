@@ -59,7 +59,16 @@ void AlarmManager::checkBloodOxygen(int spo2)
     }
 }
 
-void AlarmManager::triggerAlarm(AlarmInfo::AlarmType type, double value)
+void AlarmManager::reportAtrialFibrillation(const QDateTime& onset, double irregularity)
+{
+    QString message = QStringLiteral("%1: 疑似房颤, 起始于 %2 (RR不规则度 %3)")
+                          .arg(AlarmInfo::typeToString(AlarmInfo::AbnormalECG))
+                          .arg(onset.toString("HH:mm:ss"))
+                          .arg(irregularity, 0, 'f', 2);
+    triggerAlarm(AlarmInfo::AbnormalECG, irregularity, message);
+}
+
+void AlarmManager::triggerAlarm(AlarmInfo::AlarmType type, double value, const QString& message)
 {
     // 检查冷却时间
     if (m_lastAlarmTime.isValid() && 
@@ -78,7 +87,9 @@ void AlarmManager::triggerAlarm(AlarmInfo::AlarmType type, double value)
     alarm.type = type;
     alarm.value = value;
     alarm.timestamp = QDateTime::currentDateTime();
-    alarm.message = QString("%1: %2").arg(AlarmInfo::typeToString(type)).arg(value);
+    alarm.message = message.isEmpty()
+        ? QString("%1: %2").arg(AlarmInfo::typeToString(type)).arg(value)
+        : message;
     
     m_activeAlarms.append(alarm);
     m_lastAlarmTime = QDateTime::currentDateTime();
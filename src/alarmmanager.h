@@ -20,6 +20,8 @@ public:
     void checkTemperature(double temp);
     void checkHeartRate(int hr);
     void checkBloodOxygen(int spo2);
+    // 心律失常 (房颤) 发作, onset 为发作起始时刻, irregularity 为归一化RMSSD
+    void reportAtrialFibrillation(const QDateTime& onset, double irregularity);
     
     void setSoundEnabled(bool enabled) { m_soundEnabled = enabled; }
     bool isSoundEnabled() const { return m_soundEnabled; }
@@ -37,7 +39,7 @@ private slots:
     void onAlarmTimeout();
 
 private:
-    void triggerAlarm(AlarmInfo::AlarmType type, double value);
+    void triggerAlarm(AlarmInfo::AlarmType type, double value, const QString& message = QString());
     void playAlarmSound();
     
     DataManager* m_dataManager;
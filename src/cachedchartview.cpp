@@ -0,0 +1,148 @@
+#include "cachedchartview.h"
+#include <QtCharts/QValueAxis>
+#include <QtCharts/QDateTimeAxis>
+#include <QPainter>
+#include <QLineF>
+
+namespace {
+
+// 次网格线相对主网格线的透明度
+constexpr double kMinorGridAlpha = 0.45;
+
+} // namespace
+
+CachedChartView::CachedChartView(QWidget* parent)
+    : QChartView(parent)
+    , m_gridColor(QColor("#1a3a5c"))
+{
+    // 只重绘发生变化的图元区域; 背景由缓存图层贴出, 不随曲线更新重画
+    setViewportUpdateMode(QGraphicsView::MinimalViewportUpdate);
+}
+
+void CachedChartView::setGridColor(const QColor& color)
+{
+    if (color == m_gridColor) return;
+    m_gridColor = color;
+    viewport()->update();
+}
+
+void CachedChartView::setGridVisible(bool visible)
+{
+    if (visible == m_gridVisible) return;
+    m_gridVisible = visible;
+    viewport()->update();
+}
+
+void CachedChartView::invalidateStaticLayer()
+{
+    m_layerValid = false;
+    viewport()->update();
+}
+
+bool CachedChartView::LayerKey::operator==(const LayerKey& other) const
+{
+    return size == other.size
+        && devicePixelRatio == other.devicePixelRatio
+        && plotArea == other.plotArea
+        && background == other.background
+        && grid == other.grid
+        && gridVisible == other.gridVisible
+        && ticks == other.ticks;
+}
+
+CachedChartView::LayerKey CachedChartView::currentKey() const
+{
+    LayerKey key;
+    key.size = viewport()->size();
+    key.devicePixelRatio = devicePixelRatioF();
+    key.background = backgroundBrush().color().rgba();
+    key.grid = m_gridColor.rgba();
+    key.gridVisible = m_gridVisible;
+
+    if (QChart* c = chart()) {
+        key.plotArea = c->plotArea();
+        for (QAbstractAxis* axis : c->axes()) {
+            if (!axis->isVisible()) continue;
+            int major = 0;
+            int minor = 0;
+            if (auto* valueAxis = qobject_cast<QValueAxis*>(axis)) {
+                major = valueAxis->tickCount();
+                minor = valueAxis->minorTickCount();
+            } else if (auto* dateAxis = qobject_cast<QDateTimeAxis*>(axis)) {
+                major = dateAxis->tickCount();
+            }
+            key.ticks << static_cast<int>(axis->orientation()) << major << minor;
+        }
+    }
+    return key;
+}
+
+void CachedChartView::renderStaticLayer(const LayerKey& key)
+{
+    m_layerKey = key;
+    m_layerValid = true;
+
+    const QSize pixels = key.size * key.devicePixelRatio;
+    if (pixels.isEmpty()) {
+        m_staticLayer = QPixmap();
+        return;
+    }
+
+    QPixmap layer(pixels);
+    layer.setDevicePixelRatio(key.devicePixelRatio);
+    layer.fill(QColor::fromRgba(key.background));
+
+    // 绘图区尚未布局时只有背景, 布局完成后绘图区变化会触发重建
+    const QRectF plot = key.plotArea.translated(-mapToScene(QPoint(0, 0)));
+    if (key.gridVisible && plot.isValid()) {
+        QVector<QLineF> majorLines;
+        QVector<QLineF> minorLines;
+        for (int i = 0; i + 2 < key.ticks.size(); i += 3) {
+            const bool horizontal = key.ticks[i] == Qt::Horizontal;
+            const int major = key.ticks[i + 1];
+            const int minor = key.ticks[i + 2];
+            if (major < 2) continue;
+
+            // 主刻度等分绘图区, 次刻度再等分相邻主刻度; 横轴的网格为竖线
+            const int steps = (major - 1) * (minor + 1);
+            for (int k = 0; k <= steps; ++k) {
+                const double f = static_cast<double>(k) / steps;
+                const QLineF line = horizontal
+                    ? QLineF(plot.left() + f * plot.width(), plot.top(),
+                             plot.left() + f * plot.width(), plot.bottom())
+                    : QLineF(plot.left(), plot.bottom() - f * plot.height(),
+                             plot.right(), plot.bottom() - f * plot.height());
+                (k % (minor + 1) == 0 ? majorLines : minorLines).append(line);
+            }
+        }
+
+        QPainter painter(&layer);
+        QColor minorColor = QColor::fromRgba(key.grid);
+        minorColor.setAlphaF(kMinorGridAlpha);
+        painter.setPen(QPen(minorColor, 0));
+        painter.drawLines(minorLines);
+        painter.setPen(QPen(QColor::fromRgba(key.grid), 0));
+        painter.drawLines(majorLines);
+    }
+
+    m_staticLayer = layer;
+}
+
+void CachedChartView::drawBackground(QPainter* painter, const QRectF& rect)
+{
+    const LayerKey key = currentKey();
+    if (!m_layerValid || !(key == m_layerKey)) {
+        renderStaticLayer(key);
+    }
+    if (m_staticLayer.isNull()) {
+        QChartView::drawBackground(painter, rect);
+        return;
+    }
+
+    // 场景坐标与视口坐标只差一个平移; 只贴出需要刷新的区域
+    const qreal dpr = m_staticLayer.devicePixelRatio();
+    const QPointF origin = mapToScene(QPoint(0, 0));
+    const QRectF source((rect.x() - origin.x()) * dpr, (rect.y() - origin.y()) * dpr,
+                        rect.width() * dpr, rect.height() * dpr);
+    painter->drawPixmap(rect, m_staticLayer, source);
+}
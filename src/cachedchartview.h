@@ -0,0 +1,52 @@
+#pragma once
+#include <QtCharts/QChartView>
+#include <QPixmap>
+#include <QColor>
+#include <QVector>
+
+// 静态图层缓存的图表视图: 背景与网格不再作为场景图元逐次重绘, 而是预先画进一张按设备像素比
+// 缓存的 QPixmap, 在 drawBackground 中只贴出需要刷新的区域
+//
+// 使用方隐藏图表自身的背景 (QChart::setBackgroundVisible(false)) 与坐标轴网格线, 网格按各坐标轴
+// 的刻度数等分绘图区 (QValueAxis 的固定刻度、QDateTimeAxis)。视口尺寸、设备像素比、绘图区、
+// 背景色、网格色或刻度数变化时自动重绘图层; 曲线与标记仍是场景图元, 按最小区域更新叠加在上面
+class CachedChartView : public QChartView {
+    Q_OBJECT
+
+public:
+    explicit CachedChartView(QWidget* parent = nullptr);
+
+    void setGridColor(const QColor& color);
+    QColor gridColor() const { return m_gridColor; }
+    void setGridVisible(bool visible);
+    bool isGridVisible() const { return m_gridVisible; }
+
+    // 强制下次绘制时重建图层 (上述自动检测之外的外观变化)
+    void invalidateStaticLayer();
+
+protected:
+    void drawBackground(QPainter* painter, const QRectF& rect) override;
+
+private:
+    // 决定图层内容的全部参数, 任一变化即重建
+    struct LayerKey {
+        QSize size;
+        qreal devicePixelRatio = 0.0;
+        QRectF plotArea;
+        QRgb background = 0;
+        QRgb grid = 0;
+        bool gridVisible = true;
+        QVector<int> ticks;     // 每个坐标轴: 方向, 主刻度数, 次刻度数
+
+        bool operator==(const LayerKey& other) const;
+    };
+
+    LayerKey currentKey() const;
+    void renderStaticLayer(const LayerKey& key);
+
+    QColor m_gridColor;
+    bool m_gridVisible = true;
+    QPixmap m_staticLayer;
+    LayerKey m_layerKey;
+    bool m_layerValid = false;
+};
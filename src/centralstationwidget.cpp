@@ -0,0 +1,390 @@
+#include "centralstationwidget.h"
+#include "renderticker.h"
+#include "waveformdecimator.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <QFontDatabase>
+#include <QtMath>
+#include <QThread>
+
+namespace {
+
+constexpr int kTileGap = 4;
+constexpr int kHeaderHeight = 20;
+constexpr double kVitalsPanelRatio = 0.28;  // 右侧数值区占床位宽度的比例
+constexpr double kMinVerticalSpan = 200.0;  // 纵向至少显示 ±100mV, 避免基线噪声被放大
+
+// 床位内的区域: 标题栏之下为床位主体, 主体左侧为波形区, 右侧为数值区
+QRect tileBody(const QRect& rect)
+{
+    return QRect(rect.left() + 1, rect.top() + kHeaderHeight + 1, rect.width() - 2, rect.height() - kHeaderHeight - 2);
+}
+
+int vitalsPanelWidth(const QRect& body)
+{
+    return qRound(body.width() * kVitalsPanelRatio);
+}
+
+QRectF waveformRect(const QRect& body)
+{
+    return QRectF(body.left() + 4, body.top() + 4, body.width() - vitalsPanelWidth(body) - 8, body.height() - 8);
+}
+
+const QColor kBackgroundColor("#0a1628");
+const QColor kTileColor("#16213e");
+const QColor kBorderColor("#2a4a6a");
+const QColor kAlarmColor("#e74c3c");
+const QColor kEcgColor("#00ff88");
+const QColor kHrColor("#4ecdc4");
+const QColor kSpo2Color("#45b7d1");
+const QColor kTempColor("#ff6b6b");
+const QColor kLabelColor("#8892b0");
+
+} // namespace
+
+CentralStationWidget::CentralStationWidget(QWidget* parent)
+    : QWidget(parent)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent);
+
+    m_nameFont = font();
+    m_nameFont.setBold(true);
+    m_valueFont = font();
+    m_valueFont.setBold(true);
+    m_valueFont.setPixelSize(22);
+    m_labelFont = font();
+    m_labelFont.setPixelSize(10);
+
+    // 留一个核给 GUI 线程
+    setRenderThreads(qMax(1, QThread::idealThreadCount() - 1));
+
+    RenderTicker* ticker = RenderTicker::shared();
+    connect(ticker, &RenderTicker::tick, this, &CentralStationWidget::onRenderTick);
+    ticker->addClient(this);
+}
+
+CentralStationWidget::~CentralStationWidget()
+{
+    // 工作线程完成后才能析构: 任务会向本对象投递结果
+    m_pool.waitForDone();
+}
+
+int CentralStationWidget::addBed(const QString& name)
+{
+    Bed bed;
+    bed.name = name;
+    bed.ecg.setCapacity(m_displayDuration * m_sampleRate);
+    m_beds.append(bed);
+    m_dirty.append(true);
+    m_tiles.append(QImage());
+    // 床位数变化后网格重排
+    markAllDirty();
+    return m_beds.size() - 1;
+}
+
+void CentralStationWidget::clearBeds()
+{
+    m_beds.clear();
+    m_dirty.clear();
+    m_tiles.clear();
+    ++m_generation;
+    update();
+}
+
+void CentralStationWidget::setSampleRate(int sampleRate)
+{
+    m_sampleRate = qMax(1, sampleRate);
+    for (Bed& bed : m_beds) {
+        bed.ecg.setCapacity(m_displayDuration * m_sampleRate);
+        bed.ecg.clear();
+        bed.ecgColumns.reset();
+    }
+    markAllDirty();
+}
+
+void CentralStationWidget::setDisplayDuration(int seconds)
+{
+    m_displayDuration = qMax(1, seconds);
+    for (Bed& bed : m_beds) {
+        bed.ecg.setCapacity(m_displayDuration * m_sampleRate);
+        bed.ecgColumns.reset();
+    }
+    markAllDirty();
+}
+
+void CentralStationWidget::setColumns(int columns)
+{
+    m_columns = qMax(0, columns);
+    markAllDirty();
+}
+
+void CentralStationWidget::setRenderThreads(int threads)
+{
+    // 工作线程画床位要排版文字 (床号、数值); 平台字体引擎不支持多线程时只能在 GUI 线程绘制
+    m_threaded = threads > 0 && QFontDatabase::supportsThreadedFontRendering();
+    if (m_threaded) {
+        m_pool.setMaxThreadCount(threads);
+    }
+    markAllDirty();
+}
+
+void CentralStationWidget::appendEcg(int bed, const double* values, int count)
+{
+    if (bed < 0 || bed >= m_beds.size() || count <= 0) return;
+    m_beds[bed].ecg.append(values, count);
+    m_dirty[bed] = true;
+}
+
+void CentralStationWidget::appendEcg(int bed, const QVector<double>& values)
+{
+    appendEcg(bed, values.constData(), values.size());
+}
+
+void CentralStationWidget::setVitals(int bed, int heartRate, int spo2, double temperature)
+{
+    if (bed < 0 || bed >= m_beds.size()) return;
+    Bed& b = m_beds[bed];
+    b.heartRate = heartRate;
+    b.spo2 = spo2;
+    b.temperature = temperature;
+    m_dirty[bed] = true;
+}
+
+void CentralStationWidget::setAlarm(int bed, bool active)
+{
+    if (bed < 0 || bed >= m_beds.size() || m_beds[bed].alarm == active) return;
+    m_beds[bed].alarm = active;
+    m_dirty[bed] = true;
+}
+
+void CentralStationWidget::markAllDirty()
+{
+    // 已提交的光栅化结果尺寸或内容过期
+    ++m_generation;
+    m_dirty.fill(true);
+    update();
+}
+
+// ============================================================
+// 布局
+// ============================================================
+
+int CentralStationWidget::columnCount() const
+{
+    if (m_columns > 0) return m_columns;
+    // 自动: 接近正方形的网格, 床位较宽 (波形横向展开)
+    return qMax(1, qCeil(qSqrt(m_beds.size())));
+}
+
+QRect CentralStationWidget::tileRect(int bed) const
+{
+    const int columns = columnCount();
+    const int rows = qMax(1, (static_cast<int>(m_beds.size()) + columns - 1) / columns);
+    const int w = (width() - kTileGap) / columns;
+    const int h = (height() - kTileGap) / rows;
+    const int row = bed / columns;
+    const int col = bed % columns;
+    return QRect(kTileGap + col * w, kTileGap + row * h, w - kTileGap, h - kTileGap);
+}
+
+CentralStationWidget::Style CentralStationWidget::currentStyle() const
+{
+    Style style;
+    style.nameFont = m_nameFont;
+    style.valueFont = m_valueFont;
+    style.labelFont = m_labelFont;
+    style.sampleRate = m_sampleRate;
+    style.displayDuration = m_displayDuration;
+    style.devicePixelRatio = devicePixelRatioF();
+    return style;
+}
+
+void CentralStationWidget::resizeEvent(QResizeEvent* event)
+{
+    QWidget::resizeEvent(event);
+    markAllDirty();
+}
+
+// ============================================================
+// 调度
+// ============================================================
+
+void CentralStationWidget::onRenderTick()
+{
+    if (!isVisible() || window()->isMinimized()) return;
+
+    if (m_threaded) {
+        rasterizeDirtyTiles();
+        return;
+    }
+
+    // 单线程: 只对可见区域内的新数据床位申请重绘, Qt 合并为一次 paintEvent;
+    // 滚出可视区域的床位保留标记, 滚回时补绘
+    const QRegion visible = visibleRegion();
+    for (int i = 0; i < m_beds.size(); ++i) {
+        if (!m_dirty[i]) continue;
+        const QRect rect = tileRect(i);
+        if (!visible.intersects(rect)) continue;
+        m_dirty[i] = false;
+        update(rect);
+    }
+}
+
+void CentralStationWidget::rasterizeDirtyTiles()
+{
+    // 上一帧还有床位在光栅化: 本节拍跳过, 新数据留到下一节拍一起画
+    if (m_pendingTiles > 0) return;
+
+    const QRegion visible = visibleRegion();
+    const Style style = currentStyle();
+    const quint64 generation = m_generation;
+    for (int i = 0; i < m_beds.size(); ++i) {
+        if (!m_dirty[i]) continue;
+        const QRect rect = tileRect(i);
+        if (!visible.intersects(rect) || rect.isEmpty()) continue;
+        m_dirty[i] = false;
+        ++m_pendingTiles;
+
+        // 快照只含抽取后的波形, 按值捕获, 工作线程与后续数据追加互不影响
+        m_pool.start([this, i, generation, size = rect.size(),
+                      tile = tileContent(m_beds[i], rect, style), style]() {
+            const QImage image = rasterizeTile(size, tile, style);
+            QMetaObject::invokeMethod(this, [this, i, generation, image]() {
+                onTileRendered(i, generation, image);
+            }, Qt::QueuedConnection);
+        });
+    }
+}
+
+void CentralStationWidget::onTileRendered(int bed, quint64 generation, const QImage& image)
+{
+    --m_pendingTiles;
+    if (generation != m_generation || bed >= m_tiles.size()) return;
+    m_tiles[bed] = image;
+    update(tileRect(bed));
+}
+
+void CentralStationWidget::paintEvent(QPaintEvent* event)
+{
+    QPainter painter(this);
+    const QRegion& region = event->region();
+    painter.fillRect(event->rect(), kBackgroundColor);
+
+    const Style style = currentStyle();
+    for (int i = 0; i < m_beds.size(); ++i) {
+        const QRect rect = tileRect(i);
+        if (!region.intersects(rect)) continue;
+
+        if (!m_threaded) {
+            paintTile(painter, rect, tileContent(m_beds[i], rect, style), style);
+            // 与节拍无关的重绘 (展开、遮挡) 也算作已绘制
+            m_dirty[i] = false;
+            continue;
+        }
+
+        // 多线程: GUI 线程只贴图; 尺寸不符 (刚改变布局) 时先画空白床位, 等下一节拍的结果
+        const QImage& tile = m_tiles[i];
+        if (tile.size() == rect.size() * style.devicePixelRatio) {
+            painter.drawImage(rect.topLeft(), tile);
+        } else {
+            painter.fillRect(rect, kTileColor);
+            m_dirty[i] = true;
+        }
+    }
+}
+
+CentralStationWidget::TileContent CentralStationWidget::tileContent(Bed& bed, const QRect& rect, const Style& style)
+{
+    TileContent tile;
+    tile.name = bed.name;
+    tile.heartRate = bed.heartRate;
+    tile.spo2 = bed.spo2;
+    tile.temperature = bed.temperature;
+    tile.alarm = bed.alarm;
+    if (bed.ecg.size() < 2) return tile;
+
+    // 每个床位只有几百像素宽, 按像素列抽取后点数与床位数 × 宽度成正比, 与采样率无关
+    const int columns = qMax(1, qRound(waveformRect(tileBody(rect)).width() * style.devicePixelRatio));
+    tile.ecg = bed.ecgColumns.update(bed.ecg, style.sampleRate, columns);
+    // 纵向按窗口极值自动缩放 (单调队列, O(1))
+    tile.ecgMin = bed.ecg.minimum();
+    tile.ecgMax = bed.ecg.maximum();
+    tile.windowStart = static_cast<double>(bed.ecg.nextIndex() - bed.ecg.capacity()) / style.sampleRate;
+    return tile;
+}
+
+// ============================================================
+// 绘制 (任意线程)
+// ============================================================
+
+QImage CentralStationWidget::rasterizeTile(const QSize& size, const TileContent& tile, const Style& style)
+{
+    QImage image(size * style.devicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(style.devicePixelRatio);
+    QPainter painter(&image);
+    paintTile(painter, QRect(QPoint(0, 0), size), tile, style);
+    painter.end();
+    return image;
+}
+
+void CentralStationWidget::paintTile(QPainter& painter, const QRect& rect, const TileContent& tile, const Style& style)
+{
+    painter.fillRect(rect, kTileColor);
+    painter.setPen(tile.alarm ? kAlarmColor : kBorderColor);
+    painter.drawRect(rect.adjusted(0, 0, -1, -1));
+
+    // 标题栏: 床号, 报警时整条变红
+    const QRect header(rect.left() + 1, rect.top() + 1, rect.width() - 2, kHeaderHeight);
+    if (tile.alarm) painter.fillRect(header, kAlarmColor);
+    painter.setFont(style.nameFont);
+    painter.setPen(Qt::white);
+    painter.drawText(header.adjusted(6, 0, -6, 0), Qt::AlignLeft | Qt::AlignVCenter, tile.name);
+
+    const QRect body = tileBody(rect);
+    const int panelWidth = vitalsPanelWidth(body);
+    paintWaveform(painter, waveformRect(body), tile, style);
+
+    // 右侧数值区: 心率 / 血氧 / 体温 三行
+    const QRect panel(body.right() - panelWidth + 1, body.top(), panelWidth, body.height());
+    const int lineHeight = panel.height() / 3;
+    auto drawValue = [&](int line, const QString& label, const QString& value, const QColor& color) {
+        const QRect cell(panel.left(), panel.top() + line * lineHeight, panel.width() - 6, lineHeight);
+        painter.setFont(style.labelFont);
+        painter.setPen(kLabelColor);
+        painter.drawText(cell, Qt::AlignLeft | Qt::AlignTop, label);
+        painter.setFont(style.valueFont);
+        painter.setPen(color);
+        painter.drawText(cell, Qt::AlignRight | Qt::AlignVCenter, value);
+    };
+    drawValue(0, QStringLiteral("HR"), tile.heartRate > 0 ? QString::number(tile.heartRate) : QStringLiteral("--"), kHrColor);
+    drawValue(1, QStringLiteral("SpO2"), tile.spo2 > 0 ? QString::number(tile.spo2) : QStringLiteral("--"), kSpo2Color);
+    drawValue(2, QStringLiteral("Temp"), tile.temperature > 0 ? QString::number(tile.temperature, 'f', 1) : QStringLiteral("--.-"), kTempColor);
+}
+
+void CentralStationWidget::paintWaveform(QPainter& painter, const QRectF& rect, const TileContent& tile, const Style& style)
+{
+    const QList<QPointF>& points = tile.ecg;
+    if (points.size() < 2 || rect.width() <= 0 || rect.height() <= 0) return;
+
+    double minY = tile.ecgMin;
+    double maxY = tile.ecgMax;
+    if (maxY - minY < kMinVerticalSpan) {
+        const double mid = 0.5 * (minY + maxY);
+        minY = mid - 0.5 * kMinVerticalSpan;
+        maxY = mid + 0.5 * kMinVerticalSpan;
+    }
+
+    // 新数据从右端进入, 窗口未满时左侧留空
+    const double xScale = rect.width() / style.displayDuration;
+    const double yScale = rect.height() / (maxY - minY);
+    QPolygonF polyline(points.size());
+    for (int i = 0; i < points.size(); ++i) {
+        polyline[i] = QPointF(rect.left() + (points[i].x() - tile.windowStart) * xScale,
+                              rect.bottom() - (points[i].y() - minY) * yScale);
+    }
+
+    // 数十个床位同屏时不做抗锯齿, 线宽1像素
+    painter.setRenderHint(QPainter::Antialiasing, false);
+    painter.setPen(QPen(kEcgColor, 1));
+    painter.drawPolyline(polyline);
+}
@@ -0,0 +1,124 @@
+#pragma once
+#include <QWidget>
+#include <QVector>
+#include <QImage>
+#include <QFont>
+#include <QThreadPool>
+#include "waveformbuffer.h"
+#include "waveformdecimator.h"
+
+// 中央监护站: 多床位波形墙 (16-64 个床位)
+//
+// 每个床位只是一块绘制区域 (床号、心电波形、心率/血氧/体温), 不创建 QChart、坐标轴或定时器;
+// 全部床位由 RenderTicker 驱动, 每个节拍只处理有新数据且可见的床位。窗口隐藏或最小化、
+// 床位滚出可视区域时不绘制
+//
+// 多线程光栅化 (默认): 节拍时把待绘床位按像素列抽取后的波形和数值拷贝成快照, 交给线程池
+// 在工作线程上用 QPainter 画进各自的 QImage, 完成后回到 GUI 线程只做贴图。上一帧的床位
+// 未全部完成时跳过本节拍, 任务不会堆积。关闭后, 或平台不支持多线程字体渲染时, 在 GUI 线程的 paintEvent 中直接绘制
+class CentralStationWidget : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit CentralStationWidget(QWidget* parent = nullptr);
+    ~CentralStationWidget();
+
+    // 床位管理, 返回床位序号
+    int addBed(const QString& name);
+    void clearBeds();
+    int bedCount() const { return m_beds.size(); }
+
+    // 所有床位共用的心电采样率与显示时长
+    void setSampleRate(int sampleRate);
+    int sampleRate() const { return m_sampleRate; }
+    void setDisplayDuration(int seconds);
+    int displayDuration() const { return m_displayDuration; }
+
+    // 网格列数, 0 为按床位数自动排列
+    void setColumns(int columns);
+
+    // 光栅化线程数, 0 为在 GUI 线程绘制; 平台不支持在工作线程中绘制文字时总是在 GUI 线程绘制
+    void setRenderThreads(int threads);
+    int renderThreads() const { return m_threaded ? m_pool.maxThreadCount() : 0; }
+
+    void appendEcg(int bed, const double* values, int count);
+    void appendEcg(int bed, const QVector<double>& values);
+    // 数值为0表示无数据, 显示 "--"
+    void setVitals(int bed, int heartRate, int spo2, double temperature);
+    void setAlarm(int bed, bool active);
+
+    QSize sizeHint() const override { return QSize(1280, 800); }
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+
+private slots:
+    void onRenderTick();
+
+private:
+    // 床位数据 (仅 GUI 线程访问)
+    struct Bed {
+        QString name;
+        WaveformBuffer ecg;
+        WaveformDecimator::ColumnCache ecgColumns;  // 逐帧增量抽取
+        int heartRate = 0;
+        int spo2 = 0;
+        double temperature = 0.0;
+        bool alarm = false;
+    };
+
+    // 一个床位的绘制快照: 波形已按像素列抽取, 不与 WaveformBuffer 共享数据,
+    // 拷贝给工作线程后 GUI 线程继续追加数据不会触发整段复制
+    struct TileContent {
+        QString name;
+        QList<QPointF> ecg;         // 抽取后的波形点 (秒, 原始值)
+        double ecgMin = 0.0;
+        double ecgMax = 0.0;
+        double windowStart = 0.0;   // 波形窗口左端 (秒)
+        int heartRate = 0;
+        int spo2 = 0;
+        double temperature = 0.0;
+        bool alarm = false;
+    };
+
+    // 绘制参数 (只读, 工作线程按值持有)
+    struct Style {
+        QFont nameFont;
+        QFont valueFont;
+        QFont labelFont;
+        int sampleRate = 250;
+        int displayDuration = 5;
+        qreal devicePixelRatio = 1.0;
+    };
+
+    int columnCount() const;
+    QRect tileRect(int bed) const;
+    Style currentStyle() const;
+    void markAllDirty();
+    void rasterizeDirtyTiles();
+    void onTileRendered(int bed, quint64 generation, const QImage& image);
+    // 按床位尺寸生成绘制快照 (GUI 线程), 代价与新样本数加床位宽度成正比
+    static TileContent tileContent(Bed& bed, const QRect& rect, const Style& style);
+
+    // 可在任意线程调用: 只读取参数, 不访问控件
+    static void paintTile(QPainter& painter, const QRect& rect, const TileContent& tile, const Style& style);
+    static void paintWaveform(QPainter& painter, const QRectF& rect, const TileContent& tile, const Style& style);
+    static QImage rasterizeTile(const QSize& size, const TileContent& tile, const Style& style);
+
+    QVector<Bed> m_beds;
+    QVector<bool> m_dirty;      // 上次绘制后有新数据
+    QVector<QImage> m_tiles;    // 多线程模式: 各床位最近一次光栅化结果
+    int m_sampleRate = 250;
+    int m_displayDuration = 5;  // seconds
+    int m_columns = 0;
+
+    QFont m_nameFont;
+    QFont m_valueFont;
+    QFont m_labelFont;
+
+    bool m_threaded = true;
+    QThreadPool m_pool;
+    int m_pendingTiles = 0;     // 已提交未返回的床位数 (仅 GUI 线程访问)
+    quint64 m_generation = 0;   // 布局或床位变化时递增, 过期的光栅化结果丢弃
+};
@@ -10,10 +10,27 @@
 #include <QDebug>
 #include <QFileInfo>
 #include <QDataStream>
+#include <QTimer>
+#include <cmath>
+
+namespace {
+
+// 心电摘要金字塔最细一级的桶宽与分级、样本排布方式的版本 (记在 PRAGMA user_version)
+constexpr qint64 kEcgPyramidBaseMs = 64;
+constexpr int kEcgPyramidVersion = 2;
+
+// 后台重建每批读取的行数与批间隔: 每批只占事件循环几毫秒
+constexpr int kRebuildBatchRows = 128;
+constexpr int kRebuildIntervalMs = 5;
+
+} // namespace
 
 DataManager::DataManager(QObject* parent)
     : QObject(parent)
+    , m_rebuildTimer(new QTimer(this))
 {
+    m_rebuildTimer->setInterval(kRebuildIntervalMs);
+    connect(m_rebuildTimer, &QTimer::timeout, this, &DataManager::rebuildEcgPyramidBatch);
 }
 
 DataManager::~DataManager()
@@ -39,12 +56,22 @@ bool DataManager::initialize(const QString& dbPath)
         return false;
     }
     
-    return createTables();
+    return createTables() && startEcgPyramidRebuild();
+}
+
+void DataManager::setEcgSampleRate(int sampleRate)
+{
+    flushEcgPyramid();
+    m_ecgSampleRate = qMax(1, sampleRate);
+    m_pyramid.clock = EcgSampleClock(m_ecgSampleRate);
 }
 
 void DataManager::close()
 {
+    // 未完成的重建不记版本, 下次打开时从头重建
+    m_rebuildTimer->stop();
     if (m_db.isOpen()) {
+        flushEcgPyramid();
         m_db.close();
     }
 }
@@ -88,6 +115,23 @@ bool DataManager::createTables()
         return false;
     }
     
+    // 心电摘要金字塔表
+    QString createPyramid = R"(
+        CREATE TABLE IF NOT EXISTS ecg_pyramid (
+            level INTEGER,
+            bucket INTEGER,
+            min REAL,
+            max REAL,
+            count INTEGER,
+            PRIMARY KEY (level, bucket)
+        )
+    )";
+    
+    if (!query.exec(createPyramid)) {
+        emit error(QStringLiteral("创建ecg_pyramid表失败: %1").arg(query.lastError().text()));
+        return false;
+    }
+    
     // 创建索引
     query.exec("CREATE INDEX IF NOT EXISTS idx_vital_timestamp ON vital_data(timestamp)");
     query.exec("CREATE INDEX IF NOT EXISTS idx_alarm_timestamp ON alarms(timestamp)");
@@ -154,7 +198,191 @@ bool DataManager::saveEcgData(const QVector<double>& ecgData, const QDateTime& t
     VitalData data;
     data.timestamp = timestamp;
     data.ecgData = ecgData;
-    return saveVitalData(data);
+    if (!saveVitalData(data)) {
+        return false;
+    }
+    
+    accumulateEcgPyramid(timestamp, ecgData);
+    return true;
+}
+
+qint64 DataManager::ecgPyramidBucketMs(int level)
+{
+    return kEcgPyramidBaseMs << (4 * qBound(0, level, kEcgPyramidLevels - 1));
+}
+
+bool DataManager::startEcgPyramidRebuild()
+{
+    QSqlQuery query(m_db);
+    if (!query.exec("PRAGMA user_version") || !query.next()) {
+        return false;
+    }
+    if (query.value(0).toInt() >= kEcgPyramidVersion) {
+        return true;
+    }
+    
+    // 旧数据库没有金字塔或分级不同: 清空后按存储顺序重放开始前已存储的心电。
+    // 重放与实时写入都以累加方式更新桶, 两者交替进行互不影响
+    if (!query.exec("DELETE FROM ecg_pyramid")
+        || !query.exec("SELECT COALESCE(MAX(id), 0) FROM vital_data") || !query.next()) {
+        emit error(QStringLiteral("重建心电摘要失败: %1").arg(query.lastError().text()));
+        return false;
+    }
+    m_rebuildMaxId = query.value(0).toLongLong();
+    m_rebuildCursor = VitalPageCursor();
+    m_rebuild = PyramidBuilder();
+    m_rebuild.clock = EcgSampleClock(m_ecgSampleRate);
+    m_rebuildTimer->start();
+    return true;
+}
+
+void DataManager::rebuildEcgPyramidBatch()
+{
+    QSqlQuery rows(m_db);
+    rows.setForwardOnly(true);
+    rows.prepare(R"(
+        SELECT id, timestamp, ecg_data
+        FROM vital_data
+        WHERE timestamp >= :afterTs
+          AND (timestamp > :afterTs OR id > :afterId)
+          AND id <= :maxId AND length(ecg_data) > 0
+        ORDER BY timestamp ASC, id ASC
+        LIMIT :limit
+    )");
+    rows.bindValue(":afterTs", m_rebuildCursor.timestamp);
+    rows.bindValue(":afterId", m_rebuildCursor.id);
+    rows.bindValue(":maxId", m_rebuildMaxId);
+    rows.bindValue(":limit", kRebuildBatchRows);
+    
+    if (!rows.exec()) {
+        m_rebuildTimer->stop();
+        emit error(QStringLiteral("重建心电摘要失败: %1").arg(rows.lastError().text()));
+        return;
+    }
+    int count = 0;
+    while (rows.next()) {
+        m_rebuildCursor.id = rows.value(0).toLongLong();
+        m_rebuildCursor.timestamp = rows.value(1).toString();
+        QByteArray ecgBytes = rows.value(2).toByteArray();
+        QDataStream stream(&ecgBytes, QIODevice::ReadOnly);
+        QVector<double> ecgData;
+        stream >> ecgData;
+        
+        const qint64 second = QDateTime::fromString(m_rebuildCursor.timestamp, Qt::ISODate)
+                                  .toSecsSinceEpoch();
+        appendEcgPyramidSamples(m_rebuild, second * 1000, ecgData);
+        ++count;
+    }
+    
+    // 本批最后一秒可能延续到下一批: 两批按桶累加, 样本排布由 m_rebuild.clock 接续
+    const bool done = count < kRebuildBatchRows;
+    QSqlQuery query(m_db);
+    m_db.transaction();
+    bool ok = writeEcgPyramid(m_rebuild.pending);
+    if (ok && done) {
+        ok = query.exec(QString("PRAGMA user_version = %1").arg(kEcgPyramidVersion));
+    }
+    if (!ok) {
+        m_db.rollback();
+        m_rebuildTimer->stop();
+        emit error(QStringLiteral("重建心电摘要失败: %1").arg(query.lastError().text()));
+        return;
+    }
+    m_db.commit();
+    
+    if (done) {
+        m_rebuildTimer->stop();
+        emit ecgPyramidRebuilt();
+    }
+}
+
+void DataManager::accumulateEcgPyramid(const QDateTime& timestamp, const QVector<double>& ecgData)
+{
+    if (ecgData.isEmpty()) return;
+    
+    // 数据库时间戳精确到秒, 同一秒内的多次上报先在内存中合并, 每秒只写一次
+    const qint64 second = timestamp.toSecsSinceEpoch();
+    if (second != m_pyramidSecond) {
+        flushEcgPyramid();
+        m_pyramidSecond = second;
+    }
+    appendEcgPyramidSamples(m_pyramid, second * 1000, ecgData);
+}
+
+void DataManager::appendEcgPyramidSamples(PyramidBuilder& builder, qint64 timeMs,
+                                          const QVector<double>& ecgData)
+{
+    // 样本时刻与全览读取原始样本共用同一排布 (EcgSampleClock)
+    const double period = builder.clock.periodMs();
+    double t = builder.clock.place(timeMs, ecgData.size());
+    
+    for (double value : ecgData) {
+        const qint64 index = static_cast<qint64>(std::floor(t / kEcgPyramidBaseMs));
+        if (builder.pending.isEmpty() || builder.pending.last().index != index) {
+            PyramidBucket bucket;
+            bucket.index = index;
+            bucket.min = value;
+            bucket.max = value;
+            builder.pending.append(bucket);
+        }
+        PyramidBucket& bucket = builder.pending.last();
+        bucket.min = qMin(bucket.min, value);
+        bucket.max = qMax(bucket.max, value);
+        bucket.count++;
+        t += period;
+    }
+}
+
+void DataManager::flushEcgPyramid()
+{
+    if (m_pyramid.pending.isEmpty()) return;
+    
+    m_db.transaction();
+    writeEcgPyramid(m_pyramid.pending);
+    m_db.commit();
+}
+
+bool DataManager::writeEcgPyramid(QVector<PyramidBucket>& pending)
+{
+    QSqlQuery query(m_db);
+    query.prepare(R"(
+        INSERT INTO ecg_pyramid (level, bucket, min, max, count)
+        VALUES (:level, :bucket, :min, :max, :count)
+        ON CONFLICT(level, bucket) DO UPDATE SET
+            min = MIN(min, excluded.min),
+            max = MAX(max, excluded.max),
+            count = count + excluded.count
+    )");
+    
+    // 最细一级的桶按时间递增, 逐级把落入同一个粗桶的相邻项合并后写入
+    bool ok = true;
+    for (int level = 0; ok && level < kEcgPyramidLevels; ++level) {
+        const int shift = 4 * level;
+        for (int i = 0; ok && i < pending.size();) {
+            const qint64 bucket = pending[i].index >> shift;
+            double lo = pending[i].min;
+            double hi = pending[i].max;
+            int count = 0;
+            for (; i < pending.size() && (pending[i].index >> shift) == bucket; ++i) {
+                lo = qMin(lo, pending[i].min);
+                hi = qMax(hi, pending[i].max);
+                count += pending[i].count;
+            }
+            
+            query.bindValue(":level", level);
+            query.bindValue(":bucket", bucket);
+            query.bindValue(":min", lo);
+            query.bindValue(":max", hi);
+            query.bindValue(":count", count);
+            if (!query.exec()) {
+                emit error(QStringLiteral("更新心电摘要失败: %1").arg(query.lastError().text()));
+                ok = false;
+            }
+        }
+    }
+    
+    pending.clear();
+    return ok;
 }
 
 QVector<VitalData> DataManager::getVitalDataRange(const QDateTime& start, const QDateTime& end)
@@ -194,6 +422,209 @@ QVector<VitalData> DataManager::getVitalDataRange(const QDateTime& start, const
     return results;
 }
 
+VitalColumns DataManager::getVitalColumns(const QDateTime& start, const QDateTime& end,
+                                          VitalPageCursor* cursor, int limit)
+{
+    VitalColumns columns;
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    
+    // 键集分页: 从上一页最后一行的时间戳起沿时间戳索引读取, 同一时间戳内按 id 接续,
+    // 每页的开销与翻过的页数无关。心电只取 blob 长度: QDataStream 序列化为 4 字节点数 + 每点 8 字节
+    query.prepare(R"(
+        SELECT id, timestamp, temperature, heart_rate, blood_oxygen, length(ecg_data)
+        FROM vital_data
+        WHERE timestamp BETWEEN :from AND :end
+          AND (timestamp > :afterTs OR id > :afterId)
+        ORDER BY timestamp ASC, id ASC
+        LIMIT :limit
+    )");
+    
+    const QString startText = start.toString(Qt::ISODate);
+    query.bindValue(":from", qMax(startText, cursor->timestamp));
+    query.bindValue(":end", end.toString(Qt::ISODate));
+    query.bindValue(":afterTs", cursor->timestamp);
+    query.bindValue(":afterId", cursor->id);
+    query.bindValue(":limit", limit);
+    
+    if (query.exec()) {
+        while (query.next()) {
+            const QString timestamp = query.value(1).toString();
+            const int ecgBytes = query.value(5).toInt();
+            columns.ids.append(query.value(0).toLongLong());
+            columns.timestamps.append(
+                QDateTime::fromString(timestamp, Qt::ISODate).toMSecsSinceEpoch());
+            columns.temperatures.append(query.value(2).toFloat());
+            columns.heartRates.append(static_cast<qint16>(query.value(3).toInt()));
+            columns.bloodOxygens.append(static_cast<qint16>(query.value(4).toInt()));
+            columns.ecgCounts.append(ecgBytes > 4 ? (ecgBytes - 4) / int(sizeof(double)) : 0);
+            
+            cursor->timestamp = timestamp;
+            cursor->id = columns.ids.last();
+        }
+    }
+    
+    return columns;
+}
+
+int DataManager::getRecordCount(const QDateTime& start, const QDateTime& end)
+{
+    QSqlQuery query(m_db);
+    query.prepare("SELECT COUNT(*) FROM vital_data WHERE timestamp BETWEEN :start AND :end");
+    query.bindValue(":start", start.toString(Qt::ISODate));
+    query.bindValue(":end", end.toString(Qt::ISODate));
+    
+    if (query.exec() && query.next()) {
+        return query.value(0).toInt();
+    }
+    return 0;
+}
+
+VitalTrend DataManager::getVitalTrend(const QDateTime& start, const QDateTime& end, int maxBuckets)
+{
+    VitalTrend trend;
+    const qint64 rangeSecs = qMax<qint64>(1, start.secsTo(end));
+    const qint64 bucketSecs = qMax<qint64>(1, (rangeSecs + maxBuckets - 1) / qMax(1, maxBuckets));
+    trend.bucketMs = bucketSecs * 1000;
+    
+    // 聚合在 SQLite 中完成, 只有桶 (而非每一行) 回到这里; 桶号相对查询起点计算,
+    // 与时间戳按何种时区解析无关
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    query.prepare(R"(
+        SELECT (CAST(strftime('%s', timestamp) AS INTEGER) - CAST(strftime('%s', :origin) AS INTEGER))
+                   / :bucketSecs AS bucket,
+               MIN(t), MAX(t), AVG(t), COUNT(t),
+               MIN(h), MAX(h), AVG(h), COUNT(h),
+               MIN(s), MAX(s), AVG(s), COUNT(s)
+        FROM (
+            SELECT timestamp,
+                   CASE WHEN temperature > 0 THEN temperature END AS t,
+                   CASE WHEN heart_rate > 0 THEN heart_rate END AS h,
+                   CASE WHEN blood_oxygen > 0 THEN blood_oxygen END AS s
+            FROM vital_data
+            WHERE timestamp BETWEEN :start AND :end
+        )
+        GROUP BY bucket
+        ORDER BY bucket ASC
+    )");
+    
+    query.bindValue(":origin", start.toString(Qt::ISODate));
+    query.bindValue(":bucketSecs", bucketSecs);
+    query.bindValue(":start", start.toString(Qt::ISODate));
+    query.bindValue(":end", end.toString(Qt::ISODate));
+    
+    if (query.exec()) {
+        const qint64 originMs = start.toMSecsSinceEpoch();
+        QVector<VitalTrendBucket>* series[] = {
+            &trend.temperatures, &trend.heartRates, &trend.bloodOxygens
+        };
+        while (query.next()) {
+            const qint64 timeMs = originMs + query.value(0).toLongLong() * trend.bucketMs;
+            for (int i = 0; i < 3; ++i) {
+                const int column = 1 + 4 * i;
+                const int count = query.value(column + 3).toInt();
+                if (count <= 0) continue;
+                
+                VitalTrendBucket bucket;
+                bucket.timeMs = timeMs;
+                bucket.min = query.value(column).toDouble();
+                bucket.max = query.value(column + 1).toDouble();
+                bucket.mean = query.value(column + 2).toDouble();
+                bucket.count = count;
+                series[i]->append(bucket);
+            }
+        }
+    }
+    
+    return trend;
+}
+
+QVector<double> DataManager::getEcgData(qint64 id)
+{
+    QVector<double> ecgData;
+    QSqlQuery query(m_db);
+    
+    query.prepare("SELECT ecg_data FROM vital_data WHERE id = :id");
+    query.bindValue(":id", id);
+    
+    if (query.exec() && query.next()) {
+        QByteArray ecgBytes = query.value(0).toByteArray();
+        if (!ecgBytes.isEmpty()) {
+            QDataStream stream(&ecgBytes, QIODevice::ReadOnly);
+            stream >> ecgData;
+        }
+    }
+    
+    return ecgData;
+}
+
+QVector<EcgSegment> DataManager::getEcgSegments(const QDateTime& start, const QDateTime& end)
+{
+    QVector<EcgSegment> segments;
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    
+    query.prepare(R"(
+        SELECT timestamp, ecg_data
+        FROM vital_data
+        WHERE timestamp BETWEEN :start AND :end AND length(ecg_data) > 0
+        ORDER BY timestamp ASC, id ASC
+    )");
+    
+    query.bindValue(":start", start.toString(Qt::ISODate));
+    query.bindValue(":end", end.toString(Qt::ISODate));
+    
+    if (query.exec()) {
+        while (query.next()) {
+            EcgSegment segment;
+            segment.timeMs = QDateTime::fromString(query.value(0).toString(), Qt::ISODate)
+                                 .toMSecsSinceEpoch();
+            QByteArray ecgBytes = query.value(1).toByteArray();
+            QDataStream stream(&ecgBytes, QIODevice::ReadOnly);
+            stream >> segment.samples;
+            segments.append(segment);
+        }
+    }
+    
+    return segments;
+}
+
+QVector<EcgSummaryBucket> DataManager::getEcgPyramid(int level, const QDateTime& start,
+                                                     const QDateTime& end)
+{
+    // 未写入的当前秒也要能查到
+    flushEcgPyramid();
+    
+    QVector<EcgSummaryBucket> buckets;
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    
+    query.prepare(R"(
+        SELECT bucket, min, max
+        FROM ecg_pyramid
+        WHERE level = :level AND bucket BETWEEN :from AND :to
+        ORDER BY bucket ASC
+    )");
+    
+    const qint64 bucketMs = ecgPyramidBucketMs(level);
+    query.bindValue(":level", level);
+    query.bindValue(":from", start.toMSecsSinceEpoch() / bucketMs);
+    query.bindValue(":to", end.toMSecsSinceEpoch() / bucketMs);
+    
+    if (query.exec()) {
+        while (query.next()) {
+            EcgSummaryBucket bucket;
+            bucket.startMs = query.value(0).toLongLong() * bucketMs;
+            bucket.min = query.value(1).toFloat();
+            bucket.max = query.value(2).toFloat();
+            buckets.append(bucket);
+        }
+    }
+    
+    return buckets;
+}
+
 QVector<VitalData> DataManager::getRecentData(int minutes)
 {
     QDateTime end = QDateTime::currentDateTime();
@@ -386,7 +817,19 @@ bool DataManager::deleteOldData(int daysToKeep)
     query.prepare("DELETE FROM vital_data WHERE timestamp < :cutoff");
     query.bindValue(":cutoff", cutoff.toString(Qt::ISODate));
     
-    return query.exec();
+    if (!query.exec()) {
+        return false;
+    }
+    
+    // 金字塔桶按起始时间清理, 跨越截止时间的粗粒度桶保留
+    QSqlQuery pyramidQuery(m_db);
+    pyramidQuery.prepare(R"(
+        DELETE FROM ecg_pyramid
+        WHERE (bucket + 1) * (:baseMs << (4 * level)) <= :cutoff
+    )");
+    pyramidQuery.bindValue(":baseMs", kEcgPyramidBaseMs);
+    pyramidQuery.bindValue(":cutoff", cutoff.toMSecsSinceEpoch());
+    return pyramidQuery.exec();
 }
 
 qint64 DataManager::getDatabaseSize() const
@@ -5,16 +5,26 @@
 #include <QDateTime>
 #include "vitaldata.h"
 
+class QTimer;
+
 class DataManager : public QObject {
     Q_OBJECT
 
 public:
+    // 心电摘要金字塔: 与心电数据同库存放, 第 level 级每个桶覆盖 64·16^level 毫秒 (64毫秒 ~ 约70分钟)
+    static constexpr int kEcgPyramidLevels = 5;
+    static qint64 ecgPyramidBucketMs(int level);
+
     explicit DataManager(QObject* parent = nullptr);
     ~DataManager();
 
     bool initialize(const QString& dbPath = QString());
     void close();
     
+    // 心电采样率: 同一秒内的心电样本按此排布到金字塔的亚秒级桶, 应在 initialize() 之前设置
+    // (首次打开旧数据库时据此在后台重建金字塔)
+    void setEcgSampleRate(int sampleRate);
+    
     // 数据存储
     bool saveVitalData(const VitalData& data);
     bool saveTemperature(double temp, const QDateTime& timestamp = QDateTime::currentDateTime());
@@ -24,6 +34,17 @@ public:
     
     // 数据查询
     QVector<VitalData> getVitalDataRange(const QDateTime& start, const QDateTime& end);
+    // 列式分页查询 (按时间戳、id 递增), 不读取心电数据; 从 cursor 之后最多读取 limit 行,
+    // cursor 随之移到本页最后一行。心电按记录或时间范围单独读取
+    VitalColumns getVitalColumns(const QDateTime& start, const QDateTime& end,
+                                 VitalPageCursor* cursor, int limit);
+    int getRecordCount(const QDateTime& start, const QDateTime& end);
+    // 按时间桶聚合的趋势, 桶宽取整秒, 使桶数不超过 maxBuckets
+    VitalTrend getVitalTrend(const QDateTime& start, const QDateTime& end, int maxBuckets);
+    QVector<double> getEcgData(qint64 id);
+    QVector<EcgSegment> getEcgSegments(const QDateTime& start, const QDateTime& end);
+    // 指定金字塔级别在时间范围内的桶, 按时间递增
+    QVector<EcgSummaryBucket> getEcgPyramid(int level, const QDateTime& start, const QDateTime& end);
     QVector<VitalData> getRecentData(int minutes = 60);
     VitalData getLatestData();
     
@@ -53,11 +74,46 @@ public:
 signals:
     void dataSaved();
     void error(const QString& message);
+    // 后台重建心电摘要金字塔完成, 此前读到的摘要可能不完整
+    void ecgPyramidRebuilt();
 
 private:
+    // 金字塔最细一级的桶
+    struct PyramidBucket {
+        qint64 index = 0;
+        double min = 0.0;
+        double max = 0.0;
+        int count = 0;
+    };
+    // 一路心电写入金字塔的中间状态: 样本排布与尚未写入的最细一级桶
+    struct PyramidBuilder {
+        EcgSampleClock clock;
+        QVector<PyramidBucket> pending;
+    };
+    
     bool createTables();
     bool executeQuery(const QString& query);
+    // 金字塔分级或样本排布变化后, 从已存储的心电重建金字塔 (每个数据库只进行一次)。
+    // 重建在事件循环中分批进行, 不阻塞启动; 重建开始后存入的心电照常实时写入
+    bool startEcgPyramidRebuild();
+    void rebuildEcgPyramidBatch();
+    // 心电样本并入当前秒的摘要, 跨秒时把上一秒写入金字塔各级
+    void accumulateEcgPyramid(const QDateTime& timestamp, const QVector<double>& ecgData);
+    void appendEcgPyramidSamples(PyramidBuilder& builder, qint64 timeMs, const QVector<double>& ecgData);
+    void flushEcgPyramid();
+    bool writeEcgPyramid(QVector<PyramidBucket>& pending);
     
     QSqlDatabase m_db;
     QString m_dbPath;
+    int m_ecgSampleRate = 200;
+    
+    // 实时写入: 尚未写入金字塔的当前秒
+    qint64 m_pyramidSecond = -1;
+    PyramidBuilder m_pyramid;
+    
+    // 后台重建: 只处理开始时已存在的行 (id <= m_rebuildMaxId), 按时间戳、id 分页推进
+    QTimer* m_rebuildTimer = nullptr;
+    PyramidBuilder m_rebuild;
+    VitalPageCursor m_rebuildCursor;
+    qint64 m_rebuildMaxId = 0;
 };
@@ -1,23 +1,40 @@
 #include "ecgchartwidget.h"
+#include "renderticker.h"
+#include "ecgsweepview.h"
+#include "waveformdecimator.h"
 #include <QVBoxLayout>
 #include <QPen>
 #include <QBrush>
 
 using namespace Qt;
 
+namespace {
+
+// Y轴自动缩放: 数据越出当前范围时立即扩展; 目标范围不足当前跨度的该比例时才收缩,
+// 避免每帧随波形起伏重设坐标轴
+constexpr double kAxisPaddingRatio = 0.2;
+constexpr double kAxisMinPadding = 50.0;   // 最小50mV的边距
+constexpr double kAxisShrinkRatio = 0.6;
+
+// 回放: 单个节拍最多送入的数据时长 (按回放速度折算); 界面卡顿后不集中补发, 计时顺延
+constexpr double kMaxPlaybackStepSec = 0.25;
+// 跳转时在显示窗口之外多送入的数据, 供滤波与R波检测预热
+constexpr double kSeekPrerollSec = 2.0;
+
+} // namespace
+
 EcgChartWidget::EcgChartWidget(QWidget* parent)
     : QWidget(parent)
-    , m_chartView(new QChartView(this))
+    , m_chartView(new CachedChartView(this))
     , m_chart(new QChart())
     , m_series(new QLineSeries())
     , m_rpeakSeries(new QScatterSeries())
     , m_axisX(new QValueAxis())
     , m_axisY(new QValueAxis())
-    , m_playbackTimer(new QTimer(this))
     , m_lineColor(QColor("#00ff88"))
     , m_backgroundColor(QColor("#0a1628"))
     , m_gridColor(QColor("#1a3a5c"))
-    , m_rpeakDetector(new RPeakDetector(this))
+    , m_rpeakDetector(QrsDetector::create(QrsDetector::Algorithm::PanTompkins, this))
 {
     setupChart();
 
@@ -26,10 +43,14 @@ EcgChartWidget::EcgChartWidget(QWidget* parent)
     layout->addWidget(m_chartView);
 
     m_maxPoints = m_displayDuration * m_sampleRate;
+    m_displayBuffer.setCapacity(m_maxPoints);
     m_rpeakDetector->setSampleRate(m_sampleRate);
 
-    connect(m_playbackTimer, &QTimer::timeout, this, &EcgChartWidget::onPlaybackTimer);
-    connect(m_rpeakDetector, &RPeakDetector::heartRateUpdated, this, &EcgChartWidget::heartRateFromEcg);
+    connectDetector();
+
+    RenderTicker* ticker = RenderTicker::shared();
+    connect(ticker, &RenderTicker::tick, this, &EcgChartWidget::onRenderTick);
+    ticker->addClient(this);
 }
 
 EcgChartWidget::~EcgChartWidget()
@@ -37,11 +58,17 @@ EcgChartWidget::~EcgChartWidget()
     stopPlayback();
 }
 
+void EcgChartWidget::connectDetector()
+{
+    connect(m_rpeakDetector, &QrsDetector::heartRateUpdated, this, &EcgChartWidget::heartRateFromEcg);
+    connect(m_rpeakDetector, &QrsDetector::rPeakDetected, this, &EcgChartWidget::rPeakDetected);
+    connect(m_rpeakDetector, &QrsDetector::rPeakDetected, this, &EcgChartWidget::onRPeakDetected);
+}
+
 void EcgChartWidget::setupChart()
 {
-    // 配置图表外观
-    m_chart->setBackgroundBrush(QBrush(m_backgroundColor));
-    m_chart->setBackgroundRoundness(0);
+    // 配置图表外观: 背景与网格线由视图的静态图层绘制, 曲线更新时不随场景重画
+    m_chart->setBackgroundVisible(false);
     m_chart->legend()->hide();
     m_chart->setMargins(QMargins(10, 10, 10, 10));
     m_chart->setTitle("");
@@ -65,7 +92,8 @@ void EcgChartWidget::setupChart()
     m_axisX->setTitleText(QStringLiteral("时间 (秒)"));
     m_axisX->setTitleBrush(QBrush(Qt::white));
     m_axisX->setLabelsBrush(QBrush(Qt::white));
-    m_axisX->setGridLineColor(m_gridColor);
+    m_axisX->setGridLineVisible(false);
+    m_axisX->setMinorGridLineVisible(false);
     m_axisX->setLinePen(QPen(m_gridColor));
     m_axisX->setTickCount(11);  // 每0.5秒一个刻度 (5秒 / 0.5 + 1)
     m_axisX->setMinorTickCount(4);  // 次刻度
@@ -79,7 +107,8 @@ void EcgChartWidget::setupChart()
     m_axisY->setTitleText(QStringLiteral("电压 (mV)"));
     m_axisY->setTitleBrush(QBrush(Qt::white));
     m_axisY->setLabelsBrush(QBrush(Qt::white));
-    m_axisY->setGridLineColor(m_gridColor);
+    m_axisY->setGridLineVisible(false);
+    m_axisY->setMinorGridLineVisible(false);
     m_axisY->setLinePen(QPen(m_gridColor));
     m_axisY->setTickCount(11);  // 每100mV一个刻度
     m_chart->addAxis(m_axisY, Qt::AlignLeft);
@@ -90,40 +119,44 @@ void EcgChartWidget::setupChart()
     m_chartView->setChart(m_chart);
     m_chartView->setRenderHint(QPainter::Antialiasing);
     m_chartView->setBackgroundBrush(QBrush(m_backgroundColor));
+    m_chartView->setGridColor(m_gridColor);
 }
 
 void EcgChartWidget::addDataPoint(double value)
 {
+    // 需要重采样或小波去噪时走批量路径, 输出点数由重采样器/去噪帧决定
+    if (!m_resampler.isPassthrough() || m_waveletEnabled) {
+        addDataPoints(QVector<double>{value});
+        return;
+    }
+
     // 应用低通滤波
     double filteredValue = applyLowPassFilter(value);
 
-    double x = static_cast<double>(m_currentIndex) / m_sampleRate;
-    m_series->append(x, filteredValue);
-    m_currentIndex++;
+    m_displayBuffer.append(filteredValue);
 
     // R波检测 (使用滤波后的值)
     if (m_rpeakEnabled) {
         m_rpeakDetector->processSample(filteredValue);
     }
 
-    // 限制显示点数
-    while (m_series->count() > m_maxPoints) {
-        m_series->remove(0);
-    }
-
-    updateAxisRange();
-    updateRPeakMarkers();
+    m_displayDirty = true;
 }
 
-void EcgChartWidget::addDataPoints(const QVector<double>& values)
+void EcgChartWidget::addDataPoints(const QVector<double>& rawValues)
 {
+    QVector<double> values = m_resampler.isPassthrough()
+        ? rawValues : m_resampler.process(rawValues);
+    if (m_waveletEnabled) {
+        values = m_denoiser.process(values);
+    }
+    if (values.isEmpty()) return;
+
     for (double value : values) {
-        // 应用低通滤波
-        double filteredValue = applyLowPassFilter(value);
+        // 应用低通滤波 (小波去噪已完成时跳过)
+        double filteredValue = m_waveletEnabled ? value : applyLowPassFilter(value);
 
-        double x = static_cast<double>(m_currentIndex) / m_sampleRate;
-        m_series->append(x, filteredValue);
-        m_currentIndex++;
+        m_displayBuffer.append(filteredValue);
 
         // R波检测
         if (m_rpeakEnabled) {
@@ -131,48 +164,83 @@ void EcgChartWidget::addDataPoints(const QVector<double>& values)
         }
     }
 
-    // 限制显示点数
-    while (m_series->count() > m_maxPoints) {
-        m_series->remove(0);
-    }
-
-    updateAxisRange();
-    updateRPeakMarkers();
+    // 超出显示窗口的旧点已被环形缓冲覆盖, 曲线留待渲染节拍整体重绘
+    m_displayDirty = true;
 }
 
 void EcgChartWidget::clear()
 {
     m_series->clear();
     m_rpeakSeries->clear();
-    m_currentIndex = 0;
+    m_displayBuffer.clear();
+    m_timeOffset = 0.0;
     m_axisX->setRange(0, m_displayDuration);
 
     // 重置滤波器状态
     m_filterInitialized = false;
     m_lastFilteredValue = 0.0;
 
-    // 重置R波检测器
+    // 重置重采样器、小波去噪和R波检测器
+    m_resampler.reset();
+    m_denoiser.reset();
     m_rpeakDetector->reset();
+
+    m_sweepFedIndex = 0;
+    m_sweepLastPeak = -1;
+    if (m_sweepView) m_sweepView->clear(0);
+}
+
+bool EcgChartWidget::restoreDetectorState(const QByteArray& state)
+{
+    if (!m_rpeakDetector->restoreState(state)) return false;
+    m_rpeakDetector->markDiscontinuity();
+
+    m_series->clear();
+    m_rpeakSeries->clear();
+    m_displayBuffer.clear(m_rpeakDetector->samplesProcessed());
+    m_filterInitialized = false;
+    m_lastFilteredValue = 0.0;
+    m_resampler.reset();
+    m_denoiser.reset();
+
+    m_sweepFedIndex = m_displayBuffer.nextIndex();
+    m_sweepLastPeak = -1;
+    if (m_sweepView) m_sweepView->clear(m_sweepFedIndex);
+    return true;
 }
 
 void EcgChartWidget::setDisplayDuration(int seconds)
 {
     m_displayDuration = seconds;
     m_maxPoints = m_displayDuration * m_sampleRate;
-    updateAxisRange();
+    m_displayBuffer.setCapacity(m_maxPoints);
+    m_displayDirty = true;
+    if (m_sweepView) m_sweepView->setSweepDuration(seconds);
 }
 
 void EcgChartWidget::setSampleRate(int samplesPerSecond)
 {
     m_sampleRate = samplesPerSecond;
     m_maxPoints = m_displayDuration * m_sampleRate;
+    m_displayBuffer.setCapacity(m_maxPoints);
     m_rpeakDetector->setSampleRate(samplesPerSecond);
+    m_resampler.setRates(m_resampler.inputRate(), samplesPerSecond);
+    m_denoiser.setSampleRate(samplesPerSecond);
+    if (m_sweepView) {
+        m_sweepView->setSampleRate(samplesPerSecond);
+        m_sweepFedIndex = m_sweepView->nextIndex();
+    }
+}
+
+void EcgChartWidget::setInputSampleRate(int samplesPerSecond)
+{
+    if (samplesPerSecond <= 0 || samplesPerSecond == m_resampler.inputRate()) return;
+    m_resampler.setRates(samplesPerSecond, m_sampleRate);
 }
 
 void EcgChartWidget::setGridVisible(bool visible)
 {
-    m_axisX->setGridLineVisible(visible);
-    m_axisY->setGridLineVisible(visible);
+    m_chartView->setGridVisible(visible);
 }
 
 void EcgChartWidget::setAnimationEnabled(bool enabled)
@@ -180,51 +248,241 @@ void EcgChartWidget::setAnimationEnabled(bool enabled)
     m_chart->setAnimationOptions(enabled ? QChart::SeriesAnimations : QChart::NoAnimation);
 }
 
+void EcgChartWidget::setRenderMode(RenderMode mode)
+{
+    if (mode == m_renderMode) return;
+    m_renderMode = mode;
+
+    if (mode == RenderMode::Sweep) {
+        if (!m_sweepView) {
+            m_sweepView = new EcgSweepView(this);
+            m_sweepView->setSampleRate(m_sampleRate);
+            m_sweepView->setSweepDuration(m_displayDuration);
+            m_sweepView->setLineColor(m_lineColor);
+            m_sweepView->setBackgroundColor(m_backgroundColor);
+            m_sweepView->setGridColor(m_gridColor);
+            connect(m_sweepView, &EcgSweepView::traceCleared, this, &EcgChartWidget::refillSweepView);
+            layout()->addWidget(m_sweepView);
+        }
+        m_chartView->hide();
+        m_sweepView->show();
+        refillSweepView();
+    } else {
+        if (m_sweepView) m_sweepView->hide();
+        m_chartView->show();
+        // 扫描期间曲线未更新, 切回后的首个节拍补绘
+        m_displayDirty = true;
+    }
+}
+
 void EcgChartWidget::startPlayback(const QVector<double>& data, int sampleRate)
 {
-    if (data.isEmpty()) return;
+    if (data.isEmpty() || sampleRate <= 0) return;
     
     stopPlayback();
     clear();
     
     m_playbackData = data;
-    m_sampleRate = sampleRate;
+    m_playbackRate = sampleRate;
+    setInputSampleRate(sampleRate);
     m_playbackIndex = 0;
+    m_playbackPaused = false;
     m_isPlaying = true;
-    
-    // 每次回放10个点以保持流畅
-    m_playbackTimer->start(1000 / (sampleRate / 10));
+    restartPlaybackClock();
 }
 
 void EcgChartWidget::stopPlayback()
 {
-    m_playbackTimer->stop();
     m_isPlaying = false;
+    m_playbackPaused = false;
     m_playbackData.clear();
     m_playbackIndex = 0;
+    m_playbackOrigin = 0;
+}
+
+void EcgChartWidget::setPlaybackPaused(bool paused)
+{
+    if (!m_isPlaying || paused == m_playbackPaused) return;
+    // 暂停前送入截至此刻的样本, 恢复时从暂停位置重新计时; 停在末尾时从头重播
+    if (paused) {
+        advancePlayback();
+        if (m_playbackPaused) return;
+    } else if (m_playbackIndex >= m_playbackData.size()) {
+        seekPlayback(0.0);
+    }
+    m_playbackPaused = paused;
+    if (!paused) restartPlaybackClock();
+}
+
+void EcgChartWidget::setPlaybackSpeed(double speed)
+{
+    speed = qBound(kMinPlaybackSpeed, speed, kMaxPlaybackSpeed);
+    if (speed == m_playbackSpeed) return;
+    // 以旧速度结算到此刻, 之后按新速度计时
+    advancePlayback();
+    m_playbackSpeed = speed;
+    restartPlaybackClock();
+}
+
+void EcgChartWidget::seekPlayback(double seconds)
+{
+    if (!m_isPlaying) return;
+
+    const int target = qBound(0, qRound(seconds * m_playbackRate),
+                              static_cast<int>(m_playbackData.size()));
+    const int preroll = qRound((m_displayDuration + kSeekPrerollSec) * m_playbackRate);
+    const int from = qMax(0, target - preroll);
+
+    // 滤波器与检测器状态不能跨越跳转, 从预热起点重新开始; 样本计数随之从0开始,
+    // 时间轴与R波标记整体偏移到预热起点在回放中的时刻
+    clear();
+    m_timeOffset = static_cast<double>(from) / m_playbackRate;
+    m_axisX->setRange(m_timeOffset, m_timeOffset + m_displayDuration);
+    if (target > from) {
+        addDataPoints(m_playbackData.mid(from, target - from));
+    }
+    m_playbackIndex = target;
+    restartPlaybackClock();
+    emit playbackPositionChanged(playbackPosition());
+}
+
+double EcgChartWidget::playbackPosition() const
+{
+    return static_cast<double>(m_playbackIndex) / m_playbackRate;
+}
+
+double EcgChartWidget::playbackDuration() const
+{
+    return static_cast<double>(m_playbackData.size()) / m_playbackRate;
 }
 
-void EcgChartWidget::onPlaybackTimer()
+void EcgChartWidget::restartPlaybackClock()
 {
-    if (!m_isPlaying || m_playbackIndex >= m_playbackData.size()) {
-        stopPlayback();
+    m_playbackOrigin = m_playbackIndex;
+    m_playbackClock.start();
+}
+
+void EcgChartWidget::advancePlayback()
+{
+    if (!m_isPlaying || m_playbackPaused) return;
+
+    const int total = static_cast<int>(m_playbackData.size());
+    const double samplesPerMs = m_playbackRate * m_playbackSpeed / 1000.0;
+    const qint64 due = m_playbackOrigin + static_cast<qint64>(m_playbackClock.elapsed() * samplesPerMs);
+    int target = static_cast<int>(qMin<qint64>(due, total));
+
+    // 每个节拍的送入量有上限, 高倍速或界面卡顿时工作量仍受帧率约束
+    const int maxStep = qMax(1, qRound(samplesPerMs * 1000.0 * kMaxPlaybackStepSec));
+    if (target - m_playbackIndex > maxStep) {
+        target = m_playbackIndex + maxStep;
+        m_playbackOrigin = target;
+        m_playbackClock.start();
+    }
+
+    if (target > m_playbackIndex) {
+        addDataPoints(m_playbackData.mid(m_playbackIndex, target - m_playbackIndex));
+        m_playbackIndex = target;
+        emit playbackPositionChanged(playbackPosition());
+    }
+
+    // 播放到末尾后停在末尾 (相当于暂停), 数据保留, 仍可跳转回看或从头重播
+    if (m_playbackIndex >= total) {
+        m_playbackPaused = true;
         emit playbackFinished();
+    }
+}
+
+void EcgChartWidget::onRenderTick()
+{
+    advancePlayback();
+
+    if (!m_displayDirty) return;
+    // 隐藏时标记照常淘汰, 避免长时间最小化后标记序列无限增长
+    pruneRPeakMarkers();
+
+    // 隐藏或最小化时保留待绘制标记, 重新可见后的首个节拍补绘
+    if (!isVisible() || window()->isMinimized()) return;
+    m_displayDirty = false;
+
+    if (m_renderMode == RenderMode::Sweep) {
+        feedSweepView();
         return;
     }
-    
-    // 每次添加10个点
-    int batchSize = 10;
-    for (int i = 0; i < batchSize && m_playbackIndex < m_playbackData.size(); ++i) {
-        addDataPoint(m_playbackData[m_playbackIndex++]);
+
+    publishSeries();
+    updateAxisRange();
+}
+
+void EcgChartWidget::feedSweepView()
+{
+    // 环形缓冲已覆盖的样本不再补画, 从缓冲中最旧的样本接上
+    const qint64 first = qMax(m_sweepFedIndex, m_displayBuffer.firstIndex());
+    const qint64 next = m_displayBuffer.nextIndex();
+    if (first != m_sweepView->nextIndex()) {
+        m_sweepView->clear(first);
+    }
+    if (next > first) {
+        const int offset = static_cast<int>(first - m_displayBuffer.firstIndex());
+        const int count = static_cast<int>(next - first);
+        m_sweepFeed.resize(count);
+        for (int i = 0; i < count; ++i) {
+            m_sweepFeed[i] = m_displayBuffer.at(offset + i);
+        }
+        m_sweepView->appendSamples(m_sweepFeed.constData(), count);
+    }
+    m_sweepFedIndex = next;
+
+    if (!m_rpeakEnabled) return;
+
+    // 检测有延迟, R波在样本画出之后才确认; 只标记上次之后新增的R波
+    const auto& peaks = m_rpeakDetector->detectedPeaks();
+    int start = static_cast<int>(peaks.size());
+    while (start > 0 && peaks[start - 1].sampleIndex > m_sweepLastPeak) {
+        --start;
+    }
+    for (int i = start; i < peaks.size(); ++i) {
+        m_sweepView->markBeat(peaks[i].sampleIndex, peaks[i].amplitude);
+        m_sweepLastPeak = peaks[i].sampleIndex;
+    }
+}
+
+void EcgChartWidget::refillSweepView()
+{
+    if (!m_sweepView || m_renderMode != RenderMode::Sweep) return;
+    m_sweepView->clear(m_displayBuffer.firstIndex());
+    m_sweepFedIndex = m_displayBuffer.firstIndex();
+    m_sweepLastPeak = -1;
+    m_displayDirty = true;
+}
+
+void EcgChartWidget::publishSeries()
+{
+    // replace 只发出一次 pointsReplaced, 图表整体重建一次几何;
+    // 逐点 append/remove(0) 每个样本都要移动整个点列并各触发一次重绘
+    //
+    // 窗口样本数多于绘图区像素列时 (长显示时长、高采样率) 按列做 M4 抽取,
+    // 点数受控件宽度约束, R波尖峰保留
+    QList<QPointF> points = WaveformDecimator::decimate(m_displayBuffer, m_sampleRate, plotColumns());
+    if (m_timeOffset != 0.0) {
+        for (QPointF& point : points) point.rx() += m_timeOffset;
     }
+    m_series->replace(points);
+}
+
+int EcgChartWidget::plotColumns() const
+{
+    // 绘图区尚未布局时按整个视图宽度估计; 以设备像素计, 高分屏上不损失细节
+    qreal width = m_chart->plotArea().width();
+    if (width <= 0) width = m_chartView->width();
+    return qMax(1, qRound(width * devicePixelRatioF()));
 }
 
 void EcgChartWidget::updateAxisRange()
 {
-    if (m_series->count() == 0) return;
+    if (m_displayBuffer.isEmpty()) return;
     
-    double minX = m_series->at(0).x();
-    double maxX = m_series->at(m_series->count() - 1).x();
+    double minX = m_timeOffset + static_cast<double>(m_displayBuffer.firstIndex()) / m_sampleRate;
+    double maxX = m_timeOffset + static_cast<double>(m_displayBuffer.nextIndex() - 1) / m_sampleRate;
     
     if (maxX - minX > m_displayDuration) {
         m_axisX->setRange(maxX - m_displayDuration, maxX);
@@ -232,17 +490,20 @@ void EcgChartWidget::updateAxisRange()
         m_axisX->setRange(minX, minX + m_displayDuration);
     }
     
-    // 自动调整Y轴范围
-    double minY = 0, maxY = 0;
-    for (int i = 0; i < m_series->count(); ++i) {
-        double y = m_series->at(i).y();
-        if (y < minY) minY = y;
-        if (y > maxY) maxY = y;
+    // 自动调整Y轴范围 (范围始终包含0电平), 窗口极值由显示缓冲的单调队列维护
+    const double minY = qMin(0.0, m_displayBuffer.minimum());
+    const double maxY = qMax(0.0, m_displayBuffer.maximum());
+    const double padding = qMax(kAxisMinPadding, (maxY - minY) * kAxisPaddingRatio);
+    const double targetMin = minY - padding;
+    const double targetMax = maxY + padding;
+
+    const double currentMin = m_axisY->min();
+    const double currentMax = m_axisY->max();
+    const bool overflow = minY < currentMin || maxY > currentMax;
+    const bool tooLoose = (targetMax - targetMin) < (currentMax - currentMin) * kAxisShrinkRatio;
+    if (overflow || tooLoose) {
+        m_axisY->setRange(targetMin, targetMax);
     }
-    
-    double padding = (maxY - minY) * 0.2;
-    if (padding < 50.0) padding = 50.0;  // 最小50mV的边距
-    m_axisY->setRange(minY - padding, maxY + padding);
 }
 
 void EcgChartWidget::setLineColor(const QColor& color)
@@ -251,20 +512,21 @@ void EcgChartWidget::setLineColor(const QColor& color)
     QPen pen(color);
     pen.setWidth(2);
     m_series->setPen(pen);
+    if (m_sweepView) m_sweepView->setLineColor(color);
 }
 
 void EcgChartWidget::setBackgroundColor(const QColor& color)
 {
     m_backgroundColor = color;
-    m_chart->setBackgroundBrush(QBrush(color));
     m_chartView->setBackgroundBrush(QBrush(color));
+    if (m_sweepView) m_sweepView->setBackgroundColor(color);
 }
 
 void EcgChartWidget::setGridColor(const QColor& color)
 {
     m_gridColor = color;
-    m_axisX->setGridLineColor(color);
-    m_axisY->setGridLineColor(color);
+    m_chartView->setGridColor(color);
+    if (m_sweepView) m_sweepView->setGridColor(color);
 }
 
 void EcgChartWidget::setFilterEnabled(bool enabled)
@@ -283,6 +545,20 @@ void EcgChartWidget::setFilterCoefficient(double alpha)
     m_filterAlpha = qBound(0.01, alpha, 1.0);
 }
 
+void EcgChartWidget::setWaveletDenoiseEnabled(bool enabled)
+{
+    if (enabled == m_waveletEnabled) return;
+    m_waveletEnabled = enabled;
+    if (!enabled) {
+        // 去噪帧中尚未输出的样本被丢弃, 对检测器而言输入出现中断
+        m_rpeakDetector->markDiscontinuity();
+    } else {
+        // 从低通切换到小波: 低通状态下次启用时重新初始化
+        m_filterInitialized = false;
+    }
+    m_denoiser.reset();
+}
+
 void EcgChartWidget::setRPeakDetectionEnabled(bool enabled)
 {
     m_rpeakEnabled = enabled;
@@ -293,23 +569,38 @@ void EcgChartWidget::setRPeakDetectionEnabled(bool enabled)
     }
 }
 
-void EcgChartWidget::updateRPeakMarkers()
+void EcgChartWidget::setQrsAlgorithm(QrsDetector::Algorithm algorithm)
 {
-    if (!m_rpeakEnabled) return;
+    if (algorithm == m_rpeakDetector->algorithm()) return;
 
-    // 获取当前显示的X轴范围
-    double xMin = m_axisX->min();
-    double xMax = m_axisX->max();
+    QrsDetector* detector = QrsDetector::create(algorithm, this);
+    detector->setSampleRate(m_sampleRate);
+    delete m_rpeakDetector;
+    m_rpeakDetector = detector;
+    connectDetector();
 
-    // 重建可见范围内的R波标记
-    m_rpeakSeries->clear();
-    const auto& peaks = m_rpeakDetector->detectedPeaks();
-    for (int i = peaks.size() - 1; i >= 0; --i) {
-        double t = peaks[i].timestamp;
-        if (t < xMin) break;
-        if (t <= xMax) {
-            m_rpeakSeries->append(t, peaks[i].amplitude);
-        }
+    // 新检测器从0开始计数, 波形时间轴随之重新开始, 使R波标记位置保持一致
+    clear();
+}
+
+void EcgChartWidget::onRPeakDetected(const RPeakInfo& peak)
+{
+    // 新R波直接追加到标记序列 (R波按时间顺序检出), 不重建已有标记
+    if (m_rpeakEnabled) {
+        m_rpeakSeries->append(m_timeOffset + peak.timestamp, peak.amplitude);
+    }
+}
+
+void EcgChartWidget::pruneRPeakMarkers()
+{
+    // 移除已滚出显示窗口的标记; 标记按时间递增, 只需检查序列开头
+    const double windowStart = m_timeOffset + static_cast<double>(m_displayBuffer.firstIndex()) / m_sampleRate;
+    int expired = 0;
+    while (expired < m_rpeakSeries->count() && m_rpeakSeries->at(expired).x() < windowStart) {
+        ++expired;
+    }
+    if (expired > 0) {
+        m_rpeakSeries->removePoints(0, expired);
     }
 }
 
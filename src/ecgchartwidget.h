@@ -4,29 +4,67 @@
 #include <QtCharts/QLineSeries>
 #include <QtCharts/QScatterSeries>
 #include <QtCharts/QValueAxis>
-#include <QTimer>
+#include <QElapsedTimer>
 #include <QVector>
-#include "rpeakdetector.h"
+#include "qrsdetector.h"
+#include "ecgresampler.h"
+#include "waveletdenoiser.h"
+#include "waveformbuffer.h"
+#include "cachedchartview.h"
+
+class EcgSweepView;
 
 class EcgChartWidget : public QWidget {
     Q_OBJECT
 
 public:
+    // 绘制后端: Chart 为 QtCharts 滚动曲线 (带坐标轴与自动缩放),
+    // Sweep 为监护仪式扫描显示 (固定增益, 每帧只画新样本)
+    enum class RenderMode {
+        Chart,
+        Sweep
+    };
+
     explicit EcgChartWidget(QWidget* parent = nullptr);
     ~EcgChartWidget();
 
+    // 数据立即进入滤波/检测并写入显示缓冲, 曲线在下一个渲染节拍统一重绘
     void addDataPoint(double value);
     void addDataPoints(const QVector<double>& values);
     void clear();
     
     void setDisplayDuration(int seconds);
     void setSampleRate(int samplesPerSecond);
+    int sampleRate() const { return m_sampleRate; }
+
+    // 设备采样率: 与处理采样率不同时经多相重采样后再进入滤波/检测/显示
+    void setInputSampleRate(int samplesPerSecond);
+    int inputSampleRate() const { return m_resampler.inputRate(); }
     void setGridVisible(bool visible);
     void setAnimationEnabled(bool enabled);
+
+    void setRenderMode(RenderMode mode);
+    RenderMode renderMode() const { return m_renderMode; }
     
+    // 回放: 进度按墙钟时间 (QElapsedTimer) 计算, 每个渲染节拍把到期的样本整批送入,
+    // 与节拍间隔和采样率无关, 不累积定时器取整误差。播放到末尾后发出 playbackFinished 并停在
+    // 末尾 (暂停状态), 数据保留到 stopPlayback(), 期间可跳转; 在末尾恢复播放则从头重播
+    static constexpr double kMinPlaybackSpeed = 0.5;
+    static constexpr double kMaxPlaybackSpeed = 20.0;
+
     void startPlayback(const QVector<double>& data, int sampleRate = 250);
     void stopPlayback();
     bool isPlaying() const { return m_isPlaying; }
+    void setPlaybackPaused(bool paused);
+    bool isPlaybackPaused() const { return m_playbackPaused; }
+    void setPlaybackSpeed(double speed);
+    double playbackSpeed() const { return m_playbackSpeed; }
+    // 跳转到记录中的指定时刻 (秒): 清空显示后立即送入跳转点之前的一屏数据, 从跳转点继续回放;
+    // 时间轴仍按记录中的时刻标注
+    void seekPlayback(double seconds);
+    // 已回放的位置与记录总长 (秒)
+    double playbackPosition() const;
+    double playbackDuration() const;
     
     void setLineColor(const QColor& color);
     void setBackgroundColor(const QColor& color);
@@ -38,23 +76,51 @@ public:
     bool isFilterEnabled() const { return m_filterEnabled; }
     double getFilterCoefficient() const { return m_filterAlpha; }
 
+    // 小波去噪: 启用时代替单极点低通, 不削平QRS; 波形与R波检测整体延后
+    // 最多 WaveletDenoiser::latencySamples() 个样本
+    void setWaveletDenoiseEnabled(bool enabled);
+    bool isWaveletDenoiseEnabled() const { return m_waveletEnabled; }
+
     // R波检测
     void setRPeakDetectionEnabled(bool enabled);
     bool isRPeakDetectionEnabled() const { return m_rpeakEnabled; }
-    RPeakDetector* rPeakDetector() const { return m_rpeakDetector; }
+    QrsDetector* rPeakDetector() const { return m_rpeakDetector; }
+    // 切换检测算法: 重建检测器, 已检出的R波清空, 从下一个样本开始重新学习
+    void setQrsAlgorithm(QrsDetector::Algorithm algorithm);
+    QrsDetector::Algorithm qrsAlgorithm() const { return m_rpeakDetector->algorithm(); }
+    // 从检测器快照恢复 (应用重启): 检测器从快照处继续, 跨越停机间隔的R-R不计入,
+    // 时间轴对齐到检测器的样本计数, 使R波标记位置保持一致
+    bool restoreDetectorState(const QByteArray& state);
 
 signals:
     void playbackFinished();
+    void playbackPositionChanged(double seconds);
     void heartRateFromEcg(int bpm);
+    // 转发当前检测器的R波 (切换算法后连接保持有效)
+    void rPeakDetected(const RPeakInfo& peak);
 
 private slots:
-    void onPlaybackTimer();
+    // RenderTicker 节拍: 有新数据且控件可见时重绘一次
+    void onRenderTick();
+    void onRPeakDetected(const RPeakInfo& peak);
 
 private:
     void setupChart();
     void updateAxisRange();
+    // 显示缓冲整体写入曲线 (每批数据一次)
+    void publishSeries();
+    // 绘图区横向像素数, 决定抽取的列数
+    int plotColumns() const;
+    // 扫描显示: 只送入上次之后的新样本和新R波
+    void feedSweepView();
+    // 扫描图层被重建后用显示缓冲重新画满一屏
+    void refillSweepView();
+    // 回放: 送入截至当前墙钟时刻的样本, 由渲染节拍调用
+    void advancePlayback();
+    // 以当前位置为起点重新计时 (变速、暂停恢复、跳转后)
+    void restartPlaybackClock();
 
-    QChartView* m_chartView;
+    CachedChartView* m_chartView;   // 背景与网格为缓存图层, 场景中只有坐标轴与曲线
     QChart* m_chart;
     QLineSeries* m_series;
     QScatterSeries* m_rpeakSeries;  // R波标记点
@@ -64,12 +130,25 @@ private:
     int m_displayDuration = 5;  // seconds
     int m_sampleRate = 200;     // samples per second (20 points per 100ms)
     int m_maxPoints;
-    int m_currentIndex = 0;
+    WaveformBuffer m_displayBuffer;  // 显示窗口内的样本, 容量 m_maxPoints; nextIndex() 为样本计数
+    bool m_displayDirty = false;     // 上次重绘后有新数据
+    double m_timeOffset = 0.0;       // 样本计数0对应的时间轴时刻 (秒), 回放跳转后为预热起点
+    EcgResampler m_resampler;   // 设备采样率 -> m_sampleRate
+
+    RenderMode m_renderMode = RenderMode::Chart;
+    EcgSweepView* m_sweepView = nullptr;  // 首次切换到扫描模式时创建
+    qint64 m_sweepFedIndex = 0;           // 已送入扫描显示的样本计数
+    int m_sweepLastPeak = -1;             // 已标记的最后一个R波样本索引
+    QVector<double> m_sweepFeed;          // 送入扫描显示的连续样本, 复用避免逐帧分配
     
     QVector<double> m_playbackData;
-    QTimer* m_playbackTimer;
-    int m_playbackIndex = 0;
+    QElapsedTimer m_playbackClock;
+    int m_playbackRate = 250;         // 回放数据的采样率
+    double m_playbackSpeed = 1.0;
+    int m_playbackIndex = 0;          // 已送入的样本数
+    int m_playbackOrigin = 0;         // 计时起点对应的样本位置
     bool m_isPlaying = false;
+    bool m_playbackPaused = false;
     
     QColor m_lineColor;
     QColor m_backgroundColor;
@@ -83,8 +162,14 @@ private:
     
     double applyLowPassFilter(double rawValue);
 
+    // 小波去噪
+    WaveletDenoiser m_denoiser;
+    bool m_waveletEnabled = false;
+
     // R波检测
-    RPeakDetector* m_rpeakDetector;
+    QrsDetector* m_rpeakDetector;
     bool m_rpeakEnabled = true;
-    void updateRPeakMarkers();
+    void connectDetector();
+    // 标记随 rPeakDetected 逐个追加, 每个渲染节拍移除滚出窗口的标记
+    void pruneRPeakMarkers();
 };
@@ -0,0 +1,221 @@
+#include "ecgdelineator.h"
+#include <QtMath>
+
+namespace {
+
+// 各搜索窗口 (秒)
+constexpr double kSmoothSec = 0.012;       // QRS平滑窗口, 抑制噪声对斜率的影响
+constexpr double kWaveSmoothSec = 0.04;    // P/T波为低频成分, 用更宽的平滑
+constexpr double kSlopeSearchSec = 0.06;   // R波两侧取最大斜率的范围
+constexpr double kQrsOnsetSec = 0.12;      // QRS起点最远回溯
+constexpr double kQrsOffsetSec = 0.14;     // QRS终点最远前探
+constexpr double kQrsGapSec = 0.016;       // 斜率低于阈值超过此时长即认为QRS结束
+constexpr double kBaselineSearchSec = 0.04; // 等电位线只在PQ交界附近找, 过远会落到平坦的P波顶部
+constexpr double kBaselineWindowSec = 0.02;
+constexpr double kPSearchSec = 0.25;       // P波在QRS起点前的搜索范围
+constexpr double kPRRFraction = 0.35;      // 心率快时P波窗口不超过R-R的35%, 避开前一搏T波
+constexpr double kPGapSec = 0.02;
+constexpr double kTStartSec = 0.04;        // T波搜索从J点后开始
+constexpr double kTMaxSec = 0.60;          // T波窗口上限 (R波后)
+constexpr double kTMinSec = 0.25;
+constexpr double kTRRFraction = 0.65;      // T波窗口不超过R-R的65%, 避开下一个P波
+constexpr double kStOffsetSec = 0.06;      // ST测量点: J点后60ms
+
+// 幅度/斜率的相对阈值
+constexpr double kQrsSlopeFraction = 0.10;   // 相对QRS最大斜率
+constexpr double kPAmplitudeFraction = 0.06; // P波幅度至少为R波的6%
+constexpr double kTAmplitudeFraction = 0.03;
+
+double tWindowSec(double rrInterval)
+{
+    if (rrInterval <= 0.0) return kTMaxSec;
+    return qBound(kTMinSec, kTRRFraction * rrInterval, kTMaxSec);
+}
+
+int smoothHalf(int sampleRate, double windowSec = kSmoothSec)
+{
+    return qMax(1, qRound(windowSec * sampleRate / 2.0));
+}
+
+// 居中滑动平均 (窗口两端截断) 及其中心差分斜率
+void smoothWithSlope(const double* data, int count, int half, QVector<double>& s, QVector<double>& d)
+{
+    s.resize(count);
+    double acc = 0.0;
+    int accLo = 0;
+    int accHi = -1;
+    for (int i = 0; i < count; ++i) {
+        int lo = qMax(0, i - half);
+        int hi = qMin(count - 1, i + half);
+        while (accHi < hi) acc += data[++accHi];
+        while (accLo < lo) acc -= data[accLo++];
+        s[i] = acc / (accHi - accLo + 1);
+    }
+    d.fill(0.0, count);
+    for (int i = 1; i < count - 1; ++i) {
+        d[i] = 0.5 * (s[i + 1] - s[i - 1]);
+    }
+}
+
+// 切线法: 过斜率最大点作切线, 与等电位线的交点, 限制在 [lo, hi]
+double tangentIntercept(const QVector<double>& s, const QVector<double>& d, int m,
+                        double baseline, int lo, int hi)
+{
+    if (d[m] == 0.0) return m;
+    return qBound(static_cast<double>(lo), m + (baseline - s[m]) / d[m], static_cast<double>(hi));
+}
+
+int toSamples(double seconds, int sampleRate)
+{
+    return qMax(1, qRound(seconds * sampleRate));
+}
+
+} // namespace
+
+namespace EcgDelineator {
+
+int samplesBefore(int sampleRate)
+{
+    return toSamples(kQrsOnsetSec + kBaselineSearchSec + kPSearchSec, sampleRate)
+           + smoothHalf(sampleRate, kWaveSmoothSec) + 2;
+}
+
+int samplesAfter(int sampleRate, double rrInterval)
+{
+    return toSamples(tWindowSec(rrInterval), sampleRate) + smoothHalf(sampleRate, kWaveSmoothSec) + 2;
+}
+
+BeatInfo delineate(const RPeakInfo& peak, const double* data, int count,
+                   int startIndex, int sampleRate, Workspace& work)
+{
+    BeatInfo beat;
+    static_cast<RPeakInfo&>(beat) = peak;
+
+    const int r = peak.sampleIndex - startIndex;
+    if (r < 1 || r >= count - 1) return beat;
+
+    // ---- 平滑与斜率, 均在本地窗口内: 窄窗用于QRS, 宽窗用于P/T波 ----
+    QVector<double>& s = work.smooth;
+    QVector<double>& d = work.slope;
+    QVector<double>& sw = work.waveSmooth;
+    QVector<double>& dw = work.waveSlope;
+    smoothWithSlope(data, count, smoothHalf(sampleRate), s, d);
+    smoothWithSlope(data, count, smoothHalf(sampleRate, kWaveSmoothSec), sw, dw);
+
+    auto ms = [sampleRate](double samples) { return samples * 1000.0 / sampleRate; };
+
+    // ---- QRS: R波两侧斜率包络超过阈值的连续区域 ----
+    const int slopeReach = toSamples(kSlopeSearchSec, sampleRate);
+    double maxSlope = 0.0;
+    for (int i = qMax(1, r - slopeReach); i <= qMin(count - 2, r + slopeReach); ++i) {
+        maxSlope = qMax(maxSlope, qAbs(d[i]));
+    }
+    if (maxSlope <= 0.0) return beat;
+    const double slopeThr = kQrsSlopeFraction * maxSlope;
+    const int gap = toSamples(kQrsGapSec, sampleRate);
+
+    int onset = r;
+    for (int i = r, below = 0; i >= qMax(1, r - toSamples(kQrsOnsetSec, sampleRate)); --i) {
+        if (qAbs(d[i]) >= slopeThr) {
+            onset = i;
+            below = 0;
+        } else if (++below > gap) {
+            break;
+        }
+    }
+    int offset = r;
+    for (int i = r, below = 0; i <= qMin(count - 2, r + toSamples(kQrsOffsetSec, sampleRate)); ++i) {
+        if (qAbs(d[i]) >= slopeThr) {
+            offset = i;
+            below = 0;
+        } else if (++below > gap) {
+            break;
+        }
+    }
+    beat.qrsOnset = startIndex + onset;
+    beat.qrsOffset = startIndex + offset;
+    beat.qrsWidthMs = ms(offset - onset);
+
+    // ---- 等电位线: QRS起点前斜率最平坦的20ms段 ----
+    const int baseWin = toSamples(kBaselineWindowSec, sampleRate);
+    int baseStart = qMax(1, onset - toSamples(kBaselineSearchSec, sampleRate));
+    int baseEnd = onset - baseWin;  // 窗口起点上限
+    double baseline = s[qMax(0, onset - 1)];
+    if (baseEnd >= baseStart) {
+        double flat = 0.0;
+        for (int i = baseStart; i < baseStart + baseWin; ++i) flat += qAbs(d[i]);
+        double bestFlat = flat;
+        int best = baseStart;
+        for (int k = baseStart + 1; k <= baseEnd; ++k) {
+            flat += qAbs(d[k + baseWin - 1]) - qAbs(d[k - 1]);
+            if (flat < bestFlat) {
+                bestFlat = flat;
+                best = k;
+            }
+        }
+        double sum = 0.0;
+        for (int i = best; i < best + baseWin; ++i) sum += s[i];
+        baseline = sum / baseWin;
+    }
+    const double rAmplitude = qAbs(s[r] - baseline);
+
+    // ---- P波: QRS起点前窗口内相对等电位线的最大偏移, 起点取上升支切线与等电位线交点 ----
+    double pSearch = kPSearchSec;
+    if (peak.rrInterval > 0.0) pSearch = qMin(pSearch, kPRRFraction * peak.rrInterval);
+    int pEnd = onset - toSamples(kPGapSec, sampleRate);
+    int pStart = qMax(1, onset - toSamples(pSearch, sampleRate));
+    if (pEnd > pStart) {
+        int pIdx = pStart;
+        for (int i = pStart; i <= pEnd; ++i) {
+            if (qAbs(sw[i] - baseline) > qAbs(sw[pIdx] - baseline)) pIdx = i;
+        }
+        double pDev = sw[pIdx] - baseline;
+        if (qAbs(pDev) > kPAmplitudeFraction * rAmplitude && pIdx > pStart) {
+            double sign = pDev > 0.0 ? 1.0 : -1.0;
+            int m = pStart;
+            for (int i = pStart; i < pIdx; ++i) {
+                if (sign * dw[i] > sign * dw[m]) m = i;
+            }
+            double pOnset = tangentIntercept(sw, dw, m, baseline, pStart, pIdx);
+            beat.pPeak = startIndex + pIdx;
+            beat.pOnset = startIndex + qRound(pOnset);
+            beat.prIntervalMs = ms(onset - pOnset);
+        }
+    }
+
+    // ---- T波: J点之后的最大偏移, 终点取下降支最大斜率处切线与等电位线的交点 ----
+    int tStart = offset + toSamples(kTStartSec, sampleRate);
+    int tStop = qMin(count - 2, r + toSamples(tWindowSec(peak.rrInterval), sampleRate));
+    if (tStop > tStart) {
+        int tIdx = tStart;
+        for (int i = tStart; i <= tStop; ++i) {
+            if (qAbs(sw[i] - baseline) > qAbs(sw[tIdx] - baseline)) tIdx = i;
+        }
+        double tDev = sw[tIdx] - baseline;
+        if (qAbs(tDev) > kTAmplitudeFraction * rAmplitude && tIdx < tStop) {
+            // 直立T波下降支斜率为负, 倒置T波为正
+            double sign = tDev > 0.0 ? -1.0 : 1.0;
+            int m = tIdx + 1;
+            for (int i = tIdx + 1; i <= tStop; ++i) {
+                if (sign * dw[i] > sign * dw[m]) m = i;
+            }
+            double tEnd = tangentIntercept(sw, dw, m, baseline, m, tStop);
+            beat.tPeak = startIndex + tIdx;
+            beat.tEnd = startIndex + qRound(tEnd);
+            beat.qtIntervalMs = ms(tEnd - onset);
+            if (peak.rrInterval > 0.0) {
+                beat.qtcMs = beat.qtIntervalMs / qSqrt(peak.rrInterval);
+            }
+        }
+    }
+
+    // ---- ST: J点后60ms ----
+    int stIdx = offset + toSamples(kStOffsetSec, sampleRate);
+    if (stIdx < count) {
+        beat.stLevel = s[stIdx] - baseline;
+    }
+
+    return beat;
+}
+
+} // namespace EcgDelineator
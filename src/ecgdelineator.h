@@ -0,0 +1,26 @@
+#pragma once
+#include <QVector>
+#include "qrsdetector.h"
+
+// 心搏特征点定位: 只在R波前后的固定小窗口内, 基于平滑信号及其斜率
+// 确定 P波、QRS起止点 (斜率包络) 和 T波终点 (切线法), 每搏代价与记录长度无关
+namespace EcgDelineator {
+
+// 定位所需的R波前/后样本数; T波窗口随R-R缩短, rrInterval<=0 时取最大窗口
+int samplesBefore(int sampleRate);
+int samplesAfter(int sampleRate, double rrInterval);
+
+// 定位用的平滑/斜率暂存, 逐搏复用 (容量按窗口长度增长一次后不再分配)
+struct Workspace {
+    QVector<double> smooth;
+    QVector<double> slope;
+    QVector<double> waveSmooth;
+    QVector<double> waveSlope;
+};
+
+// data[0] 对应全局样本索引 startIndex, 应覆盖 [R - samplesBefore, R + samplesAfter],
+// 不足部分按已有数据截断; 返回的特征点为全局样本索引
+BeatInfo delineate(const RPeakInfo& peak, const double* data, int count,
+                   int startIndex, int sampleRate, Workspace& work);
+
+} // namespace EcgDelineator
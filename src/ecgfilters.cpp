@@ -0,0 +1,84 @@
+#include "ecgfilters.h"
+#include <algorithm>
+
+namespace EcgFilters {
+
+void biquadBlock(const BiquadCoeffs& c, double* data, int count)
+{
+    if (count <= 0) return;
+
+    // 稳态初值: 常数输入 x0 对应输出 G*x0, G 为直流增益
+    double x0 = data[0];
+    double denom = 1.0 + c.b1 + c.b2;
+    double gain = qFuzzyIsNull(denom) ? 0.0 : (c.a0 + c.a1 + c.a2) / denom;
+    double y0 = gain * x0;
+    double z2 = c.a2 * x0 - c.b2 * y0;
+    double z1 = y0 - c.a0 * x0;
+
+    const double a0 = c.a0, a1 = c.a1, a2 = c.a2, b1 = c.b1, b2 = c.b2;
+    for (int i = 0; i < count; ++i) {
+        double x = data[i];
+        double y = a0 * x + z1;
+        z1 = a1 * x - b1 * y + z2;
+        z2 = a2 * x - b2 * y;
+        data[i] = y;
+    }
+}
+
+void filtfilt(const BiquadCoeffs& c, QVector<double>& data)
+{
+    const int n = data.size();
+    if (n < 2) return;
+
+    // 奇对称延拓: 2*x[0] - x[k], 2*x[n-1] - x[n-1-k]
+    // 延拓长度取 3 × 系数个数, 与 scipy.signal.filtfilt 默认值一致
+    const int pad = qMin(n - 1, 3 * 3);
+    QVector<double> ext(n + 2 * pad);
+    double* e = ext.data();
+    for (int k = 0; k < pad; ++k) {
+        e[k] = 2.0 * data[0] - data[pad - k];
+        e[pad + n + k] = 2.0 * data[n - 1] - data[n - 2 - k];
+    }
+    std::copy(data.constBegin(), data.constEnd(), e + pad);
+
+    biquadBlock(c, e, ext.size());
+    std::reverse(ext.begin(), ext.end());
+    biquadBlock(c, e, ext.size());
+    std::reverse(ext.begin(), ext.end());
+
+    std::copy(e + pad, e + pad + n, data.begin());
+}
+
+QVector<double> centralDerivative(const QVector<double>& data)
+{
+    const int n = data.size();
+    QVector<double> out(n, 0.0);
+    const double* x = data.constData();
+    double* y = out.data();
+    for (int i = 2; i < n - 2; ++i) {
+        y[i] = (-x[i - 2] - 2.0 * x[i - 1] + 2.0 * x[i + 1] + x[i + 2]) / 8.0;
+    }
+    return out;
+}
+
+QVector<double> centeredMovingAverage(const QVector<double>& data, int window)
+{
+    const int n = data.size();
+    window = qMax(1, window);
+    QVector<double> prefix(n + 1, 0.0);
+    for (int i = 0; i < n; ++i) {
+        prefix[i + 1] = prefix[i] + data[i];
+    }
+
+    // 与实时路径一致, 除以完整窗口长度
+    QVector<double> out(n);
+    const int half = window / 2;
+    for (int i = 0; i < n; ++i) {
+        int lo = qMax(0, i - half);
+        int hi = qMin(n, i - half + window);
+        out[i] = (prefix[hi] - prefix[lo]) / window;
+    }
+    return out;
+}
+
+} // namespace EcgFilters
@@ -0,0 +1,87 @@
+#pragma once
+#include <QtMath>
+#include <QVector>
+
+// 二阶IIR (biquad) 系数, 沿用 RPeakDetector 的命名:
+// y[n] = a0*x[n] + a1*x[n-1] + a2*x[n-2] - b1*y[n-1] - b2*y[n-2]
+struct BiquadCoeffs {
+    double a0 = 1.0;
+    double a1 = 0.0;
+    double a2 = 0.0;
+    double b1 = 0.0;
+    double b2 = 0.0;
+};
+
+namespace EcgFilters {
+
+// 可在编译期求值的 tan (正弦/余弦泰勒级数, 适用于 |x| < π/2),
+// 使固定采样率下的滤波系数成为编译期常量
+constexpr double constexprTan(double x)
+{
+    double sinTerm = x;
+    double sinSum = x;
+    double cosTerm = 1.0;
+    double cosSum = 1.0;
+    const double x2 = x * x;
+    for (int n = 1; n <= 30; ++n) {
+        sinTerm *= -x2 / ((2.0 * n) * (2.0 * n + 1.0));
+        cosTerm *= -x2 / ((2.0 * n - 1.0) * (2.0 * n));
+        sinSum += sinTerm;
+        cosSum += cosTerm;
+    }
+    return sinSum / cosSum;
+}
+
+// 二阶Butterworth低通, 预翘曲双线性变换
+constexpr BiquadCoeffs butterworthLowpass(double cutoffHz, int sampleRate)
+{
+    double w = constexprTan(M_PI * cutoffHz / sampleRate);
+    double w2 = w * w;
+    double k = 1.0 / (1.0 + M_SQRT2 * w + w2);
+
+    BiquadCoeffs c;
+    c.a0 = w2 * k;
+    c.a1 = 2.0 * c.a0;
+    c.a2 = c.a0;
+    c.b1 = 2.0 * (w2 - 1.0) * k;
+    c.b2 = (1.0 - M_SQRT2 * w + w2) * k;
+    return c;
+}
+
+// 二阶Butterworth高通, 预翘曲双线性变换
+constexpr BiquadCoeffs butterworthHighpass(double cutoffHz, int sampleRate)
+{
+    double w = constexprTan(M_PI * cutoffHz / sampleRate);
+    double w2 = w * w;
+    double k = 1.0 / (1.0 + M_SQRT2 * w + w2);
+
+    BiquadCoeffs c;
+    c.a0 = k;
+    c.a1 = -2.0 * k;
+    c.a2 = k;
+    c.b1 = 2.0 * (w2 - 1.0) * k;
+    c.b2 = (1.0 - M_SQRT2 * w + w2) * k;
+    return c;
+}
+
+// Pan-Tompkins 带通 (5-15Hz) 的两级截止频率
+constexpr double kQrsBandLowHz = 5.0;
+constexpr double kQrsBandHighHz = 15.0;
+
+// ============================================================
+// 整段数据块运算 (离线分析用), 均在连续数组上原地或一次性处理
+// ============================================================
+
+// 单向biquad滤波 (转置直接II型), 以首样本的稳态作为初始条件
+void biquadBlock(const BiquadCoeffs& c, double* data, int count);
+
+// 前向-后向零相位滤波, 两端奇对称延拓以抑制边界暂态
+void filtfilt(const BiquadCoeffs& c, QVector<double>& data);
+
+// 非因果五点中心微分: y[n] = (-x[n-2] - 2x[n-1] + 2x[n+1] + x[n+2]) / 8
+QVector<double> centralDerivative(const QVector<double>& data);
+
+// 居中滑动平均 (前缀和实现), 窗口在两端截断
+QVector<double> centeredMovingAverage(const QVector<double>& data, int window);
+
+} // namespace EcgFilters
@@ -0,0 +1,122 @@
+#include "ecgreport.h"
+#include <QMessageBox>
+
+namespace EcgReport {
+
+QString toHtml(const QrsDetector::AnalysisReport& report)
+{
+    QString html;
+    html += QStringLiteral("<h2 style='color:#00d9ff;'>ECG R波分析报告</h2>");
+    html += QStringLiteral("<hr>");
+
+    // 基本信息
+    html += QStringLiteral("<h3>基本信息</h3>");
+    html += QStringLiteral("<table cellpadding='4'>");
+    html += QStringLiteral("<tr><td><b>检测到R波数:</b></td><td>%1 个</td></tr>").arg(report.totalPeaks);
+    html += QStringLiteral("<tr><td><b>分析时长:</b></td><td>%1 秒</td></tr>").arg(report.durationSeconds, 0, 'f', 1);
+    html += QStringLiteral("</table>");
+
+    // 心率统计
+    html += QStringLiteral("<h3>心率统计</h3>");
+    html += QStringLiteral("<table cellpadding='4'>");
+    html += QStringLiteral("<tr><td><b>平均心率:</b></td><td>%1 bpm</td></tr>").arg(report.avgHR, 0, 'f', 1);
+    html += QStringLiteral("<tr><td><b>最低心率:</b></td><td>%1 bpm</td></tr>").arg(report.minHR, 0, 'f', 1);
+    html += QStringLiteral("<tr><td><b>最高心率:</b></td><td>%1 bpm</td></tr>").arg(report.maxHR, 0, 'f', 1);
+    html += QStringLiteral("<tr><td><b>心率标准差:</b></td><td>%1 bpm</td></tr>").arg(report.stdHR, 0, 'f', 2);
+    html += QStringLiteral("</table>");
+
+    // R-R间期
+    html += QStringLiteral("<h3>R-R间期分析</h3>");
+    html += QStringLiteral("<table cellpadding='4'>");
+    html += QStringLiteral("<tr><td><b>平均R-R间期:</b></td><td>%1 ms</td></tr>").arg(report.avgRR, 0, 'f', 1);
+    html += QStringLiteral("<tr><td><b>最短R-R间期:</b></td><td>%1 ms</td></tr>").arg(report.minRR, 0, 'f', 1);
+    html += QStringLiteral("<tr><td><b>最长R-R间期:</b></td><td>%1 ms</td></tr>").arg(report.maxRR, 0, 'f', 1);
+    html += QStringLiteral("<tr><td><b>R-R间期标准差:</b></td><td>%1 ms</td></tr>").arg(report.stdRR, 0, 'f', 2);
+    html += QStringLiteral("</table>");
+
+    // HRV指标
+    html += QStringLiteral("<h3>心率变异性 (HRV)</h3>");
+    html += QStringLiteral("<table cellpadding='4'>");
+    html += QStringLiteral("<tr><td><b>SDNN:</b></td><td>%1 ms</td><td style='color:#8892b0;'>R-R间期标准差</td></tr>").arg(report.sdnn, 0, 'f', 2);
+    html += QStringLiteral("<tr><td><b>RMSSD:</b></td><td>%1 ms</td><td style='color:#8892b0;'>相邻R-R差值均方根</td></tr>").arg(report.rmssd, 0, 'f', 2);
+    html += QStringLiteral("<tr><td><b>pNN50:</b></td><td>%1 %</td><td style='color:#8892b0;'>差值>50ms的百分比</td></tr>").arg(report.pnn50, 0, 'f', 1);
+    html += QStringLiteral("</table>");
+
+    // R波幅值
+    html += QStringLiteral("<h3>R波幅值</h3>");
+    html += QStringLiteral("<table cellpadding='4'>");
+    html += QStringLiteral("<tr><td><b>平均幅值:</b></td><td>%1 mV</td></tr>").arg(report.avgAmplitude, 0, 'f', 1);
+    html += QStringLiteral("<tr><td><b>最小幅值:</b></td><td>%1 mV</td></tr>").arg(report.minAmplitude, 0, 'f', 1);
+    html += QStringLiteral("<tr><td><b>最大幅值:</b></td><td>%1 mV</td></tr>").arg(report.maxAmplitude, 0, 'f', 1);
+    html += QStringLiteral("</table>");
+
+    // 波形间期 (有定位结果时才显示)
+    if (report.delineatedBeats > 0) {
+        html += QStringLiteral("<h3>波形间期</h3>");
+        html += QStringLiteral("<table cellpadding='4'>");
+        html += QStringLiteral("<tr><td><b>QRS宽度:</b></td><td>%1 ms</td></tr>").arg(report.avgQrsWidth, 0, 'f', 0);
+        html += QStringLiteral("<tr><td><b>PR间期:</b></td><td>%1 ms</td></tr>").arg(report.avgPR, 0, 'f', 0);
+        html += QStringLiteral("<tr><td><b>QT间期:</b></td><td>%1 ms</td></tr>").arg(report.avgQT, 0, 'f', 0);
+        html += QStringLiteral("<tr><td><b>QTc:</b></td><td>%1 ms</td><td style='color:#8892b0;'>Bazett校正</td></tr>").arg(report.avgQTc, 0, 'f', 0);
+        html += QStringLiteral("<tr><td><b>ST偏移:</b></td><td>%1 mV</td><td style='color:#8892b0;'>J点后60ms</td></tr>").arg(report.avgST, 0, 'f', 1);
+        html += QStringLiteral("<tr><td><b>已定位心搏:</b></td><td>%1 个</td></tr>").arg(report.delineatedBeats);
+        html += QStringLiteral("</table>");
+    }
+
+    // 医学评估
+    html += QStringLiteral("<h3 style='color:#f39c12;'>医学评估</h3>");
+    for (const QString& finding : report.findings) {
+        QString color = "#2ecc71";  // 绿色=正常
+        if (finding.contains(QStringLiteral("过缓")) || finding.contains(QStringLiteral("过速")) ||
+            finding.contains(QStringLiteral("早搏")) || finding.contains(QStringLiteral("不齐")) ||
+            finding.contains(QStringLiteral("偏低")) || finding.contains(QStringLiteral("变异较大")) ||
+            finding.contains(QStringLiteral("增宽")) || finding.contains(QStringLiteral("延长"))) {
+            color = "#e74c3c";  // 红色=异常
+        }
+        html += QStringLiteral("<p style='color:%1;'>%2</p>").arg(color, finding);
+    }
+
+    // 建议
+    html += QStringLiteral("<h3 style='color:#3498db;'>建议</h3>");
+    for (const QString& suggestion : report.suggestions) {
+        html += QStringLiteral("<p>%1</p>").arg(suggestion);
+    }
+
+    html += QStringLiteral("<hr><p style='color:#8892b0; font-size:11px;'>"
+                           "注: 本分析仅供参考，不构成医学诊断。如有异常请咨询专业医生。</p>");
+
+    return html;
+}
+
+void show(QWidget* parent, const QrsDetector::AnalysisReport& report)
+{
+    // 使用QMessageBox显示报告
+    QMessageBox msgBox(parent);
+    msgBox.setWindowTitle(QStringLiteral("ECG R波分析报告"));
+    msgBox.setTextFormat(Qt::RichText);
+    msgBox.setText(toHtml(report));
+    msgBox.setStyleSheet(R"(
+        QMessageBox {
+            background-color: #1a1a2e;
+        }
+        QMessageBox QLabel {
+            color: #eaeaea;
+            min-width: 480px;
+            min-height: 400px;
+        }
+        QPushButton {
+            background-color: #1f4068;
+            color: white;
+            border: none;
+            border-radius: 6px;
+            padding: 8px 24px;
+            font-weight: bold;
+        }
+        QPushButton:hover {
+            background-color: #2a5a8c;
+        }
+    )");
+    msgBox.exec();
+}
+
+} // namespace EcgReport
@@ -0,0 +1,13 @@
+#pragma once
+#include <QString>
+#include "qrsdetector.h"
+
+class QWidget;
+
+// ECG R波分析报告的格式化与显示 (实时监测与历史记录分析共用)
+namespace EcgReport {
+
+QString toHtml(const QrsDetector::AnalysisReport& report);
+void show(QWidget* parent, const QrsDetector::AnalysisReport& report);
+
+} // namespace EcgReport
@@ -0,0 +1,180 @@
+#include "ecgresampler.h"
+#include <QtMath>
+#include <numeric>
+
+namespace {
+
+// 每侧保留的sinc过零点数, 决定过渡带宽度
+constexpr int kZeroCrossings = 8;
+// Kaiser窗参数, 约 60dB 阻带衰减
+constexpr double kKaiserBeta = 5.65;
+
+// 第一类零阶修正Bessel函数 (级数展开)
+double besselI0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+    double halfX = x / 2.0;
+    for (int k = 1; k < 32; ++k) {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+        if (term < sum * 1e-12) break;
+    }
+    return sum;
+}
+
+} // namespace
+
+EcgResampler::EcgResampler()
+{
+    setRates(200, 200);
+}
+
+EcgResampler::EcgResampler(int inputRate, int outputRate)
+{
+    setRates(inputRate, outputRate);
+}
+
+void EcgResampler::setRates(int inputRate, int outputRate)
+{
+    m_inputRate = qMax(1, inputRate);
+    m_outputRate = qMax(1, outputRate);
+
+    int g = std::gcd(m_inputRate, m_outputRate);
+    m_up = m_outputRate / g;
+    m_down = m_inputRate / g;
+
+    designFilter();
+    reset();
+}
+
+void EcgResampler::reset()
+{
+    m_buffer.fill(0.0, m_tapsPerPhase - 1);
+    m_nextPosition = 0;
+}
+
+double EcgResampler::delaySamples() const
+{
+    if (isPassthrough()) return 0.0;
+    return (m_filterLength - 1) / 2.0 / m_down;
+}
+
+// ============================================================
+// 原型低通FIR: Kaiser窗sinc, 截止频率取 min(输入, 输出) 奈奎斯特频率的90%
+// 在上采样后的采样率 (inputRate * L) 下设计, 增益乘以 L 补偿零值插入
+// ============================================================
+
+void EcgResampler::designFilter()
+{
+    if (isPassthrough()) {
+        m_tapsPerPhase = 1;
+        m_filterLength = 1;
+        m_bank = QVector<double>{1.0};
+        return;
+    }
+
+    int factor = qMax(m_up, m_down);
+    double cutoff = 0.9 * 0.5 / factor;  // 归一化到上采样率 (cycles/sample)
+
+    m_filterLength = 2 * kZeroCrossings * factor + 1;
+    m_tapsPerPhase = (m_filterLength + m_up - 1) / m_up;
+
+    QVector<double> prototype(m_tapsPerPhase * m_up, 0.0);
+    double center = (m_filterLength - 1) / 2.0;
+    double norm = besselI0(kKaiserBeta);
+    for (int n = 0; n < m_filterLength; ++n) {
+        double t = n - center;
+        double sinc = (t == 0.0) ? 2.0 * cutoff
+                                 : qSin(2.0 * M_PI * cutoff * t) / (M_PI * t);
+        double r = t / center;
+        double window = besselI0(kKaiserBeta * qSqrt(qMax(0.0, 1.0 - r * r))) / norm;
+        prototype[n] = sinc * window * m_up;
+    }
+
+    // 拆分为多相子滤波器: phase p 的第 j 个系数为 h[p + j*L], 组内逆序存放
+    m_bank.fill(0.0, m_up * m_tapsPerPhase);
+    for (int p = 0; p < m_up; ++p) {
+        double* phase = m_bank.data() + p * m_tapsPerPhase;
+        for (int j = 0; j < m_tapsPerPhase; ++j) {
+            phase[m_tapsPerPhase - 1 - j] = prototype[p + j * m_up];
+        }
+    }
+}
+
+// 4路累加展开, 无分支, 便于编译器自动向量化 (SSE2/AVX/NEON)
+double EcgResampler::dotProduct(const double* a, const double* b, int n)
+{
+    double acc0 = 0.0, acc1 = 0.0, acc2 = 0.0, acc3 = 0.0;
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc0 += a[i] * b[i];
+        acc1 += a[i + 1] * b[i + 1];
+        acc2 += a[i + 2] * b[i + 2];
+        acc3 += a[i + 3] * b[i + 3];
+    }
+    for (; i < n; ++i) {
+        acc0 += a[i] * b[i];
+    }
+    return (acc0 + acc1) + (acc2 + acc3);
+}
+
+QVector<double> EcgResampler::process(const QVector<double>& input)
+{
+    QVector<double> output;
+    process(input.constData(), input.size(), output);
+    return output;
+}
+
+void EcgResampler::process(const double* input, int count, QVector<double>& output)
+{
+    if (count <= 0) return;
+
+    if (isPassthrough()) {
+        output.reserve(output.size() + count);
+        for (int i = 0; i < count; ++i) output.append(input[i]);
+        return;
+    }
+
+    const int history = m_tapsPerPhase - 1;
+    m_buffer.resize(history + count);
+    std::copy(input, input + count, m_buffer.begin() + history);
+
+    const double* buf = m_buffer.constData();
+    const qint64 blockEnd = static_cast<qint64>(count) * m_up;
+    output.reserve(output.size() + static_cast<int>((blockEnd - m_nextPosition) / m_down) + 1);
+
+    // 输出点位置 pos 对应输入样本 k = pos / L, 相位 p = pos % L
+    while (m_nextPosition < blockEnd) {
+        int k = static_cast<int>(m_nextPosition / m_up);
+        int p = static_cast<int>(m_nextPosition % m_up);
+        output.append(dotProduct(m_bank.constData() + p * m_tapsPerPhase, buf + k, m_tapsPerPhase));
+        m_nextPosition += m_down;
+    }
+    m_nextPosition -= blockEnd;
+
+    // 保留最后 history 个输入作为下一块的历史
+    std::copy(m_buffer.end() - history, m_buffer.end(), m_buffer.begin());
+    m_buffer.resize(history);
+}
+
+QVector<double> EcgResampler::resample(const QVector<double>& input, int inputRate, int outputRate)
+{
+    EcgResampler resampler(inputRate, outputRate);
+    if (resampler.isPassthrough()) return input;
+
+    // 首个输出点对齐到滤波器中心 (消除群延迟), 尾部补最后一个值冲出滤波器
+    resampler.m_nextPosition = (resampler.m_filterLength - 1) / 2;
+    int expected = static_cast<int>(static_cast<qint64>(input.size()) * outputRate / inputRate);
+
+    QVector<double> padded = input;
+    int padInput = resampler.m_filterLength / resampler.m_up + 1;
+    padded.resize(input.size() + padInput);
+    std::fill(padded.begin() + input.size(), padded.end(), input.isEmpty() ? 0.0 : input.last());
+
+    QVector<double> output = resampler.process(padded);
+    if (output.size() > expected) {
+        output.resize(expected);
+    }
+    return output;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <QVector>
+
+// 多相有理数重采样器: 将设备采样率 (125/250/360/500/1000Hz 等) 转换为处理流水线采样率
+// 采样率比 L/M 约分后, 原型低通FIR按相位拆分为 L 组子滤波器, 每个输出点只计算一组点积
+class EcgResampler {
+public:
+    EcgResampler();
+    EcgResampler(int inputRate, int outputRate);
+
+    void setRates(int inputRate, int outputRate);
+    int inputRate() const { return m_inputRate; }
+    int outputRate() const { return m_outputRate; }
+
+    int interpolation() const { return m_up; }    // L
+    int decimation() const { return m_down; }     // M
+    int tapsPerPhase() const { return m_tapsPerPhase; }
+    bool isPassthrough() const { return m_up == m_down; }
+
+    // 群延迟 (输出样本数)
+    double delaySamples() const;
+
+    // 流式处理: 输入任意长度数据块, 返回本块可产生的输出样本
+    QVector<double> process(const QVector<double>& input);
+    void process(const double* input, int count, QVector<double>& output);
+
+    void reset();
+
+    // 离线整段重采样
+    static QVector<double> resample(const QVector<double>& input, int inputRate, int outputRate);
+
+private:
+    void designFilter();
+    static double dotProduct(const double* a, const double* b, int n);
+
+    int m_inputRate = 200;
+    int m_outputRate = 200;
+    int m_up = 1;
+    int m_down = 1;
+    int m_tapsPerPhase = 1;
+    int m_filterLength = 1;
+
+    // 多相系数: m_up 组, 每组 m_tapsPerPhase 个, 组内逆序存放以便与输入缓冲顺序点积
+    QVector<double> m_bank;
+
+    // 输入缓冲: 前 (m_tapsPerPhase - 1) 个为上一块留下的历史
+    QVector<double> m_buffer;
+
+    // 下一个输出点在上采样网格中的位置 (相对当前块首个输入样本, 单位 1/L 输入样本)
+    qint64 m_nextPosition = 0;
+};
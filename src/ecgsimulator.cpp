@@ -0,0 +1,163 @@
+#include "ecgsimulator.h"
+#include <QtMath>
+
+namespace {
+
+// 室性早搏: 联律间期为基础R-R的65%, 其后完全代偿间歇 (两搏之和为2倍基础R-R)
+constexpr double kPrematureRatio = 0.65;
+constexpr double kCompensatoryRatio = 2.0 - kPrematureRatio;
+
+// 房颤: R-R近似独立同分布, 变异系数约20%
+constexpr double kAfRRVariation = 0.20;
+
+// 正常窦性搏动 P-QRS-T, tau 为距心动周期起点的时间 (秒)
+// QRS宽度固定, T波按Bazett规律随 sqrt(R-R) 伸缩; R-R=1s 时与原模拟波形完全一致
+double normalBeat(double tau, double rr, bool pWave)
+{
+    // P波 (0.02 - 0.12s): 心房去极化
+    if (tau >= 0.02 && tau < 0.12) return pWave ? 30.0 * qSin(M_PI * (tau - 0.02) / 0.10) : 0.0;
+    // Q波 (0.15 - 0.17s): QRS起始向下偏转
+    if (tau >= 0.15 && tau < 0.17) return -40.0 * qSin(M_PI * (tau - 0.15) / 0.02);
+    // R波 (0.17 - 0.21s): 主峰, 尖锐向上
+    if (tau >= 0.17 && tau < 0.21) return 250.0 * qSin(M_PI * (tau - 0.17) / 0.04);
+    // S波 (0.21 - 0.24s): QRS末尾向下
+    if (tau >= 0.21 && tau < 0.24) return -60.0 * qSin(M_PI * (tau - 0.21) / 0.03);
+
+    // T波: 心室复极化, 较宽
+    double s = qSqrt(rr);
+    double tStart = 0.24 + 0.06 * s;
+    double tWidth = 0.20 * s;
+    if (tau >= tStart && tau < tStart + tWidth) return 50.0 * qSin(M_PI * (tau - tStart) / tWidth);
+    return 0.0;
+}
+
+// 室性早搏: 无P波, QRS宽大畸形, T波倒置; R峰与正常搏动同在 kROffset 处
+double ectopicBeat(double tau)
+{
+    if (tau >= 0.14 && tau < 0.24) return 220.0 * qSin(M_PI * (tau - 0.14) / 0.10);
+    if (tau >= 0.24 && tau < 0.30) return -140.0 * qSin(M_PI * (tau - 0.24) / 0.06);
+    if (tau >= 0.36 && tau < 0.58) return -70.0 * qSin(M_PI * (tau - 0.36) / 0.22);
+    return 0.0;
+}
+
+} // namespace
+
+EcgSimulator::EcgSimulator()
+{
+    reset();
+}
+
+EcgSimulator::EcgSimulator(const Config& config)
+    : m_config(config)
+{
+    reset();
+}
+
+void EcgSimulator::setConfig(const Config& config)
+{
+    m_config = config;
+    reset();
+}
+
+void EcgSimulator::reset()
+{
+    m_rng.seed(m_config.seed != 0 ? m_config.seed : QRandomGenerator::global()->generate());
+    m_sampleIndex = 0;
+    m_beat = Beat();
+    m_nextEctopic = false;
+    m_rPeakTimes.clear();
+    m_ectopicFlags.clear();
+    startBeat(0.0);
+}
+
+double EcgSimulator::gaussian()
+{
+    // Box-Muller
+    double u1 = qMax(1e-12, m_rng.generateDouble());
+    double u2 = m_rng.generateDouble();
+    return qSqrt(-2.0 * qLn(u1)) * qCos(2.0 * M_PI * u2);
+}
+
+void EcgSimulator::startBeat(double startTime)
+{
+    double baseRR = 60.0 / qBound(20.0, m_config.heartRate, 250.0);
+    double rr = baseRR;
+    if (m_config.atrialFibrillation) {
+        rr *= 1.0 + kAfRRVariation * gaussian();
+        rr = qBound(0.5 * baseRR, rr, 1.6 * baseRR);
+    } else if (m_config.hrVariability > 0.0) {
+        rr *= 1.0 + m_config.hrVariability * gaussian();
+        rr = qBound(0.5 * baseRR, rr, 1.5 * baseRR);
+    }
+
+    m_prevBeat = m_beat;
+    m_beat.start = startTime;
+    m_beat.ectopic = m_nextEctopic;
+    m_beat.pWave = !m_config.atrialFibrillation;
+
+    // 早搏出现与否在前一搏开始时决定, 以缩短前一搏的R-R
+    if (m_beat.ectopic) {
+        rr = kCompensatoryRatio * baseRR;
+        m_nextEctopic = false;
+    } else if (m_config.ectopicRate > 0.0 && m_rng.generateDouble() < m_config.ectopicRate) {
+        rr = kPrematureRatio * baseRR;
+        m_nextEctopic = true;
+    }
+    m_beat.rr = qMax(0.25, rr);
+
+    if (m_config.recordGroundTruth) {
+        m_rPeakTimes.append(startTime + kROffset);
+        m_ectopicFlags.append(m_beat.ectopic);
+    }
+}
+
+EcgSimulator::BeatTiming EcgSimulator::normalBeatTiming(double rr)
+{
+    // 与 normalBeat 的分段一致: P起点0.02, Q起点0.15, S终点0.24, T终点 0.24 + 0.26*sqrt(RR)
+    BeatTiming timing;
+    timing.qrsWidth = 0.24 - 0.15;
+    timing.prInterval = 0.15 - 0.02;
+    timing.qtInterval = 0.24 + 0.26 * qSqrt(rr) - 0.15;
+    return timing;
+}
+
+double EcgSimulator::beatValue(const Beat& beat, double tau)
+{
+    if (tau < 0.0) return 0.0;
+    return beat.ectopic ? ectopicBeat(tau) : normalBeat(tau, beat.rr, beat.pWave);
+}
+
+QVector<double> EcgSimulator::generate(int count)
+{
+    QVector<double> out(qMax(0, count));
+    const double dt = 1.0 / m_config.sampleRate;
+    const double wanderW = 2.0 * M_PI * m_config.baselineWanderHz;
+
+    for (int i = 0; i < out.size(); ++i) {
+        double t = m_sampleIndex * dt;
+        while (t - m_beat.start >= m_beat.rr) {
+            startBeat(m_beat.start + m_beat.rr);
+        }
+
+        // 心率较快或早搏时, 前一搏的T波可能延续到本周期内
+        double value = beatValue(m_beat, t - m_beat.start);
+        if (m_prevBeat.rr > 0.0) {
+            value += beatValue(m_prevBeat, t - m_prevBeat.start);
+        }
+
+        // f波: 两个非整数倍频率叠加的4-8Hz小幅颤动
+        if (m_config.atrialFibrillation) {
+            value += 6.0 * qSin(2.0 * M_PI * 5.3 * t) + 4.0 * qSin(2.0 * M_PI * 7.1 * t + 1.0);
+        }
+        if (m_config.baselineWander != 0.0) {
+            value += m_config.baselineWander * qSin(wanderW * t);
+        }
+        if (m_config.noiseLevel > 0.0) {
+            value += (2.0 * m_rng.generateDouble() - 1.0) * m_config.noiseLevel;
+        }
+
+        out[i] = value;
+        m_sampleIndex++;
+    }
+    return out;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <QVector>
+#include <QRandomGenerator>
+
+// 合成ECG发生器: 在 MainWindow 原有 P-QRS-T 分段正弦模型基础上,
+// 增加可配置心率、心率变异、噪声、基线漂移和室性早搏, 可记录R波真实时刻 (评估用)
+class EcgSimulator {
+public:
+    struct Config {
+        int sampleRate = 200;          // Hz
+        double heartRate = 60.0;       // bpm
+        double hrVariability = 0.0;    // R-R间期相对标准差 (0.05 = 5%)
+        double noiseLevel = 5.0;       // 均匀噪声幅度 (±mV)
+        double baselineWander = 0.0;   // 基线漂移幅度 (mV)
+        double baselineWanderHz = 0.3; // 基线漂移频率 (呼吸 ~0.3Hz)
+        double ectopicRate = 0.0;      // 每搏出现室性早搏的概率
+        bool atrialFibrillation = false; // 房颤: R-R绝对不齐, 无P波, 代之以f波
+        bool recordGroundTruth = false;  // 记录R波真实时刻; 随生成时长增长, 持续实时模拟时不开启
+        quint32 seed = 0;              // 0 = 随机种子
+    };
+
+    EcgSimulator();
+    explicit EcgSimulator(const Config& config);
+
+    void setConfig(const Config& config);
+    const Config& config() const { return m_config; }
+
+    void reset();
+
+    // 生成接下来的 count 个样本 (mV)
+    QVector<double> generate(int count);
+
+    // R波真实时刻 (秒) 及是否为早搏, 含当前正在生成的心搏; 仅在 Config::recordGroundTruth 时记录
+    const QVector<double>& rPeakTimes() const { return m_rPeakTimes; }
+    const QVector<bool>& ectopicFlags() const { return m_ectopicFlags; }
+    qint64 samplesGenerated() const { return m_sampleIndex; }
+
+    // 心动周期起点到R波峰值的时间 (秒)
+    static constexpr double kROffset = 0.19;
+
+    // 正常搏动的真实间期 (秒), rr 为该心动周期长度; 用于校验特征点定位
+    struct BeatTiming {
+        double qrsWidth;
+        double prInterval;
+        double qtInterval;
+    };
+    static BeatTiming normalBeatTiming(double rr);
+
+private:
+    // 单个心动周期
+    struct Beat {
+        double start = 0.0;   // 周期起点 (秒)
+        double rr = 0.0;      // 到下一周期起点的间隔 (秒)
+        bool ectopic = false;
+        bool pWave = true;
+    };
+
+    void startBeat(double startTime);
+    double gaussian();
+    static double beatValue(const Beat& beat, double tau);
+
+    Config m_config;
+    QRandomGenerator m_rng;
+
+    qint64 m_sampleIndex = 0;
+    Beat m_beat;
+    Beat m_prevBeat;
+    bool m_nextEctopic = false;
+
+    QVector<double> m_rPeakTimes;
+    QVector<bool> m_ectopicFlags;
+};
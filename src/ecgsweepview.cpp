@@ -0,0 +1,300 @@
+#include "ecgsweepview.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <QLineF>
+#include <QtMath>
+
+namespace {
+
+// 25mm/s 走纸: 小格 1mm = 40ms, 5 小格为一大格 (200ms)
+constexpr double kSmallBoxSec = 0.04;
+constexpr int kBoxesPerLargeBox = 5;
+constexpr double kMinSmallBoxPx = 4.0;    // 小格过密时只画大格
+constexpr double kEraseBarSec = 0.12;     // 写入位置前方清除的宽度
+constexpr double kTraceWidth = 2.0;
+constexpr double kBeatMarkRadius = 4.0;
+
+} // namespace
+
+EcgSweepView::EcgSweepView(QWidget* parent)
+    : QWidget(parent)
+    , m_lineColor(QColor("#00ff88"))
+    , m_backgroundColor(QColor("#0a1628"))
+    , m_gridColor(QColor("#1a3a5c"))
+    , m_beatColor(QColor("#ff4444"))
+{
+    // 网格图层不透明, 整个控件由 paintEvent 自行绘制
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setMinimumSize(200, 100);
+}
+
+void EcgSweepView::setSampleRate(int sampleRate)
+{
+    m_sampleRate = qMax(1, sampleRate);
+    clear(m_nextIndex);
+}
+
+void EcgSweepView::setSweepDuration(double seconds)
+{
+    m_sweepSeconds = qMax(0.5, seconds);
+    rebuildLayers();
+    update();
+}
+
+void EcgSweepView::setVerticalRange(double minValue, double maxValue)
+{
+    if (maxValue <= minValue) return;
+    m_minValue = minValue;
+    m_maxValue = maxValue;
+    // 网格以0电平为基准, 纵向比例变化后已有波形作废
+    rebuildLayers();
+    update();
+}
+
+void EcgSweepView::setLineColor(const QColor& color)
+{
+    // 只影响此后画入的波形, 上一屏在扫描覆盖时自然更新
+    m_lineColor = color;
+}
+
+void EcgSweepView::setBackgroundColor(const QColor& color)
+{
+    m_backgroundColor = color;
+    renderGrid();
+    update();
+}
+
+void EcgSweepView::setGridColor(const QColor& color)
+{
+    m_gridColor = color;
+    renderGrid();
+    update();
+}
+
+void EcgSweepView::clear(qint64 nextIndex)
+{
+    m_nextIndex = nextIndex;
+    m_hasLast = false;
+    if (!m_traceLayer.isNull()) {
+        m_traceLayer.fill(Qt::transparent);
+    }
+    update();
+}
+
+int EcgSweepView::samplesPerSweep() const
+{
+    return qMax(1, qRound(m_sweepSeconds * m_sampleRate));
+}
+
+double EcgSweepView::xForIndex(qint64 index) const
+{
+    const int perSweep = samplesPerSweep();
+    return static_cast<double>(index % perSweep) * width() / perSweep;
+}
+
+double EcgSweepView::yForValue(double value) const
+{
+    return height() * (m_maxValue - value) / (m_maxValue - m_minValue);
+}
+
+// ============================================================
+// 图层
+// ============================================================
+
+void EcgSweepView::rebuildLayers()
+{
+    const qreal dpr = devicePixelRatioF();
+    const QSize pixels = size() * dpr;
+    if (pixels.isEmpty()) {
+        m_traceLayer = QImage();
+        m_gridLayer = QPixmap();
+        return;
+    }
+
+    m_traceLayer = QImage(pixels, QImage::Format_ARGB32_Premultiplied);
+    m_traceLayer.setDevicePixelRatio(dpr);
+    m_traceLayer.fill(Qt::transparent);
+    m_hasLast = false;
+    renderGrid();
+    emit traceCleared();
+}
+
+void EcgSweepView::renderGrid()
+{
+    const qreal dpr = devicePixelRatioF();
+    const QSize pixels = size() * dpr;
+    if (pixels.isEmpty()) return;
+
+    QPixmap grid(pixels);
+    grid.setDevicePixelRatio(dpr);
+    grid.fill(m_backgroundColor);
+
+    // 方格纸: 横向按走纸时间等分, 纵向取相同像素间距并以0电平为基准
+    const double box = width() / m_sweepSeconds * kSmallBoxSec;
+    const double baseline = yForValue(0.0);
+    QVector<QLineF> minorLines;
+    QVector<QLineF> majorLines;
+    auto addLine = [&](int k, const QLineF& line) {
+        if (k % kBoxesPerLargeBox == 0) {
+            majorLines.append(line);
+        } else if (box >= kMinSmallBoxPx) {
+            minorLines.append(line);
+        }
+    };
+    for (int k = 0; k * box <= width(); ++k) {
+        addLine(k, QLineF(k * box, 0, k * box, height()));
+    }
+    for (int k = 0; baseline - k * box >= 0; ++k) {
+        addLine(k, QLineF(0, baseline - k * box, width(), baseline - k * box));
+    }
+    for (int k = 1; baseline + k * box <= height(); ++k) {
+        addLine(k, QLineF(0, baseline + k * box, width(), baseline + k * box));
+    }
+
+    QPainter painter(&grid);
+    QColor minor = m_gridColor;
+    minor.setAlphaF(0.45);
+    painter.setPen(QPen(minor, 0));
+    painter.drawLines(minorLines);
+    painter.setPen(QPen(m_gridColor, 0));
+    painter.drawLines(majorLines);
+    painter.end();
+
+    m_gridLayer = grid;
+}
+
+void EcgSweepView::resizeEvent(QResizeEvent* event)
+{
+    QWidget::resizeEvent(event);
+    rebuildLayers();
+}
+
+void EcgSweepView::paintEvent(QPaintEvent* event)
+{
+    // 移到不同缩放比例的屏幕上时按新的设备像素比重建
+    if (!qFuzzyCompare(m_gridLayer.devicePixelRatio(), devicePixelRatioF())) {
+        rebuildLayers();
+    }
+
+    QPainter painter(this);
+    if (m_gridLayer.isNull()) {
+        painter.fillRect(event->rect(), m_backgroundColor);
+        return;
+    }
+
+    // 只合成需要刷新的竖条
+    const qreal dpr = devicePixelRatioF();
+    const QRect target = event->rect();
+    const QRectF source(target.x() * dpr, target.y() * dpr, target.width() * dpr, target.height() * dpr);
+    painter.drawPixmap(target, m_gridLayer, source);
+    painter.drawImage(target, m_traceLayer, source);
+}
+
+// ============================================================
+// 增量绘制
+// ============================================================
+
+void EcgSweepView::appendSamples(const double* values, int count)
+{
+    if (count <= 0) return;
+
+    const int perSweep = samplesPerSweep();
+    // 超过一屏的部分会被立即覆盖, 只画最后一屏
+    if (count > perSweep) {
+        m_nextIndex += count - perSweep;
+        values += count - perSweep;
+        count = perSweep;
+        m_hasLast = false;
+    }
+    if (m_traceLayer.isNull()) {
+        m_nextIndex += count;
+        return;
+    }
+
+    const double pxPerSample = static_cast<double>(width()) / perSweep;
+    const double eraseWidth = kEraseBarSec / m_sweepSeconds * width();
+
+    QPainter painter(&m_traceLayer);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(QPen(m_lineColor, kTraceWidth, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+
+    int i = 0;
+    while (i < count) {
+        // 本段到右端为止, 回绕后从左端重新起笔
+        const int pos = static_cast<int>(m_nextIndex % perSweep);
+        const int run = qMin(count - i, perSweep - pos);
+        const double x0 = pos * pxPerSample;
+        const double x1 = (pos + run) * pxPerSample;
+
+        // 清除本段所占竖条和前方擦除条; 上一段末点之前的内容不受影响
+        eraseColumns(painter, x0, x1 + eraseWidth);
+
+        m_polyline.clear();
+        if (m_hasLast && pos > 0) {
+            m_polyline.append(QPointF((pos - 1) * pxPerSample, yForValue(m_lastValue)));
+        }
+        for (int k = 0; k < run; ++k) {
+            m_polyline.append(QPointF((pos + k) * pxPerSample, yForValue(values[i + k])));
+        }
+        if (m_polyline.size() >= 2) {
+            painter.drawPolyline(m_polyline);
+        } else {
+            painter.drawPoint(m_polyline.first());
+        }
+        addDirty(x0 - pxPerSample, x1);
+
+        m_lastValue = values[i + run - 1];
+        m_nextIndex += run;
+        m_hasLast = (m_nextIndex % perSweep) != 0;
+        i += run;
+    }
+}
+
+void EcgSweepView::markBeat(qint64 sampleIndex, double amplitude)
+{
+    if (m_traceLayer.isNull()) return;
+
+    // 只标记当前屏已画出且尚未进入擦除条的样本
+    const int perSweep = samplesPerSweep();
+    const qint64 eraseSamples = qCeil(kEraseBarSec * m_sampleRate);
+    if (sampleIndex >= m_nextIndex || sampleIndex < m_nextIndex - perSweep + eraseSamples) return;
+
+    const double x = xForIndex(sampleIndex);
+    const double y = yForValue(amplitude) - 2.0 * kBeatMarkRadius;
+
+    QPainter painter(&m_traceLayer);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(m_beatColor);
+    painter.drawEllipse(QPointF(x, y), kBeatMarkRadius, kBeatMarkRadius);
+    addDirty(x - kBeatMarkRadius, x + kBeatMarkRadius);
+}
+
+void EcgSweepView::eraseColumns(QPainter& painter, double x0, double x1)
+{
+    const double w = width();
+    painter.save();
+    painter.setCompositionMode(QPainter::CompositionMode_Clear);
+    painter.fillRect(QRectF(x0, 0, qMin(x1, w) - x0, height()), Qt::transparent);
+    if (x1 > w) {
+        painter.fillRect(QRectF(0, 0, x1 - w, height()), Qt::transparent);
+    }
+    painter.restore();
+    addDirty(x0, x1);
+}
+
+void EcgSweepView::addDirty(double x0, double x1)
+{
+    // 线宽与抗锯齿边缘各留出余量
+    const double margin = kTraceWidth + 1.0;
+    const int w = width();
+    const int left = qFloor(x0 - margin);
+    const int right = qCeil(x1 + margin);
+    update(QRect(left, 0, right - left, height()));
+    if (right > w) {
+        update(QRect(0, 0, right - w, height()));
+    }
+    if (left < 0) {
+        update(QRect(w + left, 0, -left, height()));
+    }
+}
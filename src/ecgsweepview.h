@@ -0,0 +1,83 @@
+#pragma once
+#include <QWidget>
+#include <QImage>
+#include <QPixmap>
+#include <QColor>
+#include <QPolygonF>
+
+class QPainter;
+
+// 监护仪式扫描显示: 波形从左到右写入, 到右端后回到左端覆盖旧波形,
+// 写入位置前方的擦除条清除上一屏的内容
+//
+// 与 QtCharts 每次重建整条曲线不同, 波形绘制在一张常驻的 QImage 上, 每帧只画新到达的
+// 线段并只刷新对应的竖条区域, 开销与新样本数成正比、与显示时长无关。背景网格按
+// 25mm/s 走纸规格 (小格 40ms, 大格 200ms, 纵向与横向等距) 预先绘制成图层, 仅在
+// 尺寸、颜色或设备像素比变化时重绘
+class EcgSweepView : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit EcgSweepView(QWidget* parent = nullptr);
+
+    void setSampleRate(int sampleRate);
+    int sampleRate() const { return m_sampleRate; }
+
+    // 一屏对应的时间 (秒)
+    void setSweepDuration(double seconds);
+    double sweepDuration() const { return m_sweepSeconds; }
+
+    // 纵轴显示范围 (mV), 扫描显示不做自动缩放
+    void setVerticalRange(double minValue, double maxValue);
+
+    void setLineColor(const QColor& color);
+    void setBackgroundColor(const QColor& color);
+    void setGridColor(const QColor& color);
+
+    // 追加样本并立即画入波形图层; 下一个样本的全局索引为 nextIndex()
+    void appendSamples(const double* values, int count);
+    qint64 nextIndex() const { return m_nextIndex; }
+
+    // 在已绘制的样本处标记R波; 已被擦除或尚未绘制的样本忽略
+    void markBeat(qint64 sampleIndex, double amplitude);
+
+    // 清屏, 下一个样本的全局索引为 nextIndex
+    void clear(qint64 nextIndex = 0);
+
+    QSize sizeHint() const override { return QSize(800, 300); }
+
+signals:
+    // 尺寸或设备像素比变化后波形图层被重建 (内容清空), 数据源可据此重新填充一屏
+    void traceCleared();
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+
+private:
+    void rebuildLayers();
+    void renderGrid();
+    int samplesPerSweep() const;
+    double xForIndex(qint64 index) const;
+    double yForValue(double value) const;
+    // 清除 [x0, x1) 竖条 (超出右端的部分回绕到左端) 并加入待刷新区域
+    void eraseColumns(QPainter& painter, double x0, double x1);
+    void addDirty(double x0, double x1);
+
+    int m_sampleRate = 200;
+    double m_sweepSeconds = 5.0;
+    double m_minValue = -500.0;
+    double m_maxValue = 500.0;
+
+    QColor m_lineColor;
+    QColor m_backgroundColor;
+    QColor m_gridColor;
+    QColor m_beatColor;
+
+    QPixmap m_gridLayer;      // 背景 + 网格, 按设备像素比缓存
+    QImage m_traceLayer;      // 波形 (透明背景), 常驻
+    qint64 m_nextIndex = 0;
+    double m_lastValue = 0.0;
+    bool m_hasLast = false;   // 上一个样本在当前屏内, 新线段从它连起
+    QPolygonF m_polyline;     // 绘制缓冲, 避免逐帧分配
+};
@@ -0,0 +1,169 @@
+#include "envelopeqrsdetector.h"
+#include <QtMath>
+#include <QDataStream>
+
+namespace {
+
+constexpr double kDiffSpanSec = 0.02;       // 约半个QRS宽度, 宽大畸形的室早也有足够响应
+constexpr double kEnvelopeTauSec = 0.02;
+constexpr double kNoiseTauSec = 1.0;        // 噪声电平: 候选之外包络的慢速均值
+constexpr double kMaxEventSec = 0.25;       // 宽大畸形的室早包络持续可超过150ms
+constexpr double kRSearchSec = 0.06;
+constexpr double kThresholdFraction = 0.4;  // 阈值 = 噪声 + 40% × (信号 - 噪声)
+constexpr double kEventEndRatio = 0.5;      // 包络回落到峰值一半即结束候选
+constexpr double kSearchbackSec = 1.66;
+
+} // namespace
+
+EnvelopeQrsDetector::EnvelopeQrsDetector(QObject* parent)
+    : QrsDetector(parent)
+{
+    setSampleRate(200);
+}
+
+void EnvelopeQrsDetector::configure()
+{
+    m_diffSpan = qMax(1, qRound(kDiffSpanSec * m_sampleRate));
+    m_envelopeAlpha = 1.0 - qExp(-1.0 / (kEnvelopeTauSec * m_sampleRate));
+    m_noiseAlpha = 1.0 - qExp(-1.0 / (kNoiseTauSec * m_sampleRate));
+    m_maxEventSamples = qMax(1, qRound(kMaxEventSec * m_sampleRate));
+    m_refractorySamples = static_cast<int>(0.2 * m_sampleRate);
+    m_rSearch = qMax(1, qRound(kRSearchSec * m_sampleRate));
+    m_history.resize(m_diffSpan);
+}
+
+void EnvelopeQrsDetector::resetDetector()
+{
+    m_history.fill(0.0);
+    m_historyPos = 0;
+    m_envelope = 0.0;
+    m_threshold = 0.0;
+    m_signalLevel = 0.0;
+    m_noiseLevel = 0.0;
+    m_lastPeakIndex = -1;
+    m_lastSearchbackIndex = -1;
+    m_inEvent = false;
+    m_eventStart = -1;
+    m_eventMax = 0.0;
+}
+
+void EnvelopeQrsDetector::detect(double value)
+{
+    // 延迟线以首个样本填充, 直流偏置不在开头形成阶跃
+    if (m_globalIndex == 0) m_history.fill(value);
+
+    // 差分 x[n] - x[n-k]: 抑制基线与P/T波等慢变成分, 保留QRS陡峭斜率
+    const double diff = value - m_history[m_historyPos];
+    m_history[m_historyPos] = value;
+    if (++m_historyPos == m_diffSpan) m_historyPos = 0;
+    m_envelope += m_envelopeAlpha * (qAbs(diff) - m_envelope);
+
+    // 初始学习阶段: 前2秒只收集统计数据
+    if (m_globalIndex < m_sampleRate * 2) {
+        m_signalLevel = qMax(m_signalLevel, m_envelope);
+        m_noiseLevel += m_noiseAlpha * (m_envelope - m_noiseLevel);
+        updateThreshold();
+        return;
+    }
+
+    // 输入中断处的阶跃会使差分和包络出现一个尖峰, 衰减前不形成候选
+    if (m_globalIndex < m_discontinuityIndex + m_refractorySamples + m_maxEventSamples) {
+        return;
+    }
+
+    if (!m_inEvent) {
+        m_noiseLevel += m_noiseAlpha * (m_envelope - m_noiseLevel);
+        updateThreshold();
+        if (m_envelope > m_threshold &&
+            (m_lastPeakIndex < 0 || m_globalIndex - m_lastPeakIndex >= m_refractorySamples)) {
+            m_inEvent = true;
+            m_eventStart = m_globalIndex;
+            m_eventMax = m_envelope;
+        }
+    } else {
+        m_eventMax = qMax(m_eventMax, m_envelope);
+        if (m_envelope < kEventEndRatio * m_eventMax ||
+            m_globalIndex - m_eventStart >= m_maxEventSamples) {
+            closeEvent();
+        }
+    }
+
+    // 长时间没有检出 (>1.66s) 时信号电平减半 (阈值随之降低), 每个回溯周期只降低一次
+    if (m_lastPeakIndex >= 0 &&
+        (m_globalIndex - qMax(m_lastPeakIndex, m_lastSearchbackIndex)) > static_cast<int>(kSearchbackSec * m_sampleRate)) {
+        m_signalLevel *= 0.5;
+        updateThreshold();
+        m_lastSearchbackIndex = m_globalIndex;
+    }
+}
+
+void EnvelopeQrsDetector::closeEvent()
+{
+    m_inEvent = false;
+
+    // 持续到窗口上限仍未回落的是基线阶跃或运动伪迹, 不是QRS
+    if (m_globalIndex - m_eventStart >= m_maxEventSamples) return;
+
+    // 包络越阈时R波上升支已开始, R峰在越阈点之前不远到当前点之间
+    int peakIndex = findRawMaximum(m_eventStart - m_rSearch, m_globalIndex);
+    if (peakIndex < 0) return;
+
+    m_lastPeakIndex = peakIndex;
+    m_signalLevel = 0.125 * m_eventMax + 0.875 * m_signalLevel;
+    updateThreshold();
+    reportPeak(peakIndex, rawSample(peakIndex));
+}
+
+void EnvelopeQrsDetector::updateThreshold()
+{
+    m_threshold = m_noiseLevel + kThresholdFraction * (m_signalLevel - m_noiseLevel);
+}
+
+// ============================================================
+// 状态快照与输入中断
+// ============================================================
+
+void EnvelopeQrsDetector::discontinuity()
+{
+    m_inEvent = false;
+    if (m_lastPeakIndex >= 0) {
+        m_lastSearchbackIndex = m_globalIndex;
+    }
+}
+
+void EnvelopeQrsDetector::saveDetectorState(QDataStream& out) const
+{
+    out << m_history << qint32(m_historyPos) << m_envelope
+        << m_threshold << m_signalLevel << m_noiseLevel
+        << qint32(m_lastPeakIndex) << qint32(m_lastSearchbackIndex)
+        << m_inEvent << qint32(m_eventStart) << m_eventMax;
+}
+
+bool EnvelopeQrsDetector::restoreDetectorState(QDataStream& in)
+{
+    QVector<double> history;
+    qint32 historyPos, lastPeakIndex, lastSearchbackIndex, eventStart;
+    double envelope, threshold, signalLevel, noiseLevel, eventMax;
+    bool inEvent;
+    in >> history >> historyPos >> envelope
+       >> threshold >> signalLevel >> noiseLevel
+       >> lastPeakIndex >> lastSearchbackIndex
+       >> inEvent >> eventStart >> eventMax;
+    if (in.status() != QDataStream::Ok || history.size() != m_diffSpan ||
+        historyPos < 0 || historyPos >= m_diffSpan) {
+        return false;
+    }
+
+    m_history = history;
+    m_historyPos = historyPos;
+    m_envelope = envelope;
+    m_threshold = threshold;
+    m_signalLevel = signalLevel;
+    m_noiseLevel = noiseLevel;
+    m_lastPeakIndex = lastPeakIndex;
+    m_lastSearchbackIndex = lastSearchbackIndex;
+    m_inEvent = inEvent;
+    m_eventStart = eventStart;
+    m_eventMax = eventMax;
+    return true;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "qrsdetector.h"
+
+// 低开销R波检测器: 短跨度差分 -> 取绝对值 -> 一阶泄漏积分包络 -> 自适应阈值
+//
+// 每样本只有一次减法、一次乘加和几次比较, 无平方、无多阶滤波, 适合低配网关或
+// 同时监护多床位的主机; 代价是对肌电噪声和宽大畸形QRS的区分能力不如 Pan-Tompkins
+class EnvelopeQrsDetector : public QrsDetector {
+    Q_OBJECT
+
+public:
+    explicit EnvelopeQrsDetector(QObject* parent = nullptr);
+
+    Algorithm algorithm() const override { return Algorithm::Envelope; }
+
+protected:
+    void configure() override;
+    void resetDetector() override;
+    void detect(double value) override;
+    void discontinuity() override;
+    void saveDetectorState(QDataStream& out) const override;
+    bool restoreDetectorState(QDataStream& in) override;
+
+private:
+    void closeEvent();
+    void updateThreshold();
+
+    int m_diffSpan = 4;           // 差分跨度 ~20ms
+    double m_envelopeAlpha = 0.2; // 包络时间常数 ~20ms
+    double m_noiseAlpha = 0.005;  // 噪声电平时间常数 ~1s
+    int m_maxEventSamples = 50;   // 候选的最长持续 ~250ms
+    int m_refractorySamples = 40; // 200ms
+    int m_rSearch = 12;           // 越阈前回溯寻找原始最大值的范围 ~60ms
+
+    // 差分延迟线 (长度 m_diffSpan)
+    QVector<double> m_history;
+    int m_historyPos = 0;
+    double m_envelope = 0.0;
+
+    // 阈值
+    double m_threshold = 0.0;
+    double m_signalLevel = 0.0;   // QRS包络峰值的指数平均
+    double m_noiseLevel = 0.0;    // 候选之外包络的慢速均值
+    int m_lastPeakIndex = -1;
+    int m_lastSearchbackIndex = -1;
+
+    // 当前候选: 包络越过阈值到回落至峰值一半之间
+    bool m_inEvent = false;
+    int m_eventStart = -1;
+    double m_eventMax = 0.0;
+};
@@ -0,0 +1,296 @@
+#include "fixedrpeakdetector.h"
+#include <QtMath>
+#include <algorithm>
+
+namespace {
+
+constexpr int kCoeffShift = 20;    // 系数 Q20
+constexpr int kSignalShift = 4;    // 带通状态 Q4
+constexpr int kSquareShift = 8;    // 平方后右移, 保证窗口累加不溢出int32
+constexpr int kBlockSize = 256;    // 批量处理的分块长度
+
+qint32 saturate16(qint32 v)
+{
+    return qBound<qint32>(-32767, v, 32767);
+}
+
+int nextPowerOfTwo(int v)
+{
+    int p = 1;
+    while (p < v) p <<= 1;
+    return p;
+}
+
+} // namespace
+
+FixedPointRPeakDetector::FixedPointRPeakDetector(QObject* parent)
+    : QObject(parent)
+{
+    setSampleRate(200);
+}
+
+void FixedPointRPeakDetector::setSampleRate(int sampleRate)
+{
+    m_sampleRate = sampleRate;
+    m_windowSize = qMax(1, static_cast<int>(0.15 * sampleRate));
+    m_refractorySamples = static_cast<int>(0.2 * sampleRate);
+    m_searchbackSamples = static_cast<int>(1.66 * sampleRate);
+
+    m_lowpass = quantize(EcgFilters::butterworthLowpass(EcgFilters::kQrsBandHighHz, sampleRate));
+    m_highpass = quantize(EcgFilters::butterworthHighpass(EcgFilters::kQrsBandLowHz, sampleRate));
+
+    // 保留2秒原始数据, 另加一个处理块的余量
+    m_adcRing.fill(0, nextPowerOfTwo(sampleRate * 2 + kBlockSize));
+    m_adcMask = m_adcRing.size() - 1;
+
+    m_intRing.fill(0, m_windowSize);
+    reset();
+}
+
+void FixedPointRPeakDetector::reset()
+{
+    m_globalIndex = 0;
+    m_discontinuityIndex = 0;
+    m_lowpass.x1 = m_lowpass.x2 = m_lowpass.y1 = m_lowpass.y2 = 0;
+    m_highpass.x1 = m_highpass.x2 = m_highpass.y1 = m_highpass.y2 = 0;
+    std::fill(std::begin(m_diffHist), std::end(m_diffHist), 0);
+    m_intRing.fill(0);
+    m_intPos = 0;
+    m_intSum = 0;
+    m_threshold = 0;
+    m_signalLevel = 0;
+    m_noiseLevel = 0;
+    m_lastPeakIndex = -1;
+    m_lastSearchbackIndex = -1;
+    m_rising = false;
+    m_candidateMax = 0;
+    m_candidateIndex = -1;
+    m_adcRing.fill(0);
+    m_peaks.clear();
+    m_currentHR = 0;
+}
+
+void FixedPointRPeakDetector::markDiscontinuity()
+{
+    // 阈值与信号/噪声水平保留, 只让中断前后的数据互不参与寻峰和R-R计算
+    m_discontinuityIndex = m_globalIndex;
+    m_candidateMax = 0;
+    m_candidateIndex = -1;
+    m_rising = false;
+}
+
+double FixedPointRPeakDetector::adcToMillivolts(int adcValue)
+{
+    // 0-4095 对应 0-3.3V, 以中点为零
+    return (adcValue - kAdcMid) * (3300.0 / 4095.0);
+}
+
+FixedPointRPeakDetector::Biquad FixedPointRPeakDetector::quantize(const BiquadCoeffs& c)
+{
+    const double scale = static_cast<double>(1 << kCoeffShift);
+    Biquad f;
+    f.a0 = static_cast<qint32>(qRound64(c.a0 * scale));
+    f.a1 = static_cast<qint32>(qRound64(c.a1 * scale));
+    f.a2 = static_cast<qint32>(qRound64(c.a2 * scale));
+    f.b1 = static_cast<qint32>(qRound64(c.b1 * scale));
+    f.b2 = static_cast<qint32>(qRound64(c.b2 * scale));
+    return f;
+}
+
+qint32 FixedPointRPeakDetector::runBiquad(Biquad& f, qint32 x)
+{
+    // 直接I型, int64累加, 四舍五入回到Q4
+    qint64 acc = static_cast<qint64>(f.a0) * x
+               + static_cast<qint64>(f.a1) * f.x1
+               + static_cast<qint64>(f.a2) * f.x2
+               - static_cast<qint64>(f.b1) * f.y1
+               - static_cast<qint64>(f.b2) * f.y2;
+    qint32 y = static_cast<qint32>((acc + (qint64(1) << (kCoeffShift - 1))) >> kCoeffShift);
+
+    f.x2 = f.x1; f.x1 = x;
+    f.y2 = f.y1; f.y1 = y;
+    return y;
+}
+
+void FixedPointRPeakDetector::processAdcSample(int adcValue)
+{
+    qint16 v = static_cast<qint16>(adcValue);
+    processAdcSamples(&v, 1);
+}
+
+void FixedPointRPeakDetector::processAdcSamples(const QVector<qint16>& adcValues)
+{
+    processAdcSamples(adcValues.constData(), adcValues.size());
+}
+
+void FixedPointRPeakDetector::processAdcSamples(const qint16* adcValues, int count)
+{
+    for (int offset = 0; offset < count; offset += kBlockSize) {
+        int n = qMin(kBlockSize, count - offset);
+        runFrontEnd(adcValues + offset, n);
+
+        // 积分与判决需要逐点状态, 保持标量
+        for (int i = 0; i < n; ++i) {
+            detectPeak(movingWindowIntegration(m_squared[i]));
+            m_globalIndex++;
+        }
+    }
+}
+
+// ============================================================
+// 前端分三个循环: 带通(递归, 标量) / 微分+平方(无依赖, 可向量化)
+// ============================================================
+
+void FixedPointRPeakDetector::runFrontEnd(const qint16* adcValues, int count)
+{
+    // 前4个位置放微分器历史, 使微分循环无需边界判断
+    m_bandpassed.resize(count + 4);
+    m_squared.resize(count);
+    qint32* bp = m_bandpassed.data();
+    std::copy(std::begin(m_diffHist), std::end(m_diffHist), bp);
+
+    for (int i = 0; i < count; ++i) {
+        m_adcRing[(m_globalIndex + i) & m_adcMask] = adcValues[i];
+        qint32 x = (static_cast<qint32>(adcValues[i]) - kAdcMid) << kSignalShift;
+        bp[i + 4] = runBiquad(m_highpass, runBiquad(m_lowpass, x));
+    }
+
+    // 因果五点微分: y[n] = (2x[n] + x[n-1] - x[n-3] - 2x[n-4]) / 8
+    qint32* sq = m_squared.data();
+    for (int i = 0; i < count; ++i) {
+        qint32 d = (2 * bp[i + 4] + bp[i + 3] - bp[i + 1] - 2 * bp[i]) >> 3;
+        d = saturate16(d);
+        sq[i] = (d * d) >> kSquareShift;
+    }
+
+    // 与浮点路径一致: 前4个样本微分器未填满, 输出0
+    for (int i = 0; i < count && m_globalIndex + i < 4; ++i) {
+        sq[i] = 0;
+    }
+
+    std::copy(bp + count, bp + count + 4, std::begin(m_diffHist));
+}
+
+qint32 FixedPointRPeakDetector::movingWindowIntegration(qint32 x)
+{
+    // 阈值均为相对比较, 直接使用窗口和而不除以窗口长度
+    m_intSum += x - m_intRing[m_intPos];
+    m_intRing[m_intPos] = x;
+    if (++m_intPos == m_windowSize) m_intPos = 0;
+    return m_intSum;
+}
+
+void FixedPointRPeakDetector::detectPeak(qint32 integratedValue)
+{
+    // 初始学习阶段: 前2秒只收集统计数据
+    if (m_globalIndex < m_sampleRate * 2) {
+        if (integratedValue > m_signalLevel) {
+            m_signalLevel = integratedValue;
+        }
+        m_threshold = m_signalLevel >> 2;
+        return;
+    }
+
+    if (integratedValue > m_candidateMax) {
+        m_candidateMax = integratedValue;
+        m_candidateIndex = m_globalIndex;
+        m_rising = true;
+    }
+
+    // 下降沿: integrated < 0.6 * max, 即 5*integrated < 3*max
+    bool pastPeak = m_rising &&
+        (static_cast<qint64>(integratedValue) * 5 < static_cast<qint64>(m_candidateMax) * 3);
+
+    if (pastPeak && m_candidateMax > m_threshold) {
+        if (m_lastPeakIndex < 0 ||
+            (m_candidateIndex - m_lastPeakIndex) >= m_refractorySamples) {
+
+            // 在ADC环形缓冲中回溯真正的R波峰值
+            int oldest = qMax(m_discontinuityIndex, m_globalIndex - m_sampleRate * 2 + 1);
+            int searchStart = qMax(oldest, m_candidateIndex - m_windowSize);
+            int searchEnd = qMin(m_globalIndex, m_candidateIndex + 2);
+            int maxAdc = -1;
+            int maxIdx = m_candidateIndex;
+            for (int i = searchStart; i <= searchEnd; ++i) {
+                int v = m_adcRing[i & m_adcMask];
+                if (v > maxAdc) {
+                    maxAdc = v;
+                    maxIdx = i;
+                }
+            }
+
+            RPeakInfo peak;
+            peak.sampleIndex = maxIdx;
+            peak.amplitude = adcToMillivolts(maxAdc);
+            peak.timestamp = static_cast<double>(maxIdx) / m_sampleRate;
+            peak.rrInterval = 0.0;
+            peak.instantHR = 0.0;
+            if (!m_peaks.isEmpty() && m_peaks.last().sampleIndex >= m_discontinuityIndex) {
+                peak.rrInterval = peak.timestamp - m_peaks.last().timestamp;
+                if (peak.rrInterval > 0.0) {
+                    peak.instantHR = 60.0 / peak.rrInterval;
+                }
+            }
+
+            m_peaks.append(peak);
+            m_lastPeakIndex = maxIdx;
+
+            updateThreshold(m_candidateMax, true);
+            updateHeartRate();
+
+            emit rPeakDetected(peak);
+        } else {
+            updateThreshold(m_candidateMax, false);
+        }
+
+        m_candidateMax = 0;
+        m_candidateIndex = -1;
+        m_rising = false;
+    }
+
+    // 长时间未检出 (>1.66s), 阈值减半, 每个回溯周期一次
+    if (m_lastPeakIndex >= 0 &&
+        (m_globalIndex - qMax(m_lastPeakIndex, m_lastSearchbackIndex)) > m_searchbackSamples) {
+        m_threshold >>= 1;
+        m_lastSearchbackIndex = m_globalIndex;
+        if (m_globalIndex - m_candidateIndex > m_windowSize) {
+            m_candidateMax = 0;
+            m_rising = false;
+        }
+    }
+}
+
+void FixedPointRPeakDetector::updateThreshold(qint32 peakValue, bool isSignal)
+{
+    // level = 0.125 * peak + 0.875 * level
+    if (isSignal) {
+        m_signalLevel += (peakValue - m_signalLevel) >> 3;
+    } else {
+        m_noiseLevel += (peakValue - m_noiseLevel) >> 3;
+    }
+    // 阈值 = noiseLevel + 0.25 * (signalLevel - noiseLevel)
+    m_threshold = m_noiseLevel + ((m_signalLevel - m_noiseLevel) >> 2);
+}
+
+void FixedPointRPeakDetector::updateHeartRate()
+{
+    // 用最近8个R-R间隔计算平均心率
+    int count = m_peaks.size();
+    if (count < 2) return;
+
+    // 跨越输入中断的心搏 R-R 为0, 平均只取其后的间期
+    int n = 0;
+    while (n < 8 && n < count - 1 && m_peaks[count - 1 - n].rrInterval > 0.0) {
+        ++n;
+    }
+    if (n == 0) return;
+    int spanSamples = m_peaks[count - 1].sampleIndex - m_peaks[count - 1 - n].sampleIndex;
+    if (spanSamples <= 0) return;
+
+    // bpm = 60 * rate * n / span, 整数四舍五入
+    int hr = (60 * m_sampleRate * n + spanSamples / 2) / spanSamples;
+    if (hr >= 30 && hr <= 220) {
+        m_currentHR = hr;
+        emit heartRateUpdated(m_currentHR);
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <QObject>
+#include <QVector>
+#include "qrsdetector.h"
+#include "ecgfilters.h"
+
+// 定点R波检测器: 直接处理 0-4095 的ADC原始计数, 带通/微分/平方/积分全程整数运算
+// 与 RPeakDetector (浮点, mV输入) 检测逻辑一致, 可作为嵌入式网关的移植模板
+//
+// 数值格式:
+//   输入      int16, 去除中点2048后的ADC计数
+//   带通状态  int32, Q4 (计数 × 16)
+//   滤波系数  int32, Q20
+//   累加器    int64
+//   平方/积分 int32
+class FixedPointRPeakDetector : public QObject {
+    Q_OBJECT
+
+public:
+    explicit FixedPointRPeakDetector(QObject* parent = nullptr);
+
+    void setSampleRate(int sampleRate);
+    int sampleRate() const { return m_sampleRate; }
+
+    // 逐点/批量输入 (ADC原始计数)
+    void processAdcSample(int adcValue);
+    void processAdcSamples(const QVector<qint16>& adcValues);
+    void processAdcSamples(const qint16* adcValues, int count);
+
+    void reset();
+    // 输入中断 (如断线重连): 丢弃正在形成的候选, 中断前后的R波之间不计R-R间期
+    void markDiscontinuity();
+
+    // 查询结果 (幅值已换算为mV, 与浮点路径一致)
+    const QVector<RPeakInfo>& detectedPeaks() const { return m_peaks; }
+    int currentHeartRate() const { return m_currentHR; }
+
+    // ADC计数 -> mV (与 MqttClient::parseEcgData 相同的换算)
+    static double adcToMillivolts(int adcValue);
+
+    static constexpr int kAdcMid = 2048;
+
+signals:
+    void rPeakDetected(const RPeakInfo& peak);
+    void heartRateUpdated(int bpm);
+
+private:
+    struct Biquad {
+        qint32 a0 = 0, a1 = 0, a2 = 0, b1 = 0, b2 = 0;  // Q20
+        qint32 x1 = 0, x2 = 0, y1 = 0, y2 = 0;          // Q4
+    };
+
+    static Biquad quantize(const BiquadCoeffs& c);
+    static qint32 runBiquad(Biquad& f, qint32 x);
+
+    // 前端: 带通 -> 微分 -> 平方, 结果写入 m_squared
+    void runFrontEnd(const qint16* adcValues, int count);
+    qint32 movingWindowIntegration(qint32 x);
+    void detectPeak(qint32 integratedValue);
+    void updateThreshold(qint32 peakValue, bool isSignal);
+    void updateHeartRate();
+
+    int m_sampleRate = 200;
+    int m_globalIndex = 0;
+    int m_discontinuityIndex = 0;   // 输入中断后的首个样本, 此前的R波不参与R-R计算
+
+    Biquad m_lowpass;
+    Biquad m_highpass;
+
+    // 微分器历史 (最近4个带通输出)
+    qint32 m_diffHist[4] = {};
+
+    // 块处理暂存
+    QVector<qint32> m_bandpassed;
+    QVector<qint32> m_squared;
+
+    // 滑动窗口积分 (环形)
+    QVector<qint32> m_intRing;
+    int m_intPos = 0;
+    qint32 m_intSum = 0;
+    int m_windowSize = 30;
+
+    // 峰值检测
+    qint32 m_threshold = 0;
+    qint32 m_signalLevel = 0;
+    qint32 m_noiseLevel = 0;
+    int m_lastPeakIndex = -1;
+    int m_lastSearchbackIndex = -1;
+    int m_refractorySamples = 40;
+    int m_searchbackSamples = 332;  // ~1.66s
+
+    bool m_rising = false;
+    qint32 m_candidateMax = 0;
+    int m_candidateIndex = -1;
+
+    // 原始ADC环形缓冲 (2的幂容量, 用于回溯R波真实峰值)
+    QVector<qint16> m_adcRing;
+    int m_adcMask = 0;
+
+    QVector<RPeakInfo> m_peaks;
+    int m_currentHR = 0;
+};
@@ -0,0 +1,512 @@
+#include "fulldisclosureview.h"
+#include "datamanager.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <QWheelEvent>
+#include <QMouseEvent>
+#include <QKeyEvent>
+#include <QResizeEvent>
+#include <QTimer>
+#include <QDateTime>
+#include <QLineF>
+#include <QPolygonF>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <numeric>
+
+namespace {
+
+constexpr double kMinSpanMs = 1000.0;        // 最大放大: 一屏1秒
+constexpr int kLoadDelayMs = 30;             // 视窗连续变化 (滚轮、拖动) 期间的读取间隔
+constexpr double kMaxGapMs = 1000.0;         // 原始样本间隔超过此值视为断开
+constexpr double kZoomStep = 0.8;            // 滚轮每格缩放比例
+constexpr double kKeyPanRatio = 0.25;        // 方向键平移视窗宽度的比例
+constexpr double kVerticalPadding = 0.1;
+constexpr int kAxisHeight = 20;              // 底部时间标签高度
+constexpr double kMinTickSpacingPx = 100.0;
+
+// 时间刻度候选间隔 (毫秒)
+constexpr qint64 kTickSteps[] = {
+    100, 200, 500, 1000, 2000, 5000, 10000, 30000,
+    60000, 120000, 300000, 600000, 1800000,
+    3600000, 7200000, 21600000, 43200000, 86400000
+};
+
+} // namespace
+
+FullDisclosureView::FullDisclosureView(QWidget* parent)
+    : QWidget(parent)
+    , m_lineColor(QColor("#00ff88"))
+    , m_backgroundColor(QColor("#0a1628"))
+    , m_gridColor(QColor("#1a3a5c"))
+    , m_textColor(QColor("#8fa8c0"))
+    , m_loadTimer(new QTimer(this))
+{
+    m_loadTimer->setSingleShot(true);
+    m_loadTimer->setInterval(kLoadDelayMs);
+    connect(m_loadTimer, &QTimer::timeout, this, &FullDisclosureView::ensureData);
+
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setFocusPolicy(Qt::StrongFocus);
+    setCursor(Qt::OpenHandCursor);
+    setMinimumSize(200, 100);
+}
+
+void FullDisclosureView::setDataManager(DataManager* dataManager)
+{
+    if (m_dataManager) {
+        disconnect(m_dataManager, nullptr, this, nullptr);
+    }
+    m_dataManager = dataManager;
+    if (m_dataManager) {
+        // 后台重建完成前读到的摘要可能不完整
+        connect(m_dataManager, &DataManager::ecgPyramidRebuilt, this, [this]() {
+            if (m_cache.level >= 0) {
+                m_cache = Cache();
+                requestData();
+            }
+        });
+    }
+    m_cache = Cache();
+    requestData();
+    update();
+}
+
+void FullDisclosureView::setSampleRate(int sampleRate)
+{
+    m_sampleRate = qMax(1, sampleRate);
+    // 原始样本的时间按采样率排布, 需要重新读取
+    if (m_cache.level < 0) {
+        m_cache = Cache();
+    }
+    requestData();
+    update();
+}
+
+void FullDisclosureView::setRecordRange(qint64 fromMs, qint64 toMs)
+{
+    m_recordFrom = fromMs;
+    m_recordTo = qMax(fromMs, toMs);
+    m_cache = Cache();
+    setViewRange(m_recordFrom, m_recordTo);
+}
+
+void FullDisclosureView::setViewRange(double fromMs, double toMs)
+{
+    // 视窗不小于最小宽度, 不超出记录范围
+    const double recordSpan = static_cast<double>(m_recordTo - m_recordFrom);
+    double span = qBound(qMin(kMinSpanMs, recordSpan), toMs - fromMs, recordSpan);
+    double from = qBound(static_cast<double>(m_recordFrom), fromMs,
+                         static_cast<double>(m_recordTo) - span);
+
+    if (from == m_viewFrom && from + span == m_viewTo) return;
+    m_viewFrom = from;
+    m_viewTo = from + span;
+    emit viewRangeChanged(m_viewFrom, m_viewTo);
+    requestData();
+    update();
+}
+
+void FullDisclosureView::setLineColor(const QColor& color)
+{
+    m_lineColor = color;
+    update();
+}
+
+void FullDisclosureView::setBackgroundColor(const QColor& color)
+{
+    m_backgroundColor = color;
+    update();
+}
+
+void FullDisclosureView::setGridColor(const QColor& color)
+{
+    m_gridColor = color;
+    update();
+}
+
+QRectF FullDisclosureView::plotRect() const
+{
+    return QRectF(0, 0, width(), qMax(1, height() - kAxisHeight));
+}
+
+double FullDisclosureView::msPerColumn() const
+{
+    const double columns = qMax(1.0, plotRect().width() * devicePixelRatioF());
+    return (m_viewTo - m_viewFrom) / columns;
+}
+
+int FullDisclosureView::levelForView() const
+{
+    // 每列不足最细一级的一个桶 (只有几个样本) 时才读取原始样本
+    const double perColumn = msPerColumn();
+    if (perColumn < DataManager::ecgPyramidBucketMs(0)) return -1;
+
+    int level = 0;
+    while (level + 1 < DataManager::kEcgPyramidLevels
+           && DataManager::ecgPyramidBucketMs(level + 1) <= perColumn) {
+        ++level;
+    }
+    return level;
+}
+
+// ============================================================
+// 数据读取
+// ============================================================
+
+bool FullDisclosureView::cacheCoversView() const
+{
+    return m_cache.level == levelForView() && m_cache.fromMs <= m_viewFrom && m_cache.toMs >= m_viewTo;
+}
+
+void FullDisclosureView::requestData()
+{
+    // 读取不在绘制中进行: 数据就绪前先用已有的数据 (其他级别或相邻范围) 绘制;
+    // 已安排的读取不推迟, 持续拖动时也能按间隔读到新数据
+    if (m_dataManager && m_viewTo > m_viewFrom && !cacheCoversView() && !m_loadTimer->isActive()) {
+        m_loadTimer->start();
+    }
+}
+
+void FullDisclosureView::ensureData()
+{
+    if (!m_dataManager || m_viewTo <= m_viewFrom || cacheCoversView()) return;
+
+    const int level = levelForView();
+
+    // 多读两侧各一屏, 平移时不必每次访问数据库
+    const double span = m_viewTo - m_viewFrom;
+    const qint64 from = qMax(m_recordFrom, static_cast<qint64>(std::floor(m_viewFrom - span)));
+    const qint64 to = qMin(m_recordTo, static_cast<qint64>(std::ceil(m_viewTo + span)));
+
+    m_cache = Cache();
+    m_cache.level = level;
+    m_cache.fromMs = from;
+    m_cache.toMs = to;
+    if (level < 0) {
+        loadRaw(from, to);
+    } else {
+        m_cache.buckets = m_dataManager->getEcgPyramid(level,
+            QDateTime::fromMSecsSinceEpoch(from), QDateTime::fromMSecsSinceEpoch(to));
+    }
+    update();
+}
+
+void FullDisclosureView::loadRaw(qint64 fromMs, qint64 toMs)
+{
+    // 数据库时间戳只精确到秒: 两端各放宽1秒。样本时刻与心电摘要金字塔的排布一致
+    const QVector<EcgSegment> segments = m_dataManager->getEcgSegments(
+        QDateTime::fromMSecsSinceEpoch(fromMs - 1000), QDateTime::fromMSecsSinceEpoch(toMs + 1000));
+
+    EcgSampleClock clock(m_sampleRate);
+    for (const EcgSegment& segment : segments) {
+        double t = clock.place(segment.timeMs, segment.samples.size());
+        for (double value : segment.samples) {
+            m_cache.sampleTimes.append(t);
+            m_cache.samples.append(value);
+            t += clock.periodMs();
+        }
+    }
+
+    // 一秒内的样本多于采样率 (采样率设置与设备不符) 时会与下一秒重叠, 按时间重新排序
+    QVector<double>& times = m_cache.sampleTimes;
+    if (!std::is_sorted(times.cbegin(), times.cend())) {
+        QVector<int> order(times.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return times[a] < times[b]; });
+        QVector<double> sortedTimes;
+        QVector<double> sortedSamples;
+        sortedTimes.reserve(order.size());
+        sortedSamples.reserve(order.size());
+        for (int i : order) {
+            sortedTimes.append(times[i]);
+            sortedSamples.append(m_cache.samples[i]);
+        }
+        m_cache.sampleTimes = sortedTimes;
+        m_cache.samples = sortedSamples;
+    }
+}
+
+// ============================================================
+// 绘制
+// ============================================================
+
+int FullDisclosureView::buildColumns(int columns, double viewFrom, double msPerCol)
+{
+    m_columnMin.fill(0.0f, columns);
+    m_columnMax.fill(0.0f, columns);
+    m_columnValid.fill(false, columns);
+
+    int valid = 0;
+    auto add = [&](int column, float lo, float hi) {
+        if (column < 0 || column >= columns) return;
+        if (!m_columnValid[column]) {
+            m_columnValid[column] = true;
+            m_columnMin[column] = lo;
+            m_columnMax[column] = hi;
+            ++valid;
+        } else {
+            m_columnMin[column] = qMin(m_columnMin[column], lo);
+            m_columnMax[column] = qMax(m_columnMax[column], hi);
+        }
+    };
+
+    const double viewTo = viewFrom + msPerCol * columns;
+    if (m_cache.level >= 0) {
+        // 每个桶落在它覆盖的列上 (最粗一级的桶可能跨越多列)
+        const double bucketMs = static_cast<double>(DataManager::ecgPyramidBucketMs(m_cache.level));
+        auto it = std::lower_bound(m_cache.buckets.cbegin(), m_cache.buckets.cend(), viewFrom - bucketMs,
+            [](const EcgSummaryBucket& bucket, double t) { return bucket.startMs < t; });
+        for (; it != m_cache.buckets.cend() && it->startMs < viewTo; ++it) {
+            const int first = static_cast<int>(std::floor((it->startMs - viewFrom) / msPerCol));
+            const int last = static_cast<int>(std::ceil((it->startMs + bucketMs - viewFrom) / msPerCol)) - 1;
+            for (int c = qMax(0, first); c <= qMin(columns - 1, qMax(first, last)); ++c) {
+                add(c, it->min, it->max);
+            }
+        }
+    } else {
+        const QVector<double>& times = m_cache.sampleTimes;
+        int i = static_cast<int>(std::lower_bound(times.cbegin(), times.cend(), viewFrom) - times.cbegin());
+        for (; i < times.size() && times[i] < viewTo; ++i) {
+            const float value = static_cast<float>(m_cache.samples[i]);
+            add(static_cast<int>((times[i] - viewFrom) / msPerCol), value, value);
+        }
+    }
+    return valid;
+}
+
+void FullDisclosureView::paintGrid(QPainter& painter, const QRectF& plot)
+{
+    const double span = m_viewTo - m_viewFrom;
+    const double msPerPx = span / plot.width();
+
+    qint64 step = kTickSteps[std::size(kTickSteps) - 1];
+    for (qint64 candidate : kTickSteps) {
+        if (candidate / msPerPx >= kMinTickSpacingPx) {
+            step = candidate;
+            break;
+        }
+    }
+
+    QString format;
+    if (step < 1000) format = QStringLiteral("HH:mm:ss.zzz");
+    else if (step < 60000) format = QStringLiteral("HH:mm:ss");
+    else if (span < 86400000.0) format = QStringLiteral("HH:mm");
+    else format = QStringLiteral("MM-dd HH:mm");
+
+    // 刻度按本地时间对齐整点
+    const qint64 offset = QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(m_viewFrom))
+                              .offsetFromUtc() * qint64(1000);
+    qint64 tick = static_cast<qint64>(std::ceil((m_viewFrom + offset) / step)) * step - offset;
+
+    QVector<QLineF> lines;
+    painter.setFont(font());
+    const QFontMetrics metrics = painter.fontMetrics();
+    painter.setPen(m_textColor);
+    for (; tick <= m_viewTo; tick += step) {
+        const double x = plot.left() + (tick - m_viewFrom) / msPerPx;
+        lines.append(QLineF(x, plot.top(), x, plot.bottom()));
+
+        const QString label = QDateTime::fromMSecsSinceEpoch(tick).toString(format);
+        const int labelWidth = metrics.horizontalAdvance(label);
+        const double labelX = qBound(0.0, x - labelWidth / 2.0, width() - labelWidth - 1.0);
+        painter.drawText(QPointF(labelX, plot.bottom() + metrics.ascent() + 3), label);
+    }
+
+    painter.setPen(QPen(m_gridColor, 0));
+    painter.drawLines(lines);
+    painter.drawLine(QLineF(plot.left(), plot.bottom(), plot.right(), plot.bottom()));
+}
+
+void FullDisclosureView::paintTrace(QPainter& painter, const QRectF& plot)
+{
+    const qreal dpr = devicePixelRatioF();
+    const int columns = qMax(1, qFloor(plot.width() * dpr));
+    const double perColumn = (m_viewTo - m_viewFrom) / columns;
+
+    if (buildColumns(columns, m_viewFrom, perColumn) == 0) {
+        painter.setPen(m_textColor);
+        QString message = QStringLiteral("所选时间范围内无心电数据");
+        if (!m_dataManager) message = QStringLiteral("未连接数据库");
+        else if (m_loadTimer->isActive()) message = QStringLiteral("正在读取心电数据…");
+        painter.drawText(plot, Qt::AlignCenter, message);
+        return;
+    }
+
+    // 纵轴按视窗内的数据自动缩放
+    float lo = std::numeric_limits<float>::max();
+    float hi = std::numeric_limits<float>::lowest();
+    for (int c = 0; c < columns; ++c) {
+        if (!m_columnValid[c]) continue;
+        lo = qMin(lo, m_columnMin[c]);
+        hi = qMax(hi, m_columnMax[c]);
+    }
+    double range = hi - lo;
+    if (range <= 0.0) range = 1.0;
+    const double top = hi + range * kVerticalPadding;
+    const double scale = plot.height() / (range * (1.0 + 2.0 * kVerticalPadding));
+    auto yFor = [&](double value) { return plot.top() + (top - value) * scale; };
+
+    const double period = 1000.0 / m_sampleRate;
+    if (m_cache.level < 0 && perColumn * 2.0 < period) {
+        // 每个样本占两列以上: 直接连接样本点
+        const QVector<double>& times = m_cache.sampleTimes;
+        int i = static_cast<int>(std::lower_bound(times.cbegin(), times.cend(), m_viewFrom - period)
+                                 - times.cbegin());
+        QPolygonF polyline;
+        painter.setRenderHint(QPainter::Antialiasing, true);
+        painter.setPen(QPen(m_lineColor, 1.5));
+        for (; i < times.size() && times[i] <= m_viewTo + period; ++i) {
+            if (!polyline.isEmpty() && times[i] - times[i - 1] > kMaxGapMs) {
+                painter.drawPolyline(polyline);
+                polyline.clear();
+            }
+            polyline.append(QPointF(plot.left() + (times[i] - m_viewFrom) / perColumn / dpr,
+                                    yFor(m_cache.samples[i])));
+        }
+        painter.drawPolyline(polyline);
+        return;
+    }
+
+    // 每个设备像素列一条竖线 (最小值到最大值), 与相邻列的范围衔接
+    QVector<QLineF> lines;
+    lines.reserve(columns);
+    for (int c = 0; c < columns; ++c) {
+        if (!m_columnValid[c]) continue;
+        double cLo = m_columnMin[c];
+        double cHi = m_columnMax[c];
+        if (c > 0 && m_columnValid[c - 1]) {
+            cLo = qMin(cLo, static_cast<double>(m_columnMax[c - 1]));
+            cHi = qMax(cHi, static_cast<double>(m_columnMin[c - 1]));
+        }
+        const double x = plot.left() * dpr + c + 0.5;
+        lines.append(QLineF(x, yFor(cHi) * dpr, x, yFor(cLo) * dpr + 1.0));
+    }
+
+    painter.save();
+    painter.scale(1.0 / dpr, 1.0 / dpr);
+    painter.setRenderHint(QPainter::Antialiasing, false);
+    painter.setPen(QPen(m_lineColor, 0));
+    painter.drawLines(lines);
+    painter.restore();
+}
+
+void FullDisclosureView::paintEvent(QPaintEvent* event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    painter.fillRect(rect(), m_backgroundColor);
+    if (m_viewTo <= m_viewFrom) return;
+
+    const QRectF plot = plotRect();
+    paintGrid(painter, plot);
+    painter.setClipRect(plot);
+    paintTrace(painter, plot);
+}
+
+// ============================================================
+// 交互
+// ============================================================
+
+void FullDisclosureView::resizeEvent(QResizeEvent* event)
+{
+    QWidget::resizeEvent(event);
+    // 列数变化可能改变应使用的级别
+    requestData();
+}
+
+void FullDisclosureView::zoom(double factor, double anchorMs)
+{
+    const double span = m_viewTo - m_viewFrom;
+    if (span <= 0.0) return;
+
+    const double newSpan = qBound(kMinSpanMs, span * factor,
+                                  static_cast<double>(m_recordTo - m_recordFrom));
+    const double from = anchorMs - (anchorMs - m_viewFrom) * newSpan / span;
+    setViewRange(from, from + newSpan);
+}
+
+void FullDisclosureView::pan(double deltaMs)
+{
+    setViewRange(m_viewFrom + deltaMs, m_viewTo + deltaMs);
+}
+
+void FullDisclosureView::wheelEvent(QWheelEvent* event)
+{
+    const double steps = event->angleDelta().y() / 120.0;
+    if (steps == 0.0) {
+        event->ignore();
+        return;
+    }
+
+    // 以光标所在时刻为中心缩放
+    const QRectF plot = plotRect();
+    const double ratio = qBound(0.0, (event->position().x() - plot.left()) / plot.width(), 1.0);
+    zoom(std::pow(kZoomStep, steps), m_viewFrom + ratio * (m_viewTo - m_viewFrom));
+    event->accept();
+}
+
+void FullDisclosureView::mousePressEvent(QMouseEvent* event)
+{
+    if (event->button() == Qt::LeftButton) {
+        m_dragging = true;
+        m_dragLastX = event->position().x();
+        setCursor(Qt::ClosedHandCursor);
+    }
+    QWidget::mousePressEvent(event);
+}
+
+void FullDisclosureView::mouseMoveEvent(QMouseEvent* event)
+{
+    if (m_dragging) {
+        const double dx = event->position().x() - m_dragLastX;
+        m_dragLastX = event->position().x();
+        pan(-dx * (m_viewTo - m_viewFrom) / plotRect().width());
+    }
+    QWidget::mouseMoveEvent(event);
+}
+
+void FullDisclosureView::mouseReleaseEvent(QMouseEvent* event)
+{
+    if (event->button() == Qt::LeftButton) {
+        m_dragging = false;
+        setCursor(Qt::OpenHandCursor);
+    }
+    QWidget::mouseReleaseEvent(event);
+}
+
+void FullDisclosureView::mouseDoubleClickEvent(QMouseEvent* event)
+{
+    Q_UNUSED(event);
+    setViewRange(m_recordFrom, m_recordTo);
+}
+
+void FullDisclosureView::keyPressEvent(QKeyEvent* event)
+{
+    const double span = m_viewTo - m_viewFrom;
+    const double center = (m_viewFrom + m_viewTo) / 2.0;
+    switch (event->key()) {
+    case Qt::Key_Left:
+        pan(-span * kKeyPanRatio);
+        break;
+    case Qt::Key_Right:
+        pan(span * kKeyPanRatio);
+        break;
+    case Qt::Key_Plus:
+    case Qt::Key_Equal:
+        zoom(kZoomStep, center);
+        break;
+    case Qt::Key_Minus:
+        zoom(1.0 / kZoomStep, center);
+        break;
+    case Qt::Key_Home:
+        setViewRange(m_recordFrom, m_recordTo);
+        break;
+    default:
+        QWidget::keyPressEvent(event);
+    }
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include <QWidget>
+#include <QVector>
+#include <QColor>
+#include "vitaldata.h"
+
+class DataManager;
+class QTimer;
+
+// 全览心电 (full disclosure): 任意时间范围的存储心电, 滚轮缩放 (数小时到单个心搏), 拖动平移,
+// 双击恢复全程
+//
+// 显示数据按屏幕分辨率取自数据库: 读取心电摘要金字塔中不粗于一个像素列的最粗一级 (最细一级
+// 64毫秒, 每级桶为上一级的16倍), 只有放大到每列不足64毫秒 (几个样本) 时才读取原始样本。
+// 已读取的数据覆盖当前视窗两侧各一屏, 平移和小幅缩放不访问数据库; 读取在视窗变化稍后进行,
+// 不阻塞绘制, 数据就绪前沿用已读取的数据
+class FullDisclosureView : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit FullDisclosureView(QWidget* parent = nullptr);
+
+    void setDataManager(DataManager* dataManager);
+    void setSampleRate(int sampleRate);
+    int sampleRate() const { return m_sampleRate; }
+
+    // 记录范围 (毫秒时间戳), 视窗重置为全程
+    void setRecordRange(qint64 fromMs, qint64 toMs);
+    void setViewRange(double fromMs, double toMs);
+    double viewFrom() const { return m_viewFrom; }
+    double viewTo() const { return m_viewTo; }
+
+    void setLineColor(const QColor& color);
+    void setBackgroundColor(const QColor& color);
+    void setGridColor(const QColor& color);
+
+    QSize sizeHint() const override { return QSize(800, 300); }
+
+signals:
+    void viewRangeChanged(double fromMs, double toMs);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void wheelEvent(QWheelEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+    void mouseReleaseEvent(QMouseEvent* event) override;
+    void mouseDoubleClickEvent(QMouseEvent* event) override;
+    void keyPressEvent(QKeyEvent* event) override;
+
+private:
+    // 已读取的数据: 金字塔某一级的桶, 或原始样本 (level 为 -1)
+    struct Cache {
+        int level = -2;                 // -2 为未读取
+        qint64 fromMs = 0;
+        qint64 toMs = 0;
+        QVector<EcgSummaryBucket> buckets;
+        QVector<double> sampleTimes;    // 原始样本时间 (毫秒时间戳)
+        QVector<double> samples;
+    };
+
+    QRectF plotRect() const;
+    // 当前视窗每设备像素列对应的毫秒数与应使用的级别
+    double msPerColumn() const;
+    int levelForView() const;
+    bool cacheCoversView() const;
+    // 已读取的数据不覆盖当前视窗时安排读取
+    void requestData();
+    void ensureData();
+    void loadRaw(qint64 fromMs, qint64 toMs);
+    void zoom(double factor, double anchorMs);
+    void pan(double deltaMs);
+
+    // 把视窗内的数据归并到设备像素列的最小/最大值, 返回有数据的列数
+    int buildColumns(int columns, double viewFrom, double msPerCol);
+    void paintGrid(QPainter& painter, const QRectF& plot);
+    void paintTrace(QPainter& painter, const QRectF& plot);
+
+    DataManager* m_dataManager = nullptr;
+    int m_sampleRate = 200;
+
+    qint64 m_recordFrom = 0;
+    qint64 m_recordTo = 0;
+    double m_viewFrom = 0.0;
+    double m_viewTo = 0.0;
+
+    Cache m_cache;
+
+    // 绘制缓冲, 避免逐帧分配
+    QVector<float> m_columnMin;
+    QVector<float> m_columnMax;
+    QVector<bool> m_columnValid;
+
+    QColor m_lineColor;
+    QColor m_backgroundColor;
+    QColor m_gridColor;
+    QColor m_textColor;
+
+    QTimer* m_loadTimer;
+
+    bool m_dragging = false;
+    double m_dragLastX = 0.0;
+};
@@ -8,10 +8,54 @@
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QTabWidget>
+#include <QSettings>
+#include <QSignalBlocker>
+#include <QtMath>
+#include "rpeakdetector.h"
+#include "ecgreport.h"
+#include "ecgresampler.h"
+#include "waveletdenoiser.h"
 
-HistoryDialog::HistoryDialog(DataManager* dataManager, QWidget* parent)
+namespace {
+
+// 进度条刻度: 每秒10格
+constexpr int kSliderStepsPerSecond = 10;
+
+// 趋势图的时间桶数上限, 不少于趋势图的像素列数
+constexpr int kTrendBuckets = 2000;
+
+// 存储时间戳只精确到秒: 下一包比上一包按采样率推算的结束时刻晚出此值以上视为记录中断
+constexpr qint64 kSegmentGapToleranceMs = 1500;
+
+// 按时间戳把逐包存储的心电归并为若干段连续记录
+QVector<QVector<double>> contiguousRecords(const QVector<EcgSegment>& packets, int sampleRate)
+{
+    QVector<QVector<double>> records;
+    double next = 0.0;
+    for (const EcgSegment& packet : packets) {
+        if (records.isEmpty() || packet.timeMs > next + kSegmentGapToleranceMs) {
+            records.append(QVector<double>());
+            next = static_cast<double>(packet.timeMs);
+        }
+        records.last().append(packet.samples);
+        next = qMax(next, static_cast<double>(packet.timeMs)) + 1000.0 * packet.samples.size() / sampleRate;
+    }
+    return records;
+}
+
+QString formatPlaybackTime(double seconds)
+{
+    const int total = qMax(0, qFloor(seconds));
+    return QString("%1:%2").arg(total / 60, 2, 10, QLatin1Char('0'))
+                           .arg(total % 60, 2, 10, QLatin1Char('0'));
+}
+
+} // namespace
+
+HistoryDialog::HistoryDialog(DataManager* dataManager, int deviceSampleRate, QWidget* parent)
     : QDialog(parent)
     , m_dataManager(dataManager)
+    , m_deviceSampleRate(qMax(1, deviceSampleRate))
 {
     setWindowTitle(QStringLiteral("历史数据查询"));
     setMinimumSize(1200, 800);
@@ -74,17 +118,17 @@ void HistoryDialog::setupUI()
             padding: 5px;
             color: white;
         }
-        QTableWidget {
+        QTableView {
             background-color: #0d1f35;
             border: 1px solid #2a4a6a;
             border-radius: 5px;
             gridline-color: #2a4a6a;
             color: white;
         }
-        QTableWidget::item {
+        QTableView::item {
             padding: 5px;
         }
-        QTableWidget::item:selected {
+        QTableView::item:selected {
             background-color: #2a5a8c;
         }
         QHeaderView::section {
@@ -176,17 +220,18 @@ void HistoryDialog::setupUI()
     leftLayout->addWidget(statsGroup);
     
     // 数据表格
-    m_dataTable = new QTableWidget();
-    m_dataTable->setColumnCount(5);
-    m_dataTable->setHorizontalHeaderLabels({
-        QStringLiteral("时间"),
-        QStringLiteral("体温 (°C)"),
-        QStringLiteral("心率 (bpm)"),
-        QStringLiteral("血氧 (%)"),
-        QStringLiteral("心电数据")
-    });
+    // 表格只显示模型按批次读取的行; 行高固定、列宽按格式估算, 不逐行测量内容
+    m_tableModel = new VitalTableModel(m_dataManager, this);
+    m_dataTable = new QTableView();
+    m_dataTable->setModel(m_tableModel);
     m_dataTable->horizontalHeader()->setStretchLastSection(true);
+    m_dataTable->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    m_dataTable->verticalHeader()->setDefaultSectionSize(fontMetrics().height() + 6);
+    m_dataTable->setColumnWidth(VitalTableModel::TimeColumn,
+        fontMetrics().horizontalAdvance(QStringLiteral("0000-00-00 00:00:00")) + 16);
     m_dataTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_dataTable->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_dataTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
     m_dataTable->setAlternatingRowColors(true);
     
     leftLayout->addWidget(m_dataTable);
@@ -197,10 +242,13 @@ void HistoryDialog::setupUI()
     m_exportJsonButton = new QPushButton(QStringLiteral("📄 导出JSON"));
     m_playbackButton = new QPushButton(QStringLiteral("▶️ 回放心电"));
     m_playbackButton->setEnabled(false);
+    m_analyzeButton = new QPushButton(QStringLiteral("🩺 HRV分析"));
+    m_analyzeButton->setToolTip(QStringLiteral("对查询范围内的全部心电数据做零相位离线分析"));
     
     buttonLayout->addWidget(m_exportCsvButton);
     buttonLayout->addWidget(m_exportJsonButton);
     buttonLayout->addWidget(m_playbackButton);
+    buttonLayout->addWidget(m_analyzeButton);
     buttonLayout->addStretch();
     
     leftLayout->addLayout(buttonLayout);
@@ -212,9 +260,42 @@ void HistoryDialog::setupUI()
     
     m_chartWidget = new VitalsChartWidget(VitalsChartWidget::Combined);
     m_ecgWidget = new EcgChartWidget();
+    m_disclosureView = new FullDisclosureView();
+    m_disclosureView->setDataManager(m_dataManager);
+    m_disclosureView->setSampleRate(m_deviceSampleRate);
+    m_disclosureView->setToolTip(QStringLiteral("滚轮缩放, 拖动平移, 双击显示全程"));
+    
+    // 心电回放页: 波形 + 暂停/进度/倍速
+    QWidget* playbackTab = new QWidget();
+    QVBoxLayout* playbackLayout = new QVBoxLayout(playbackTab);
+    playbackLayout->setContentsMargins(0, 0, 0, 0);
+    playbackLayout->addWidget(m_ecgWidget, 1);
+    
+    QHBoxLayout* controlLayout = new QHBoxLayout();
+    m_pauseButton = new QPushButton(QStringLiteral("⏸ 暂停"));
+    m_pauseButton->setCheckable(true);
+    m_positionSlider = new QSlider(Qt::Horizontal);
+    m_positionSlider->setPageStep(5 * kSliderStepsPerSecond);
+    m_positionLabel = new QLabel(QStringLiteral("00:00 / 00:00"));
+    m_speedCombo = new QComboBox();
+    for (double speed : {0.5, 1.0, 2.0, 5.0, 10.0, 20.0}) {
+        m_speedCombo->addItem(QStringLiteral("%1x").arg(speed), speed);
+    }
+    m_speedCombo->setCurrentIndex(1);
+    
+    controlLayout->addWidget(m_pauseButton);
+    controlLayout->addWidget(m_positionSlider, 1);
+    controlLayout->addWidget(m_positionLabel);
+    controlLayout->addWidget(new QLabel(QStringLiteral("速度:")));
+    controlLayout->addWidget(m_speedCombo);
+    playbackLayout->addLayout(controlLayout);
+    
+    m_pauseButton->setEnabled(false);
+    m_positionSlider->setEnabled(false);
     
     chartTabs->addTab(m_chartWidget, QStringLiteral("趋势图"));
-    chartTabs->addTab(m_ecgWidget, QStringLiteral("心电图回放"));
+    chartTabs->addTab(playbackTab, QStringLiteral("心电图回放"));
+    chartTabs->addTab(m_disclosureView, QStringLiteral("全览心电"));
     
     splitter->addWidget(chartTabs);
     splitter->setSizes({500, 700});
@@ -228,7 +309,23 @@ void HistoryDialog::setupUI()
     connect(m_exportCsvButton, &QPushButton::clicked, this, &HistoryDialog::onExportCsvClicked);
     connect(m_exportJsonButton, &QPushButton::clicked, this, &HistoryDialog::onExportJsonClicked);
     connect(m_playbackButton, &QPushButton::clicked, this, &HistoryDialog::onPlaybackClicked);
-    connect(m_dataTable, &QTableWidget::itemSelectionChanged,
+    connect(m_analyzeButton, &QPushButton::clicked, this, &HistoryDialog::onAnalyzeClicked);
+    connect(m_pauseButton, &QPushButton::toggled, this, [this](bool paused) {
+        m_ecgWidget->setPlaybackPaused(paused);
+        m_pauseButton->setText(paused ? QStringLiteral("▶ 继续") : QStringLiteral("⏸ 暂停"));
+    });
+    connect(m_speedCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this]() {
+        m_ecgWidget->setPlaybackSpeed(m_speedCombo->currentData().toDouble());
+    });
+    // 拖动滑块时只更新时间显示, 松开后跳转; 点击滑轨或键盘调整立即跳转
+    connect(m_positionSlider, &QSlider::valueChanged, this, &HistoryDialog::onPositionSliderChanged);
+    connect(m_positionSlider, &QSlider::sliderReleased, this, [this]() {
+        onPositionSliderChanged(m_positionSlider->value());
+    });
+    connect(m_ecgWidget, &EcgChartWidget::playbackPositionChanged,
+            this, &HistoryDialog::onPlaybackPositionChanged);
+    connect(m_ecgWidget, &EcgChartWidget::playbackFinished, this, &HistoryDialog::onPlaybackFinished);
+    connect(m_dataTable->selectionModel(), &QItemSelectionModel::selectionChanged,
             this, &HistoryDialog::onTableSelectionChanged);
 }
 
@@ -237,6 +334,7 @@ void HistoryDialog::onTimeRangeChanged(int index)
     int minutes = m_timeRangeCombo->currentData().toInt();
     
     if (minutes > 0) {
+        m_chartWidget->setTimeRange(minutes);
         m_startDateTime->setDateTime(QDateTime::currentDateTime().addSecs(-minutes * 60));
         m_endDateTime->setDateTime(QDateTime::currentDateTime());
         m_startDateTime->setEnabled(false);
@@ -259,111 +357,131 @@ void HistoryDialog::loadData()
     QDateTime start = m_startDateTime->dateTime();
     QDateTime end = m_endDateTime->dateTime();
     
-    m_currentData = m_dataManager->getVitalDataRange(start, end);
-    populateTable(m_currentData);
-    updateStatistics(m_currentData);
-    
-    // 更新图表
-    QVector<QPair<QDateTime, double>> tempData;
-    QVector<QPair<QDateTime, int>> hrData;
-    QVector<QPair<QDateTime, int>> spo2Data;
-    
-    for (const VitalData& data : m_currentData) {
-        if (data.temperature > 0) {
-            tempData.append(qMakePair(data.timestamp, data.temperature));
-        }
-        if (data.heartRate > 0) {
-            hrData.append(qMakePair(data.timestamp, data.heartRate));
-        }
-        if (data.bloodOxygen > 0) {
-            spo2Data.append(qMakePair(data.timestamp, data.bloodOxygen));
-        }
-    }
-    
-    m_chartWidget->setData(tempData, hrData, spo2Data);
-}
-
-void HistoryDialog::populateTable(const QVector<VitalData>& data)
-{
-    m_dataTable->setRowCount(0);
-    m_dataTable->setRowCount(data.size());
-    
-    for (int i = 0; i < data.size(); ++i) {
-        const VitalData& d = data[i];
-        
-        m_dataTable->setItem(i, 0, new QTableWidgetItem(
-            d.timestamp.toString("yyyy-MM-dd HH:mm:ss")));
-        
-        m_dataTable->setItem(i, 1, new QTableWidgetItem(
-            d.temperature > 0 ? QString::number(d.temperature, 'f', 1) : "--"));
-        
-        m_dataTable->setItem(i, 2, new QTableWidgetItem(
-            d.heartRate > 0 ? QString::number(d.heartRate) : "--"));
-        
-        m_dataTable->setItem(i, 3, new QTableWidgetItem(
-            d.bloodOxygen > 0 ? QString::number(d.bloodOxygen) : "--"));
-        
-        m_dataTable->setItem(i, 4, new QTableWidgetItem(
-            d.ecgData.isEmpty() ? QStringLiteral("无") : 
-            QString("%1 点").arg(d.ecgData.size())));
-    }
+    // 表格只读第一批, 其余随滚动分页读取; 统计与趋势在数据库中聚合, 打开的开销与记录数无关
+    m_tableModel->setRange(start, end);
+    m_playbackButton->setEnabled(false);
+    updateStatistics(start, end);
+    m_chartWidget->setData(m_dataManager->getVitalTrend(start, end, kTrendBuckets));
     
-    m_dataTable->resizeColumnsToContents();
+    // 全览心电按需从数据库读取, 这里只设置范围
+    m_disclosureView->setRecordRange(start.toMSecsSinceEpoch(), end.toMSecsSinceEpoch());
 }
 
-void HistoryDialog::updateStatistics(const QVector<VitalData>& data)
+void HistoryDialog::updateStatistics(const QDateTime& start, const QDateTime& end)
 {
-    m_recordCountLabel->setText(QStringLiteral("记录数: %1").arg(data.size()));
+    m_recordCountLabel->setText(QStringLiteral("记录数: %1").arg(m_dataManager->getRecordCount(start, end)));
     
-    double sumTemp = 0, sumHr = 0, sumSpo2 = 0;
-    int countTemp = 0, countHr = 0, countSpo2 = 0;
+    // 平均值查询只统计有效值 (> 0), 无有效值时为 0
+    const double avgTemp = m_dataManager->getAverageTemperature(start, end);
+    const double avgHr = m_dataManager->getAverageHeartRate(start, end);
+    const double avgSpo2 = m_dataManager->getAverageBloodOxygen(start, end);
     
-    for (const VitalData& d : data) {
-        if (d.temperature > 0) { sumTemp += d.temperature; countTemp++; }
-        if (d.heartRate > 0) { sumHr += d.heartRate; countHr++; }
-        if (d.bloodOxygen > 0) { sumSpo2 += d.bloodOxygen; countSpo2++; }
-    }
-    
-    m_avgTempLabel->setText(countTemp > 0 ? 
-        QStringLiteral("平均体温: %1°C").arg(sumTemp / countTemp, 0, 'f', 1) :
+    m_avgTempLabel->setText(avgTemp > 0 ? 
+        QStringLiteral("平均体温: %1°C").arg(avgTemp, 0, 'f', 1) :
         QStringLiteral("平均体温: --°C"));
     
-    m_avgHrLabel->setText(countHr > 0 ? 
-        QStringLiteral("平均心率: %1 bpm").arg(qRound(sumHr / countHr)) :
+    m_avgHrLabel->setText(avgHr > 0 ? 
+        QStringLiteral("平均心率: %1 bpm").arg(qRound(avgHr)) :
         QStringLiteral("平均心率: -- bpm"));
     
-    m_avgSpo2Label->setText(countSpo2 > 0 ? 
-        QStringLiteral("平均血氧: %1%").arg(qRound(sumSpo2 / countSpo2)) :
+    m_avgSpo2Label->setText(avgSpo2 > 0 ? 
+        QStringLiteral("平均血氧: %1%").arg(qRound(avgSpo2)) :
         QStringLiteral("平均血氧: --%"));
 }
 
+int HistoryDialog::selectedRow() const
+{
+    const QModelIndexList rows = m_dataTable->selectionModel()->selectedRows();
+    return rows.isEmpty() ? -1 : rows.first().row();
+}
+
 void HistoryDialog::onTableSelectionChanged()
 {
-    QList<QTableWidgetItem*> selected = m_dataTable->selectedItems();
-    if (selected.isEmpty()) {
-        m_playbackButton->setEnabled(false);
-        return;
+    int row = selectedRow();
+    m_playbackButton->setEnabled(row >= 0 && m_tableModel->ecgCount(row) > 0);
+}
+
+void HistoryDialog::onPlaybackClicked()
+{
+    int row = selectedRow();
+    if (row < 0 || m_tableModel->ecgCount(row) <= 0) return;
+    
+    // 心电数据不随查询加载, 回放时按记录读取
+    QVector<double> ecgData = m_dataManager->getEcgData(m_tableModel->recordId(row));
+    if (!ecgData.isEmpty()) {
+        m_ecgWidget->startPlayback(ecgData, m_deviceSampleRate);
+        m_ecgWidget->setPlaybackSpeed(m_speedCombo->currentData().toDouble());
+        
+        {
+            QSignalBlocker blocker(m_positionSlider);
+            m_positionSlider->setRange(0, qCeil(m_ecgWidget->playbackDuration() * kSliderStepsPerSecond));
+            m_positionSlider->setValue(0);
+        }
+        m_positionSlider->setEnabled(true);
+        m_pauseButton->setEnabled(true);
+        m_pauseButton->setChecked(false);
+        onPlaybackPositionChanged(0.0);
     }
+}
+
+void HistoryDialog::onPlaybackPositionChanged(double seconds)
+{
+    m_positionLabel->setText(QString("%1 / %2").arg(formatPlaybackTime(seconds),
+                             formatPlaybackTime(m_ecgWidget->playbackDuration())));
+    if (m_positionSlider->isSliderDown()) return;
     
-    int row = selected.first()->row();
-    if (row >= 0 && row < m_currentData.size()) {
-        const VitalData& data = m_currentData[row];
-        m_playbackButton->setEnabled(!data.ecgData.isEmpty());
+    QSignalBlocker blocker(m_positionSlider);
+    m_positionSlider->setValue(qRound(seconds * kSliderStepsPerSecond));
+}
+
+void HistoryDialog::onPositionSliderChanged(int value)
+{
+    const double seconds = static_cast<double>(value) / kSliderStepsPerSecond;
+    if (m_positionSlider->isSliderDown()) {
+        m_positionLabel->setText(QString("%1 / %2").arg(formatPlaybackTime(seconds),
+                                 formatPlaybackTime(m_ecgWidget->playbackDuration())));
+        return;
     }
+    m_ecgWidget->seekPlayback(seconds);
 }
 
-void HistoryDialog::onPlaybackClicked()
+void HistoryDialog::onPlaybackFinished()
+{
+    // 回放停在末尾, 数据保留: 可拖动进度条回看, 或点击继续从头重播
+    QSignalBlocker blocker(m_pauseButton);
+    m_pauseButton->setChecked(true);
+    m_pauseButton->setText(QStringLiteral("▶ 继续"));
+}
+
+void HistoryDialog::onAnalyzeClicked()
 {
-    QList<QTableWidgetItem*> selected = m_dataTable->selectedItems();
-    if (selected.isEmpty()) return;
-    
-    int row = selected.first()->row();
-    if (row >= 0 && row < m_currentData.size()) {
-        const VitalData& data = m_currentData[row];
-        if (!data.ecgData.isEmpty()) {
-            m_ecgWidget->startPlayback(data.ecgData);
+    // 查询范围内的心电按时间戳分成连续段, 各段统一到200Hz (按设置先做小波去噪) 后分别做离线
+    // 零相位分析; 段间的中断既不参与滤波也不产生 R-R 间期
+    constexpr int kAnalysisRate = 200;
+    QSettings settings("HealthMonitor", "QtECG");
+    const bool denoise = settings.value("ecg/waveletDenoise", false).toBool();
+
+    QVector<QVector<double>> records = contiguousRecords(
+        m_dataManager->getEcgSegments(m_startDateTime->dateTime(), m_endDateTime->dateTime()),
+        m_deviceSampleRate);
+    for (QVector<double>& record : records) {
+        record = EcgResampler::resample(record, m_deviceSampleRate, kAnalysisRate);
+        if (denoise) {
+            record = WaveletDenoiser::denoise(record, kAnalysisRate);
         }
     }
+
+    RPeakDetector detector;
+    detector.setSampleRate(kAnalysisRate);
+    detector.analyzeSegments(records);
+
+    if (detector.detectedPeaks().size() < 2) {
+        QMessageBox::information(this, QStringLiteral("ECG分析"),
+                                 QStringLiteral("所选时间范围内心电数据不足，无法生成分析报告。"));
+        return;
+    }
+
+    EcgReport::show(this, detector.generateReport());
 }
 
 void HistoryDialog::onExportCsvClicked()
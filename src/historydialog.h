@@ -1,19 +1,23 @@
 #pragma once
 #include <QDialog>
 #include <QDateTimeEdit>
-#include <QTableWidget>
+#include <QTableView>
 #include <QPushButton>
 #include <QComboBox>
 #include <QLabel>
+#include <QSlider>
 #include "vitalschartwidget.h"
 #include "ecgchartwidget.h"
+#include "fulldisclosureview.h"
 #include "datamanager.h"
+#include "vitaltablemodel.h"
 
 class HistoryDialog : public QDialog {
     Q_OBJECT
 
 public:
-    explicit HistoryDialog(DataManager* dataManager, QWidget* parent = nullptr);
+    // deviceSampleRate: 存储的心电的设备采样率 (与主窗口实时显示一致)
+    HistoryDialog(DataManager* dataManager, int deviceSampleRate, QWidget* parent = nullptr);
     ~HistoryDialog();
 
 private slots:
@@ -22,15 +26,21 @@ private slots:
     void onExportJsonClicked();
     void onTableSelectionChanged();
     void onPlaybackClicked();
+    void onAnalyzeClicked();
+    void onPlaybackPositionChanged(double seconds);
+    void onPositionSliderChanged(int value);
+    void onPlaybackFinished();
     void onTimeRangeChanged(int index);
 
 private:
     void setupUI();
     void loadData();
-    void populateTable(const QVector<VitalData>& data);
-    void updateStatistics(const QVector<VitalData>& data);
+    void updateStatistics(const QDateTime& start, const QDateTime& end);
+    // 表格当前选中行, 无选中时为 -1
+    int selectedRow() const;
     
     DataManager* m_dataManager;
+    int m_deviceSampleRate;
     
     // 时间范围选择
     QComboBox* m_timeRangeCombo;
@@ -39,11 +49,19 @@ private:
     QPushButton* m_queryButton;
     
     // 数据表格
-    QTableWidget* m_dataTable;
+    QTableView* m_dataTable;
+    VitalTableModel* m_tableModel;
     
     // 图表
     VitalsChartWidget* m_chartWidget;
     EcgChartWidget* m_ecgWidget;
+    FullDisclosureView* m_disclosureView;
+    
+    // 回放控制
+    QPushButton* m_pauseButton;
+    QSlider* m_positionSlider;
+    QLabel* m_positionLabel;
+    QComboBox* m_speedCombo;
     
     // 统计信息
     QLabel* m_avgTempLabel;
@@ -55,6 +73,5 @@ private:
     QPushButton* m_exportCsvButton;
     QPushButton* m_exportJsonButton;
     QPushButton* m_playbackButton;
-    
-    QVector<VitalData> m_currentData;
+    QPushButton* m_analyzeButton;
 };
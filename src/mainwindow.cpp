@@ -1,6 +1,9 @@
 #include "mainwindow.h"
 #include "settingsdialog.h"
 #include "historydialog.h"
+#include "ecgreport.h"
+#include "renderticker.h"
+#include "centralstationwidget.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QGridLayout>
@@ -13,29 +16,57 @@
 #include <QtMath>
 #include <QRandomGenerator>
 #include <QToolBar>
+#include <QStackedWidget>
 #include <QStatusBar>
 #include <QScreen>
+#include <QStandardPaths>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+namespace {
+
+// R波检测器快照: 定期保存, 重启时若足够新则恢复, 免去学习期与心率空白
+constexpr int kDetectorStateSaveIntervalSec = 10;
+constexpr int kDetectorStateMaxAgeSec = 300;
+
+QString detectorStatePath()
+{
+    QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir().mkpath(dataDir);
+    return dataDir + "/rpeak_state.bin";
+}
+
+} // namespace
 
 MainWindow::MainWindow(QWidget* parent)
     : QMainWindow(parent)
     , m_mqttClient(new MqttClient(this))
     , m_dataManager(new DataManager(this))
     , m_alarmManager(new AlarmManager(m_dataManager, this))
+    , m_afDetector(new AfDetector(this))
+    , m_fixedDetector(new FixedPointRPeakDetector(this))
     , m_cloudSyncer(new CloudSyncer(m_dataManager, this))
     , m_updateTimer(new QTimer(this))
     , m_simulationTimer(new QTimer(this))
 {
+    // 金字塔按设备采样率排布心电样本, 打开数据库 (可能重建金字塔) 之前设置
+    m_dataManager->setEcgSampleRate(
+        QSettings("HealthMonitor", "QtECG").value("ecg/deviceSampleRate", 200).toInt());
     m_dataManager->initialize();
     
     setupUI();
     setupConnections();
     loadSettings();
+    restoreDetectorState();
     
     m_updateTimer->start(1000);
 }
 
 MainWindow::~MainWindow()
 {
+    saveDetectorState();
     saveSettings();
 }
 
@@ -154,6 +185,11 @@ void MainWindow::setupUI()
     m_historyButton->setFixedWidth(80);
     toolbar->addWidget(m_historyButton);
     
+    m_stationButton = new QPushButton(QStringLiteral("中央站"));
+    m_stationButton->setFixedWidth(80);
+    m_stationButton->setCheckable(true);
+    toolbar->addWidget(m_stationButton);
+    
     addToolBar(Qt::TopToolBarArea, toolbar);
     
     // 主内容区
@@ -243,7 +279,14 @@ void MainWindow::setupUI()
     
     mainLayout->addWidget(m_alarmFrame);
     
-    setCentralWidget(centralWidget);
+    // 中央站视图: 本机数据作为一个床位, 与单人监护页切换显示
+    m_stationView = new CentralStationWidget();
+    m_stationBed = m_stationView->addBed(QStringLiteral("本机"));
+    
+    m_pages = new QStackedWidget();
+    m_pages->addWidget(centralWidget);
+    m_pages->addWidget(m_stationView);
+    setCentralWidget(m_pages);
     
     // 状态栏
     m_connectionStatusLabel = new QLabel(QStringLiteral("未连接"));
@@ -367,6 +410,7 @@ void MainWindow::setupConnections()
     connect(m_mqttClient, &MqttClient::heartRateReceived, this, &MainWindow::onHeartRateReceived);
     connect(m_mqttClient, &MqttClient::bloodOxygenReceived, this, &MainWindow::onBloodOxygenReceived);
     connect(m_mqttClient, &MqttClient::ecgDataReceived, this, &MainWindow::onEcgDataReceived);
+    connect(m_mqttClient, &MqttClient::ecgAdcReceived, this, &MainWindow::onEcgAdcReceived);
     
     // 报警
     connect(m_alarmManager, &AlarmManager::alarmTriggered, this, &MainWindow::onAlarmTriggered);
@@ -378,12 +422,24 @@ void MainWindow::setupConnections()
     connect(m_historyButton, &QPushButton::clicked, this, &MainWindow::onHistoryClicked);
     connect(m_acknowledgeButton, &QPushButton::clicked, this, &MainWindow::onAcknowledgeAlarmClicked);
     connect(m_simulateButton, &QPushButton::clicked, this, &MainWindow::onSimulateDataClicked);
+    connect(m_stationButton, &QPushButton::toggled, this, [this](bool checked) {
+        m_pages->setCurrentIndex(checked ? 1 : 0);
+    });
     
-    // ECG R波检测心率
-    connect(m_ecgChart, &EcgChartWidget::heartRateFromEcg, this, [this](int bpm) {
-        m_currentHr = bpm;
-        m_hrValueLabel->setText(QString::number(bpm));
-        m_alarmManager->checkHeartRate(bpm);
+    // ECG R波检测心率 (图表浮点检测器与定点检测器同一时刻只有一个在工作)
+    connect(m_ecgChart, &EcgChartWidget::heartRateFromEcg, this, &MainWindow::onEcgHeartRate);
+    connect(m_fixedDetector, &FixedPointRPeakDetector::heartRateUpdated, this, &MainWindow::onEcgHeartRate);
+
+    // 房颤检测: 逐搏分析R-R序列, 发作时以起始时刻报警
+    connect(m_ecgChart, &EcgChartWidget::rPeakDetected, m_afDetector, &AfDetector::addBeat);
+    connect(m_fixedDetector, &FixedPointRPeakDetector::rPeakDetected, m_afDetector, &AfDetector::addBeat);
+    connect(m_afDetector, &AfDetector::afOnsetDetected, this, [this](const AfEpisode& episode) {
+        // 检测时间基准为样本时间, 按最近一搏换算为墙钟时间
+        const auto& peaks = m_fixedPathActive ? m_fixedDetector->detectedPeaks()
+                                              : m_ecgChart->rPeakDetector()->detectedPeaks();
+        double lagSeconds = peaks.isEmpty() ? 0.0 : peaks.last().timestamp - episode.onsetTime;
+        QDateTime onset = QDateTime::currentDateTime().addMSecs(-qRound64(lagSeconds * 1000.0));
+        m_alarmManager->reportAtrialFibrillation(onset, episode.irregularity);
     });
 
     // 定时器
@@ -414,10 +470,24 @@ void MainWindow::loadSettings()
     m_cloudSyncer->setDeviceId(settings.value("cloud/deviceId", "device_001").toString());
     
     m_ecgChart->setDisplayDuration(settings.value("display/ecgDuration", 5).toInt());
+    m_stationView->setDisplayDuration(settings.value("display/ecgDuration", 5).toInt());
+    RenderTicker::shared()->setFrameRate(settings.value("display/frameRate", RenderTicker::kDefaultFrameRate).toInt());
+    m_ecgChart->setRenderMode(settings.value("display/ecgSweepMode", false).toBool()
+        ? EcgChartWidget::RenderMode::Sweep : EcgChartWidget::RenderMode::Chart);
+    m_deviceSampleRate = settings.value("ecg/deviceSampleRate", 200).toInt();
+    m_ecgChart->setQrsAlgorithm(QrsDetector::algorithmFromKey(
+        settings.value("ecg/qrsAlgorithm").toString()));
+    if (!m_simulating) {
+        m_ecgChart->setInputSampleRate(m_deviceSampleRate);
+        m_stationView->setSampleRate(m_deviceSampleRate);
+    }
+    m_fixedPointDetection = settings.value("ecg/fixedPointDetection", false).toBool();
+    applyDetectionPath();
     
     // ECG滤波设置
     m_ecgChart->setFilterEnabled(settings.value("ecg/filterEnabled", true).toBool());
     m_ecgChart->setFilterCoefficient(settings.value("ecg/filterCoefficient", 0.25).toDouble());
+    m_ecgChart->setWaveletDenoiseEnabled(settings.value("ecg/waveletDenoise", false).toBool());
 
     applyDisplaySettings();
 }
@@ -430,6 +500,9 @@ void MainWindow::saveSettings()
 
 void MainWindow::onMqttConnected()
 {
+    // 断线期间的数据缺失, 重连后的第一个R-R间期不可信 (浮点与定点两条检测路径都要标记)
+    m_ecgChart->rPeakDetector()->markDiscontinuity();
+    m_fixedDetector->markDiscontinuity();
     updateConnectionStatus(true);
 }
 
@@ -535,14 +608,30 @@ void MainWindow::onBloodOxygenReceived(int spo2)
 void MainWindow::onEcgDataReceived(const QVector<double>& data)
 {
     m_ecgChart->addDataPoints(data);
+    m_stationView->appendEcg(m_stationBed, data);
     m_dataManager->saveEcgData(data);
     
     m_lastUpdateLabel->setText(QDateTime::currentDateTime().toString("HH:mm:ss"));
 }
 
+void MainWindow::onEcgAdcReceived(const QVector<qint16>& adcData)
+{
+    if (m_fixedPathActive) {
+        m_fixedDetector->processAdcSamples(adcData);
+    }
+}
+
+void MainWindow::onEcgHeartRate(int bpm)
+{
+    m_currentHr = bpm;
+    m_hrValueLabel->setText(QString::number(bpm));
+    m_alarmManager->checkHeartRate(bpm);
+}
+
 void MainWindow::onAlarmTriggered(const AlarmInfo& alarm)
 {
     showAlarmIndicator(true);
+    m_stationView->setAlarm(m_stationBed, true);
     m_alarmLabel->setText(alarm.message);
     m_acknowledgeButton->setEnabled(true);
 }
@@ -550,6 +639,7 @@ void MainWindow::onAlarmTriggered(const AlarmInfo& alarm)
 void MainWindow::onAlarmCleared()
 {
     showAlarmIndicator(false);
+    m_stationView->setAlarm(m_stationBed, false);
     m_acknowledgeButton->setEnabled(false);
 }
 
@@ -603,10 +693,27 @@ void MainWindow::onSettingsClicked()
         m_cloudSyncer->setDeviceId(dialog.getDeviceId());
         
         m_ecgChart->setDisplayDuration(dialog.getEcgDisplayDuration());
+        m_stationView->setDisplayDuration(dialog.getEcgDisplayDuration());
+        RenderTicker::shared()->setFrameRate(dialog.getRenderFrameRate());
+        m_ecgChart->setRenderMode(dialog.isEcgSweepMode()
+            ? EcgChartWidget::RenderMode::Sweep : EcgChartWidget::RenderMode::Chart);
+        m_deviceSampleRate = dialog.getEcgSampleRate();
+        m_dataManager->setEcgSampleRate(m_deviceSampleRate);
+        if (dialog.getQrsAlgorithm() != m_ecgChart->qrsAlgorithm()) {
+            m_ecgChart->setQrsAlgorithm(dialog.getQrsAlgorithm());
+            m_afDetector->reset();
+        }
+        if (!m_simulating) {
+            m_ecgChart->setInputSampleRate(m_deviceSampleRate);
+            m_stationView->setSampleRate(m_deviceSampleRate);
+        }
+        m_fixedPointDetection = dialog.isFixedPointDetectionEnabled();
+        applyDetectionPath();
         
         // 应用ECG滤波设置
         m_ecgChart->setFilterEnabled(dialog.isEcgFilterEnabled());
         m_ecgChart->setFilterCoefficient(dialog.getEcgFilterCoefficient());
+        m_ecgChart->setWaveletDenoiseEnabled(dialog.isEcgWaveletDenoiseEnabled());
 
         applyDisplaySettings();
     }
@@ -614,7 +721,7 @@ void MainWindow::onSettingsClicked()
 
 void MainWindow::onHistoryClicked()
 {
-    HistoryDialog dialog(m_dataManager, this);
+    HistoryDialog dialog(m_dataManager, m_deviceSampleRate, this);
     dialog.exec();
 }
 
@@ -625,11 +732,18 @@ void MainWindow::onAcknowledgeAlarmClicked()
 
 void MainWindow::onSimulateDataClicked()
 {
+    if (!m_simulating) {
+        // 模拟会清空检测器: 先保存设备数据的检测状态, 停止模拟后从中恢复
+        saveDetectorState();
+    }
     m_simulating = !m_simulating;
 
     if (m_simulating) {
         m_ecgChart->clear();
-        m_simPhase = 0.0;
+        m_ecgChart->setInputSampleRate(200);  // 模拟数据固定200Hz
+        m_stationView->setSampleRate(200);
+        m_simulator.reset();
+        applyDetectionPath();
         m_simulateButton->setText(QStringLiteral("停止"));
         m_simulateButton->setStyleSheet("background-color: #e67e22;");
         m_simulationTimer->start(50);  // 50ms × 10点/次 = 200Hz
@@ -638,53 +752,78 @@ void MainWindow::onSimulateDataClicked()
         m_simulateButton->setStyleSheet("");
         m_simulationTimer->stop();
         showEcgAnalysisReport();
+        // 检测器与波形中都是模拟数据, 清空后才能接设备数据, 也不会被当作设备的检测状态保存
+        m_ecgChart->clear();
+        m_afDetector->reset();
+        m_ecgChart->setInputSampleRate(m_deviceSampleRate);
+        m_stationView->setSampleRate(m_deviceSampleRate);
+        applyDetectionPath();
+        restoreDetectorState();
     }
 }
 
 void MainWindow::onUpdateTimer()
 {
     // 更新时间等
+    m_stationView->setVitals(m_stationBed, m_currentHr, m_currentSpo2, m_currentTemp);
+
+    if (++m_stateSaveCounter >= kDetectorStateSaveIntervalSec) {
+        m_stateSaveCounter = 0;
+        saveDetectorState();
+    }
 }
 
-void MainWindow::onSimulationTimer()
+void MainWindow::applyDetectionPath()
 {
-    static int ecgCounter = 0;
-    QVector<double> ecgData;
+    // ADC计数只随设备数据到达, 模拟数据总是由图表检测; 定点路径工作时图表不做R波检测
+    const bool fixedPath = m_fixedPointDetection && !m_simulating;
+    if (m_fixedDetector->sampleRate() != m_deviceSampleRate) {
+        m_fixedDetector->setSampleRate(m_deviceSampleRate);
+    }
+    if (fixedPath == m_fixedPathActive) return;
 
-    // 每50ms产生10个点 = 200Hz, 与图表采样率一致
-    for (int i = 0; i < 10; ++i) {
-        double t = fmod(m_simPhase, 1.0);  // 一个心跳周期 (~60bpm)
-        double value = 0;
+    m_fixedPathActive = fixedPath;
+    m_fixedDetector->reset();
+    m_ecgChart->setRPeakDetectionEnabled(!fixedPath);
+    // R-R序列换了来源, 前后间期不连续
+    m_afDetector->reset();
+}
 
-        // P波 (0.00 - 0.10s): 心房去极化
-        if (t >= 0.02 && t < 0.12) {
-            value = 30.0 * qSin(M_PI * (t - 0.02) / 0.10);
-        }
-        // Q波 (0.15 - 0.17s): QRS起始向下偏转
-        else if (t >= 0.15 && t < 0.17) {
-            value = -40.0 * qSin(M_PI * (t - 0.15) / 0.02);
-        }
-        // R波 (0.17 - 0.21s): 主峰, 尖锐向上
-        else if (t >= 0.17 && t < 0.21) {
-            value = 250.0 * qSin(M_PI * (t - 0.17) / 0.04);
-        }
-        // S波 (0.21 - 0.24s): QRS末尾向下
-        else if (t >= 0.21 && t < 0.24) {
-            value = -60.0 * qSin(M_PI * (t - 0.21) / 0.03);
-        }
-        // T波 (0.30 - 0.50s): 心室复极化, 较宽
-        else if (t >= 0.30 && t < 0.50) {
-            value = 50.0 * qSin(M_PI * (t - 0.30) / 0.20);
-        }
+void MainWindow::saveDetectorState()
+{
+    // 只保存设备实时数据的检测状态, 模拟数据与定点路径不参与
+    QrsDetector* detector = m_ecgChart->rPeakDetector();
+    if (m_simulating || m_fixedPathActive || detector->samplesProcessed() == 0) return;
 
-        // 加入少量噪声
-        value += (QRandomGenerator::global()->bounded(100) - 50) / 10.0;
+    QSaveFile file(detectorStatePath());
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(detector->saveState());
+        file.commit();
+    }
+}
+
+void MainWindow::restoreDetectorState()
+{
+    if (m_fixedPathActive) return;
+    QFileInfo info(detectorStatePath());
+    if (!info.exists()) return;
+    if (info.lastModified().secsTo(QDateTime::currentDateTime()) > kDetectorStateMaxAgeSec) return;
 
-        ecgData.append(value);
-        m_simPhase += 1.0 / 200.0;  // 200Hz采样率
+    QFile file(info.filePath());
+    if (file.open(QIODevice::ReadOnly)) {
+        m_ecgChart->restoreDetectorState(file.readAll());
     }
+}
+
+void MainWindow::onSimulationTimer()
+{
+    static int ecgCounter = 0;
+
+    // 每50ms产生10个点 = 200Hz, 与图表采样率一致
+    QVector<double> ecgData = m_simulator.generate(10);
 
     m_ecgChart->addDataPoints(ecgData);
+    m_stationView->appendEcg(m_stationBed, ecgData);
 
     ecgCounter++;
     if (ecgCounter >= 20) {  // 每秒更新一次体征数据
@@ -719,106 +858,12 @@ void MainWindow::updateVitalDisplay(const QString& type, double value, const QSt
 
 void MainWindow::showEcgAnalysisReport()
 {
-    RPeakDetector* detector = m_ecgChart->rPeakDetector();
+    QrsDetector* detector = m_ecgChart->rPeakDetector();
     if (!detector || detector->detectedPeaks().size() < 2) {
         QMessageBox::information(this, QStringLiteral("ECG分析"),
                                  QStringLiteral("数据不足，无法生成分析报告。\n请至少采集5秒以上的数据。"));
         return;
     }
 
-    auto report = detector->generateReport();
-
-    QString html;
-    html += QStringLiteral("<h2 style='color:#00d9ff;'>ECG R波分析报告</h2>");
-    html += QStringLiteral("<hr>");
-
-    // 基本信息
-    html += QStringLiteral("<h3>基本信息</h3>");
-    html += QStringLiteral("<table cellpadding='4'>");
-    html += QStringLiteral("<tr><td><b>检测到R波数:</b></td><td>%1 个</td></tr>").arg(report.totalPeaks);
-    html += QStringLiteral("<tr><td><b>分析时长:</b></td><td>%1 秒</td></tr>").arg(report.durationSeconds, 0, 'f', 1);
-    html += QStringLiteral("</table>");
-
-    // 心率统计
-    html += QStringLiteral("<h3>心率统计</h3>");
-    html += QStringLiteral("<table cellpadding='4'>");
-    html += QStringLiteral("<tr><td><b>平均心率:</b></td><td>%1 bpm</td></tr>").arg(report.avgHR, 0, 'f', 1);
-    html += QStringLiteral("<tr><td><b>最低心率:</b></td><td>%1 bpm</td></tr>").arg(report.minHR, 0, 'f', 1);
-    html += QStringLiteral("<tr><td><b>最高心率:</b></td><td>%1 bpm</td></tr>").arg(report.maxHR, 0, 'f', 1);
-    html += QStringLiteral("<tr><td><b>心率标准差:</b></td><td>%1 bpm</td></tr>").arg(report.stdHR, 0, 'f', 2);
-    html += QStringLiteral("</table>");
-
-    // R-R间期
-    html += QStringLiteral("<h3>R-R间期分析</h3>");
-    html += QStringLiteral("<table cellpadding='4'>");
-    html += QStringLiteral("<tr><td><b>平均R-R间期:</b></td><td>%1 ms</td></tr>").arg(report.avgRR, 0, 'f', 1);
-    html += QStringLiteral("<tr><td><b>最短R-R间期:</b></td><td>%1 ms</td></tr>").arg(report.minRR, 0, 'f', 1);
-    html += QStringLiteral("<tr><td><b>最长R-R间期:</b></td><td>%1 ms</td></tr>").arg(report.maxRR, 0, 'f', 1);
-    html += QStringLiteral("<tr><td><b>R-R间期标准差:</b></td><td>%1 ms</td></tr>").arg(report.stdRR, 0, 'f', 2);
-    html += QStringLiteral("</table>");
-
-    // HRV指标
-    html += QStringLiteral("<h3>心率变异性 (HRV)</h3>");
-    html += QStringLiteral("<table cellpadding='4'>");
-    html += QStringLiteral("<tr><td><b>SDNN:</b></td><td>%1 ms</td><td style='color:#8892b0;'>R-R间期标准差</td></tr>").arg(report.sdnn, 0, 'f', 2);
-    html += QStringLiteral("<tr><td><b>RMSSD:</b></td><td>%1 ms</td><td style='color:#8892b0;'>相邻R-R差值均方根</td></tr>").arg(report.rmssd, 0, 'f', 2);
-    html += QStringLiteral("<tr><td><b>pNN50:</b></td><td>%1 %</td><td style='color:#8892b0;'>差值>50ms的百分比</td></tr>").arg(report.pnn50, 0, 'f', 1);
-    html += QStringLiteral("</table>");
-
-    // R波幅值
-    html += QStringLiteral("<h3>R波幅值</h3>");
-    html += QStringLiteral("<table cellpadding='4'>");
-    html += QStringLiteral("<tr><td><b>平均幅值:</b></td><td>%1 mV</td></tr>").arg(report.avgAmplitude, 0, 'f', 1);
-    html += QStringLiteral("<tr><td><b>最小幅值:</b></td><td>%1 mV</td></tr>").arg(report.minAmplitude, 0, 'f', 1);
-    html += QStringLiteral("<tr><td><b>最大幅值:</b></td><td>%1 mV</td></tr>").arg(report.maxAmplitude, 0, 'f', 1);
-    html += QStringLiteral("</table>");
-
-    // 医学评估
-    html += QStringLiteral("<h3 style='color:#f39c12;'>医学评估</h3>");
-    for (const QString& finding : report.findings) {
-        QString color = "#2ecc71";  // 绿色=正常
-        if (finding.contains(QStringLiteral("过缓")) || finding.contains(QStringLiteral("过速")) ||
-            finding.contains(QStringLiteral("早搏")) || finding.contains(QStringLiteral("不齐")) ||
-            finding.contains(QStringLiteral("偏低")) || finding.contains(QStringLiteral("变异较大"))) {
-            color = "#e74c3c";  // 红色=异常
-        }
-        html += QStringLiteral("<p style='color:%1;'>%2</p>").arg(color, finding);
-    }
-
-    // 建议
-    html += QStringLiteral("<h3 style='color:#3498db;'>建议</h3>");
-    for (const QString& suggestion : report.suggestions) {
-        html += QStringLiteral("<p>%1</p>").arg(suggestion);
-    }
-
-    html += QStringLiteral("<hr><p style='color:#8892b0; font-size:11px;'>"
-                           "注: 本分析仅供参考，不构成医学诊断。如有异常请咨询专业医生。</p>");
-
-    // 使用QMessageBox显示报告
-    QMessageBox msgBox(this);
-    msgBox.setWindowTitle(QStringLiteral("ECG R波分析报告"));
-    msgBox.setTextFormat(Qt::RichText);
-    msgBox.setText(html);
-    msgBox.setStyleSheet(R"(
-        QMessageBox {
-            background-color: #1a1a2e;
-        }
-        QMessageBox QLabel {
-            color: #eaeaea;
-            min-width: 480px;
-            min-height: 400px;
-        }
-        QPushButton {
-            background-color: #1f4068;
-            color: white;
-            border: none;
-            border-radius: 6px;
-            padding: 8px 24px;
-            font-weight: bold;
-        }
-        QPushButton:hover {
-            background-color: #2a5a8c;
-        }
-    )");
-    msgBox.exec();
+    EcgReport::show(this, detector->generateReport());
 }
@@ -10,6 +10,12 @@
 #include "cloudsyncer.h"
 #include "ecgchartwidget.h"
 #include "vitalschartwidget.h"
+#include "ecgsimulator.h"
+#include "afdetector.h"
+#include "fixedrpeakdetector.h"
+
+class CentralStationWidget;
+class QStackedWidget;
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
@@ -30,6 +36,8 @@ private slots:
     void onHeartRateReceived(int hr);
     void onBloodOxygenReceived(int spo2);
     void onEcgDataReceived(const QVector<double>& data);
+    void onEcgAdcReceived(const QVector<qint16>& adcData);
+    void onEcgHeartRate(int bpm);
     
     // Alarm slots
     void onAlarmTriggered(const AlarmInfo& alarm);
@@ -56,6 +64,10 @@ private:
     void showAlarmIndicator(bool show);
     void applyDisplaySettings();
     void showEcgAnalysisReport();
+    void saveDetectorState();
+    void restoreDetectorState();
+    // 按设置与模拟状态选择设备心电的R波检测路径 (图表浮点检测器或定点检测器)
+    void applyDetectionPath();
     
     QWidget* createVitalCard(const QString& title, const QString& value, 
                               const QString& unit, const QColor& color, 
@@ -68,12 +80,19 @@ private:
     MqttClient* m_mqttClient;
     DataManager* m_dataManager;
     AlarmManager* m_alarmManager;
+    AfDetector* m_afDetector;
+    FixedPointRPeakDetector* m_fixedDetector;
     CloudSyncer* m_cloudSyncer;
     
     // Charts
     EcgChartWidget* m_ecgChart;
     VitalsChartWidget* m_vitalsChart;
     
+    // 中央站视图 (与监护页共用中心区域)
+    QStackedWidget* m_pages;
+    CentralStationWidget* m_stationView;
+    int m_stationBed = -1;
+    
     // Vital value labels
     QLabel* m_tempValueLabel;
     QLabel* m_hrValueLabel;
@@ -93,6 +112,7 @@ private:
     QPushButton* m_historyButton;
     QPushButton* m_acknowledgeButton;
     QPushButton* m_simulateButton;
+    QPushButton* m_stationButton;
     
     // Vital card widgets (for show/hide)
     QWidget* m_tempCard = nullptr;
@@ -114,8 +134,12 @@ private:
     double m_currentTemp = 0.0;
     int m_currentHr = 0;
     int m_currentSpo2 = 0;
+    int m_deviceSampleRate = 200;  // 设备心电采样率
+    bool m_fixedPointDetection = false;  // 设置: 设备心电用定点路径检测
+    bool m_fixedPathActive = false;      // 定点路径正在工作 (设置开启且未在模拟)
+    int m_stateSaveCounter = 0;    // 检测器快照保存计时 (秒)
     
     // Simulation
     bool m_simulating = false;
-    double m_simPhase = 0.0;
+    EcgSimulator m_simulator;  // 默认60bpm/200Hz, 与原模拟波形一致
 };
@@ -269,6 +269,7 @@ void MqttClient::parseBloodOxygen(const QByteArray& data)
 void MqttClient::parseEcgData(const QByteArray& data)
 {
     QVector<double> ecgData;
+    QVector<qint16> adcData;
     
     // ADC转电压参数: 0-4095 ADC值对应 0-3.3V
     // 以2048(1.65V)为中点，转换为mV单位
@@ -288,6 +289,8 @@ void MqttClient::parseEcgData(const QByteArray& data)
     if (ok && singleValue >= 0 && singleValue <= 4095) {
         // 单个ADC值
         ecgData.append(adcToMillivolts(singleValue));
+        adcData.append(static_cast<qint16>(singleValue));
+        emit ecgAdcReceived(adcData);
         emit ecgDataReceived(ecgData);
         return;
     }
@@ -298,7 +301,9 @@ void MqttClient::parseEcgData(const QByteArray& data)
     if (doc.isArray()) {
         QJsonArray arr = doc.array();
         for (const QJsonValue& val : arr) {
-            ecgData.append(adcToMillivolts(val.toInt()));
+            int adcValue = val.toInt();
+            ecgData.append(adcToMillivolts(adcValue));
+            adcData.append(static_cast<qint16>(qBound(0, adcValue, 4095)));
         }
     } else if (doc.isObject()) {
         QJsonObject obj = doc.object();
@@ -307,11 +312,14 @@ void MqttClient::parseEcgData(const QByteArray& data)
         if (arr.isEmpty()) arr = obj["values"].toArray();
         
         for (const QJsonValue& val : arr) {
-            ecgData.append(adcToMillivolts(val.toInt()));
+            int adcValue = val.toInt();
+            ecgData.append(adcToMillivolts(adcValue));
+            adcData.append(static_cast<qint16>(qBound(0, adcValue, 4095)));
         }
     }
     
     if (!ecgData.isEmpty()) {
+        emit ecgAdcReceived(adcData);
         emit ecgDataReceived(ecgData);
     }
 }
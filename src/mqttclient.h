@@ -30,6 +30,7 @@ signals:
     void heartRateReceived(int heartRate);
     void bloodOxygenReceived(int spo2);
     void ecgDataReceived(const QVector<double>& ecgData);
+    void ecgAdcReceived(const QVector<qint16>& adcData);  // 原始ADC计数, 供定点检测路径使用
     void vitalDataReceived(const VitalData& data);
     void statusChanged(const QString& status);
 
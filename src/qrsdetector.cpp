@@ -0,0 +1,567 @@
+#include "qrsdetector.h"
+#include "rpeakdetector.h"
+#include "waveletqrsdetector.h"
+#include "envelopeqrsdetector.h"
+#include "ecgdelineator.h"
+#include <QtMath>
+#include <QDataStream>
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+// 快照格式标识, 字段变化时递增版本
+constexpr quint32 kSnapshotMagic = 0x52504b53;  // "RPKS"
+constexpr quint16 kSnapshotVersion = 2;
+
+} // namespace
+
+// ============================================================
+// 算法选择
+// ============================================================
+
+QrsDetector* QrsDetector::create(Algorithm algorithm, QObject* parent)
+{
+    switch (algorithm) {
+    case Algorithm::Wavelet:  return new WaveletQrsDetector(parent);
+    case Algorithm::Envelope: return new EnvelopeQrsDetector(parent);
+    case Algorithm::PanTompkins:
+    default:
+        return new RPeakDetector(parent);
+    }
+}
+
+QList<QrsDetector::Algorithm> QrsDetector::algorithms()
+{
+    return { Algorithm::PanTompkins, Algorithm::Wavelet, Algorithm::Envelope };
+}
+
+QString QrsDetector::algorithmKey(Algorithm algorithm)
+{
+    switch (algorithm) {
+    case Algorithm::Wavelet:  return QStringLiteral("wavelet");
+    case Algorithm::Envelope: return QStringLiteral("envelope");
+    case Algorithm::PanTompkins:
+    default:
+        return QStringLiteral("pan-tompkins");
+    }
+}
+
+QrsDetector::Algorithm QrsDetector::algorithmFromKey(const QString& key)
+{
+    for (Algorithm algorithm : algorithms()) {
+        if (algorithmKey(algorithm) == key) return algorithm;
+    }
+    return Algorithm::PanTompkins;
+}
+
+QString QrsDetector::algorithmName(Algorithm algorithm)
+{
+    switch (algorithm) {
+    case Algorithm::Wavelet:  return QStringLiteral("小波变换 (抗噪)");
+    case Algorithm::Envelope: return QStringLiteral("差分包络 (低功耗)");
+    case Algorithm::PanTompkins:
+    default:
+        return QStringLiteral("Pan-Tompkins (默认)");
+    }
+}
+
+// ============================================================
+// 逐点流程
+// ============================================================
+
+QrsDetector::QrsDetector(QObject* parent)
+    : QObject(parent)
+    , m_delineationWork(new EcgDelineator::Workspace())
+{
+}
+
+QrsDetector::~QrsDetector() = default;
+
+void QrsDetector::setSampleRate(int sampleRate)
+{
+    m_sampleRate = sampleRate;
+    configure();
+    reset();
+}
+
+void QrsDetector::reset()
+{
+    m_globalIndex = 0;
+    m_discontinuityIndex = 0;
+    m_originalBuf.clear();
+    m_originalBufStart = 0;
+    m_peaks.clear();
+    m_beats.clear();
+    m_intervalTotals = IntervalTotals();
+    m_currentHR = 0;
+    m_pendingBeats.clear();
+    resetDetector();
+}
+
+void QrsDetector::processSample(double value)
+{
+    beginSample(value);
+    detect(value);
+    endSample();
+}
+
+void QrsDetector::processSamples(const QVector<double>& values)
+{
+    for (double value : values) {
+        processSample(value);
+    }
+}
+
+void QrsDetector::beginSample(double value)
+{
+    // 保存原始值用于回溯找R波真实幅值
+    m_originalBuf.push_back(value);
+    // 保留最近2秒数据
+    int maxBuf = m_sampleRate * 2;
+    while (static_cast<int>(m_originalBuf.size()) > maxBuf) {
+        m_originalBuf.pop_front();
+        m_originalBufStart++;
+    }
+}
+
+void QrsDetector::endSample()
+{
+    if (!m_pendingBeats.empty()) {
+        delineatePending();
+    }
+    m_globalIndex++;
+}
+
+void QrsDetector::setDelineationEnabled(bool enabled)
+{
+    m_delineationEnabled = enabled;
+    if (!enabled) {
+        m_pendingBeats.clear();
+    }
+}
+
+int QrsDetector::findRawMaximum(int from, int to) const
+{
+    from = qMax(from, qMax(m_originalBufStart, m_discontinuityIndex));
+    to = qMin(to, m_originalBufStart + static_cast<int>(m_originalBuf.size()) - 1);
+    if (from > to) return -1;
+
+    int best = from;
+    for (int i = from + 1; i <= to; ++i) {
+        if (m_originalBuf[i - m_originalBufStart] > m_originalBuf[best - m_originalBufStart]) best = i;
+    }
+    return best;
+}
+
+void QrsDetector::reportPeak(int sampleIndex, double amplitude)
+{
+    RPeakInfo peak;
+    peak.sampleIndex = sampleIndex;
+    peak.amplitude = amplitude;
+    peak.timestamp = static_cast<double>(sampleIndex) / m_sampleRate;
+
+    if (!m_peaks.isEmpty() && m_peaks.last().sampleIndex >= m_discontinuityIndex) {
+        const RPeakInfo& prev = m_peaks.last();
+        peak.rrInterval = peak.timestamp - prev.timestamp;
+        peak.instantHR = peak.rrInterval > 0.0 ? 60.0 / peak.rrInterval : 0.0;
+    } else {
+        peak.rrInterval = 0.0;
+        peak.instantHR = 0.0;
+    }
+
+    m_peaks.append(peak);
+    if (m_delineationEnabled) {
+        m_pendingBeats.push_back(m_peaks.size() - 1);
+    }
+    updateHeartRate();
+
+    emit rPeakDetected(peak);
+}
+
+// ============================================================
+// 特征点定位: R波检出后等T波窗口数据进入原始缓冲, 再在缓冲内的小窗口中定位
+// ============================================================
+
+void QrsDetector::delineatePending(bool flush)
+{
+    while (!m_pendingBeats.empty()) {
+        const RPeakInfo& peak = m_peaks[m_pendingBeats.front()];
+        int after = EcgDelineator::samplesAfter(m_sampleRate, peak.rrInterval);
+        if (!flush && m_globalIndex < peak.sampleIndex + after) return;
+
+        int start = qMax(m_originalBufStart, peak.sampleIndex - EcgDelineator::samplesBefore(m_sampleRate));
+        int end = qMin(m_originalBufStart + static_cast<int>(m_originalBuf.size()) - 1,
+                       peak.sampleIndex + after);
+        m_delineationBuf.resize(end - start + 1);
+        for (int i = start; i <= end; ++i) {
+            m_delineationBuf[i - start] = m_originalBuf[i - m_originalBufStart];
+        }
+
+        BeatInfo beat = EcgDelineator::delineate(peak, m_delineationBuf.constData(),
+                                                 m_delineationBuf.size(), start, m_sampleRate,
+                                                 *m_delineationWork);
+        appendBeat(beat);
+        m_pendingBeats.pop_front();
+        emit beatDelineated(beat);
+    }
+}
+
+void QrsDetector::appendBeat(const BeatInfo& beat)
+{
+    // 各项只对成功定位该特征点的心搏累计
+    if (beat.qrsOnset >= 0) {
+        IntervalTotals& t = m_intervalTotals;
+        t.beats++;
+        t.qrsWidth += beat.qrsWidthMs;
+        t.st += beat.stLevel;
+        if (beat.hasPWave()) {
+            t.pr += beat.prIntervalMs;
+            t.prCount++;
+        }
+        if (beat.tEnd >= 0) {
+            t.qt += beat.qtIntervalMs;
+            t.qtCount++;
+            if (beat.qtcMs > 0.0) {
+                t.qtc += beat.qtcMs;
+                t.qtcCount++;
+            }
+        }
+    }
+
+    // 逐搏结果攒到两倍上限再成批丢弃最旧的, 均摊 O(1)
+    m_beats.append(beat);
+    if (m_beats.size() >= 2 * kBeatHistory) {
+        m_beats.remove(0, m_beats.size() - kBeatHistory);
+    }
+}
+
+
+// ============================================================
+// 状态快照与输入中断
+// ============================================================
+
+QByteArray QrsDetector::saveState() const
+{
+    QByteArray state;
+    QDataStream out(&state, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+
+    out << kSnapshotMagic << kSnapshotVersion
+        << qint32(static_cast<int>(algorithm())) << qint32(m_sampleRate);
+
+    out << qint32(m_globalIndex) << qint32(m_discontinuityIndex);
+
+    out << qint32(m_originalBufStart) << quint32(m_originalBuf.size());
+    for (double v : m_originalBuf) out << v;
+
+    // 最近的R波; 待定位心搏的下标换算为快照内下标
+    const int firstPeak = qMax(0, m_peaks.size() - kSnapshotPeaks);
+    out << quint32(m_peaks.size() - firstPeak);
+    for (int i = firstPeak; i < m_peaks.size(); ++i) {
+        const RPeakInfo& p = m_peaks[i];
+        out << qint32(p.sampleIndex) << p.amplitude << p.timestamp << p.rrInterval << p.instantHR;
+    }
+    QVector<qint32> pending;
+    for (int idx : m_pendingBeats) {
+        if (idx >= firstPeak) pending.append(idx - firstPeak);
+    }
+    out << pending << qint32(m_currentHR);
+
+    // 算法内部状态放在最后, 恢复时公共部分已解析成功
+    saveDetectorState(out);
+
+    return state;
+}
+
+bool QrsDetector::restoreState(const QByteArray& state)
+{
+    QDataStream in(state);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    qint32 algorithmId = -1;
+    qint32 sampleRate = 0;
+    in >> magic >> version >> algorithmId >> sampleRate;
+    if (in.status() != QDataStream::Ok || magic != kSnapshotMagic ||
+        version != kSnapshotVersion || algorithmId != static_cast<int>(algorithm()) ||
+        sampleRate != m_sampleRate) {
+        return false;
+    }
+
+    // 先解析到临时对象, 全部成功后再替换当前状态
+    qint32 globalIndex, discontinuityIndex;
+    in >> globalIndex >> discontinuityIndex;
+
+    qint32 originalBufStart;
+    quint32 originalCount;
+    in >> originalBufStart >> originalCount;
+    if (in.status() != QDataStream::Ok || originalCount > static_cast<quint32>(m_sampleRate * 2)) {
+        return false;
+    }
+    std::deque<double> originalBuf(originalCount);
+    for (double& v : originalBuf) in >> v;
+
+    quint32 peakCount;
+    in >> peakCount;
+    if (in.status() != QDataStream::Ok || peakCount > static_cast<quint32>(kSnapshotPeaks)) {
+        return false;
+    }
+    QVector<RPeakInfo> peaks(peakCount);
+    for (RPeakInfo& p : peaks) {
+        qint32 sampleIndex;
+        in >> sampleIndex >> p.amplitude >> p.timestamp >> p.rrInterval >> p.instantHR;
+        p.sampleIndex = sampleIndex;
+    }
+    QVector<qint32> pending;
+    qint32 currentHR;
+    in >> pending >> currentHR;
+    if (in.status() != QDataStream::Ok) return false;
+    for (qint32 idx : pending) {
+        if (idx < 0 || idx >= peaks.size()) return false;
+    }
+
+    // 算法状态最后解析, 成功时由派生类自行替换
+    if (!restoreDetectorState(in)) return false;
+
+    m_globalIndex = globalIndex;
+    m_discontinuityIndex = discontinuityIndex;
+    m_originalBufStart = originalBufStart;
+    m_originalBuf = std::move(originalBuf);
+    m_peaks = peaks;
+    m_beats.clear();
+    m_intervalTotals = IntervalTotals();
+    m_pendingBeats.assign(pending.begin(), pending.end());
+    m_currentHR = currentHR;
+
+    if (m_currentHR > 0) {
+        emit heartRateUpdated(m_currentHR);
+    }
+    return true;
+}
+
+void QrsDetector::markDiscontinuity()
+{
+    // 中断前未完成的心搏用已有数据定位, 不再等待 (后续数据与之不连续)
+    delineatePending(true);
+
+    m_discontinuityIndex = m_globalIndex;
+    discontinuity();
+}
+
+// ============================================================
+// 心率与分析报告
+// ============================================================
+
+void QrsDetector::updateHeartRate()
+{
+    // 用最近8个R-R间隔计算平均心率
+    int count = m_peaks.size();
+    if (count < 2) return;
+
+    // 跨越输入中断的心搏 R-R 为0, 不参与平均
+    int n = 0;
+    double sumRR = 0.0;
+    for (int i = count - 1; i >= qMax(1, count - 8); --i) {
+        if (m_peaks[i].rrInterval > 0.0) {
+            sumRR += m_peaks[i].rrInterval;
+            n++;
+        }
+    }
+    if (n == 0) return;
+
+    double avgRR = sumRR / n;
+    if (avgRR > 0.0) {
+        int hr = qRound(60.0 / avgRR);
+        // 合理范围 30-220 bpm
+        if (hr >= 30 && hr <= 220) {
+            m_currentHR = hr;
+            emit heartRateUpdated(m_currentHR);
+        }
+    }
+}
+
+double QrsDetector::lastRRInterval() const
+{
+    if (m_peaks.size() < 2) return 0.0;
+    return m_peaks.last().rrInterval;
+}
+
+QrsDetector::AnalysisReport QrsDetector::generateReport() const
+{
+    AnalysisReport report;
+    report.totalPeaks = m_peaks.size();
+
+    if (m_peaks.size() < 2) {
+        report.findings.append(QStringLiteral("数据不足，无法进行有效分析（至少需要2个R波）"));
+        return report;
+    }
+
+    report.durationSeconds = m_peaks.last().timestamp - m_peaks.first().timestamp;
+
+    // ---- 收集有效的R-R间期和瞬时心率 ----
+    QVector<double> rrIntervals;  // 秒
+    QVector<double> heartRates;   // bpm
+    QVector<double> amplitudes;
+
+    for (int i = 0; i < m_peaks.size(); ++i) {
+        amplitudes.append(m_peaks[i].amplitude);
+        if (i > 0 && m_peaks[i].rrInterval > 0.0) {
+            rrIntervals.append(m_peaks[i].rrInterval);
+            heartRates.append(m_peaks[i].instantHR);
+        }
+    }
+
+    if (rrIntervals.isEmpty()) return report;
+
+    // ---- 心率统计 ----
+    double sumHR = std::accumulate(heartRates.begin(), heartRates.end(), 0.0);
+    report.avgHR = sumHR / heartRates.size();
+    report.minHR = *std::min_element(heartRates.begin(), heartRates.end());
+    report.maxHR = *std::max_element(heartRates.begin(), heartRates.end());
+
+    double sqSumHR = 0.0;
+    for (double hr : heartRates) sqSumHR += (hr - report.avgHR) * (hr - report.avgHR);
+    report.stdHR = qSqrt(sqSumHR / heartRates.size());
+
+    // ---- R-R间期统计 (转ms) ----
+    QVector<double> rrMs;
+    for (double rr : rrIntervals) rrMs.append(rr * 1000.0);
+
+    double sumRR = std::accumulate(rrMs.begin(), rrMs.end(), 0.0);
+    report.avgRR = sumRR / rrMs.size();
+    report.minRR = *std::min_element(rrMs.begin(), rrMs.end());
+    report.maxRR = *std::max_element(rrMs.begin(), rrMs.end());
+
+    double sqSumRR = 0.0;
+    for (double rr : rrMs) sqSumRR += (rr - report.avgRR) * (rr - report.avgRR);
+    report.stdRR = qSqrt(sqSumRR / rrMs.size());
+
+    // ---- HRV 指标 ----
+    // SDNN: R-R间期标准差
+    report.sdnn = report.stdRR;
+
+    // RMSSD: 相邻R-R间期差值的均方根
+    double sumDiffSq = 0.0;
+    int nn50Count = 0;
+    for (int i = 1; i < rrMs.size(); ++i) {
+        double diff = rrMs[i] - rrMs[i - 1];
+        sumDiffSq += diff * diff;
+        if (qAbs(diff) > 50.0) nn50Count++;
+    }
+    if (rrMs.size() > 1) {
+        report.rmssd = qSqrt(sumDiffSq / (rrMs.size() - 1));
+        report.pnn50 = 100.0 * nn50Count / (rrMs.size() - 1);
+    }
+
+    // ---- R波幅值统计 ----
+    double sumAmp = std::accumulate(amplitudes.begin(), amplitudes.end(), 0.0);
+    report.avgAmplitude = sumAmp / amplitudes.size();
+    report.minAmplitude = *std::min_element(amplitudes.begin(), amplitudes.end());
+    report.maxAmplitude = *std::max_element(amplitudes.begin(), amplitudes.end());
+
+    // ---- 波形间期统计: 各项只对成功定位该特征点的心搏取平均 ----
+    const IntervalTotals& t = m_intervalTotals;
+    report.delineatedBeats = t.beats;
+    if (t.beats > 0) {
+        report.avgQrsWidth = t.qrsWidth / t.beats;
+        report.avgST = t.st / t.beats;
+    }
+    if (t.prCount > 0) report.avgPR = t.pr / t.prCount;
+    if (t.qtCount > 0) report.avgQT = t.qt / t.qtCount;
+    if (t.qtcCount > 0) report.avgQTc = t.qtc / t.qtcCount;
+
+    // ============================================================
+    // 医学评估
+    // ============================================================
+
+    // -- 心率评估 --
+    if (report.avgHR < 60.0) {
+        report.findings.append(QStringLiteral("窦性心动过缓: 平均心率 %1 bpm (< 60 bpm)")
+                                   .arg(report.avgHR, 0, 'f', 1));
+        if (report.avgHR < 50.0) {
+            report.suggestions.append(QStringLiteral("心率显著偏低，建议进一步检查是否存在房室传导阻滞"));
+        } else {
+            report.suggestions.append(QStringLiteral("轻度心动过缓，运动员或睡眠状态可能属正常，如有头晕等症状建议就医"));
+        }
+    } else if (report.avgHR > 100.0) {
+        report.findings.append(QStringLiteral("窦性心动过速: 平均心率 %1 bpm (> 100 bpm)")
+                                   .arg(report.avgHR, 0, 'f', 1));
+        if (report.avgHR > 150.0) {
+            report.suggestions.append(QStringLiteral("心率过快，建议立即就医排除室上性心动过速等病因"));
+        } else {
+            report.suggestions.append(QStringLiteral("心率偏快，可能与运动、情绪、发热等有关，持续出现建议就医"));
+        }
+    } else {
+        report.findings.append(QStringLiteral("心率正常: 平均 %1 bpm (60-100 bpm)")
+                                   .arg(report.avgHR, 0, 'f', 1));
+    }
+
+    // -- 心率变异性评估 --
+    double rrVariation = (report.maxRR - report.minRR) / report.avgRR * 100.0;
+    if (rrVariation > 20.0) {
+        report.findings.append(QStringLiteral("R-R间期变异较大 (%.1f%%), 可能存在心律不齐")
+                                   .arg(rrVariation));
+        report.suggestions.append(QStringLiteral("建议进行24小时动态心电图(Holter)检查以明确心律失常类型"));
+    }
+
+    // -- SDNN 评估 --
+    if (report.sdnn < 50.0 && rrIntervals.size() >= 10) {
+        report.findings.append(QStringLiteral("HRV偏低: SDNN = %.1f ms (< 50 ms)").arg(report.sdnn));
+        report.suggestions.append(QStringLiteral("心率变异性偏低可能与自主神经功能下降有关，建议关注心血管健康"));
+    } else if (report.sdnn > 50.0 && report.sdnn < 100.0 && rrIntervals.size() >= 10) {
+        report.findings.append(QStringLiteral("HRV正常: SDNN = %.1f ms").arg(report.sdnn));
+    } else if (report.sdnn >= 100.0 && rrIntervals.size() >= 10) {
+        report.findings.append(QStringLiteral("HRV良好: SDNN = %.1f ms").arg(report.sdnn));
+    }
+
+    // -- R波幅值评估 --
+    double ampVariation = (report.maxAmplitude - report.minAmplitude);
+    if (report.avgAmplitude > 0 && ampVariation / report.avgAmplitude > 0.5) {
+        report.findings.append(QStringLiteral("R波幅值变异较大 (%.0f - %.0f mV), 注意电极接触")
+                                   .arg(report.minAmplitude).arg(report.maxAmplitude));
+    }
+
+    // -- 波形间期评估 --
+    if (report.avgQrsWidth >= 120.0) {
+        report.findings.append(QStringLiteral("QRS波增宽: 平均 %1 ms (>= 120 ms)")
+                                   .arg(report.avgQrsWidth, 0, 'f', 0));
+        report.suggestions.append(QStringLiteral("QRS波增宽提示室内传导延迟或束支传导阻滞，建议行12导联心电图确认"));
+    }
+    if (report.avgPR > 200.0) {
+        report.findings.append(QStringLiteral("PR间期延长: 平均 %1 ms (> 200 ms)")
+                                   .arg(report.avgPR, 0, 'f', 0));
+        report.suggestions.append(QStringLiteral("PR间期延长提示一度房室传导阻滞可能，建议复查心电图"));
+    }
+    if (report.avgQTc > 460.0) {
+        report.findings.append(QStringLiteral("QTc延长: 平均 %1 ms (> 460 ms)")
+                                   .arg(report.avgQTc, 0, 'f', 0));
+        report.suggestions.append(QStringLiteral("QTc延长可增加室性心律失常风险，请核查是否服用延长QT间期的药物并及时就医"));
+    }
+
+    // -- 早搏检测 (R-R间期突然缩短>20%) --
+    int prematureCount = 0;
+    for (int i = 2; i < rrIntervals.size(); ++i) {
+        double prevAvg = (rrIntervals[i - 1] + rrIntervals[i - 2]) / 2.0;
+        if (prevAvg > 0 && rrIntervals[i] < prevAvg * 0.80) {
+            prematureCount++;
+        }
+    }
+    if (prematureCount > 0) {
+        report.findings.append(QStringLiteral("检测到 %1 次疑似早搏 (R-R间期突然缩短>20%)")
+                                   .arg(prematureCount));
+        if (prematureCount > 5) {
+            report.suggestions.append(QStringLiteral("频发早搏，建议心内科进一步评估"));
+        } else {
+            report.suggestions.append(QStringLiteral("偶发早搏，多数情况下无需特殊处理，如有症状建议就医"));
+        }
+    }
+
+    // -- 总结建议 --
+    if (report.suggestions.isEmpty()) {
+        report.suggestions.append(QStringLiteral("各项指标在正常范围内，请继续保持健康的生活方式"));
+    }
+
+    return report;
+}
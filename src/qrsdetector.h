@@ -0,0 +1,211 @@
+#pragma once
+#include <QObject>
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <deque>
+#include <memory>
+
+class QDataStream;
+namespace EcgDelineator { struct Workspace; }
+
+// R波检测结果
+struct RPeakInfo {
+    int sampleIndex;       // R波在全局样本中的索引
+    double amplitude;      // R波幅值 (mV)
+    double timestamp;      // R波时间 (秒)
+    double rrInterval;     // 与前一个R波的间隔 (秒), 首个为0
+    double instantHR;      // 瞬时心率 (bpm), 首个为0
+};
+
+// 单搏波形特征 (R波信息 + 特征点定位与间期测量)
+// 特征点为全局样本索引, -1 表示未检出; 对应间期为0
+struct BeatInfo : RPeakInfo {
+    int pOnset = -1;
+    int pPeak = -1;
+    int qrsOnset = -1;
+    int qrsOffset = -1;    // J点
+    int tPeak = -1;
+    int tEnd = -1;
+
+    double qrsWidthMs = 0.0;
+    double prIntervalMs = 0.0;   // P波起点 -> QRS起点
+    double qtIntervalMs = 0.0;   // QRS起点 -> T波终点
+    double qtcMs = 0.0;          // Bazett校正: QT / sqrt(RR)
+    double stLevel = 0.0;        // J点后60ms相对等电位线的偏移 (mV)
+
+    bool hasPWave() const { return pPeak >= 0; }
+};
+
+// 实时QRS检测器接口
+//
+// 基类负责各算法共用的部分: 原始值回溯缓冲、R-R间期与心率、逐搏特征点定位、
+// 输入中断处理、状态快照框架和分析报告; 派生类只实现逐点判决
+// (detect 中发现R波后调用 reportPeak)
+class QrsDetector : public QObject {
+    Q_OBJECT
+
+public:
+    enum class Algorithm {
+        PanTompkins,   // 带通 + 微分平方积分 + 双阈值, 默认
+        Wavelet,       // 二次样条小波模极大值对, 抗基线漂移与噪声能力更强
+        Envelope,      // 差分包络 + 自适应阈值, 计算量最小, 用于低配主机
+    };
+
+    static QrsDetector* create(Algorithm algorithm, QObject* parent = nullptr);
+    static QList<Algorithm> algorithms();
+    // 设置项存储用的键名与界面显示名; 未知键名回退到 PanTompkins
+    static QString algorithmKey(Algorithm algorithm);
+    static Algorithm algorithmFromKey(const QString& key);
+    static QString algorithmName(Algorithm algorithm);
+
+    explicit QrsDetector(QObject* parent = nullptr);
+    ~QrsDetector() override;
+
+    virtual Algorithm algorithm() const = 0;
+
+    void setSampleRate(int sampleRate);
+    int sampleRate() const { return m_sampleRate; }
+
+    // 逐点/批量输入 (滤波后的mV值)
+    void processSample(double value);
+    virtual void processSamples(const QVector<double>& values);
+
+    void reset();
+
+    // 状态快照: 算法内部状态、原始值回溯缓冲、最近 kSnapshotPeaks 个R波及待定位心搏,
+    // 恢复后从快照处无缝继续, 无需学习期
+    // 算法或采样率不一致、数据损坏时 restoreState 返回false, 当前状态保持不变
+    QByteArray saveState() const;
+    bool restoreState(const QByteArray& state);
+    static constexpr int kSnapshotPeaks = 64;
+
+    // 输入流出现中断 (重启后恢复快照、断线重连): 跨越中断的R-R间期不计入心率,
+    // 待定位心搏按已有数据完成定位
+    void markDiscontinuity();
+    int samplesProcessed() const { return m_globalIndex; }
+
+    // 逐搏特征点定位 (默认开启); 关闭后只检出R波, 省去每搏数微秒的定位计算,
+    // 用于低配主机或单独衡量检测算法本身的开销
+    void setDelineationEnabled(bool enabled);
+    bool isDelineationEnabled() const { return m_delineationEnabled; }
+
+    // 查询结果
+    const QVector<RPeakInfo>& detectedPeaks() const { return m_peaks; }
+    // 最近至少 kBeatHistory 个已完成特征点定位的心搏 (实时路径比R波检出多延迟约T波窗口长度);
+    // 更早的心搏只计入报告的间期统计, 需要逐搏结果时连接 beatDelineated
+    const QVector<BeatInfo>& delineatedBeats() const { return m_beats; }
+    static constexpr int kBeatHistory = kSnapshotPeaks;
+    int currentHeartRate() const { return m_currentHR; }
+    double lastRRInterval() const;
+
+    // 综合分析报告
+    struct AnalysisReport {
+        int totalPeaks = 0;
+        double durationSeconds = 0.0;
+        // 心率统计
+        double avgHR = 0.0;
+        double minHR = 0.0;
+        double maxHR = 0.0;
+        double stdHR = 0.0;
+        // R-R间期统计 (ms)
+        double avgRR = 0.0;
+        double minRR = 0.0;
+        double maxRR = 0.0;
+        double stdRR = 0.0;
+        // HRV指标
+        double sdnn = 0.0;    // R-R间期标准差 (ms)
+        double rmssd = 0.0;   // 相邻R-R间期差值的均方根 (ms)
+        double pnn50 = 0.0;   // 相邻R-R间期差值>50ms的百分比 (%)
+        // R波幅值
+        double avgAmplitude = 0.0;
+        double minAmplitude = 0.0;
+        double maxAmplitude = 0.0;
+        // 波形间期 (已定位心搏的均值, ms)
+        int delineatedBeats = 0;
+        double avgQrsWidth = 0.0;
+        double avgPR = 0.0;
+        double avgQT = 0.0;
+        double avgQTc = 0.0;
+        double avgST = 0.0;       // mV
+        // 医学评估
+        QStringList findings;     // 发现的问题
+        QStringList suggestions;  // 建议
+    };
+
+    AnalysisReport generateReport() const;
+
+signals:
+    void rPeakDetected(const RPeakInfo& peak);
+    void heartRateUpdated(int bpm);
+    void beatDelineated(const BeatInfo& beat);
+
+protected:
+    // ---- 派生类实现 ----
+    // 采样率变化后预计算算法参数 (m_sampleRate 已更新), 随后会调用 resetDetector
+    virtual void configure() = 0;
+    virtual void resetDetector() = 0;
+    // 判决一个样本: 调用时原始值已进入回溯缓冲, 其全局索引为 m_globalIndex
+    virtual void detect(double value) = 0;
+    // 输入中断: 丢弃正在形成的候选, 此后 m_discontinuityIndex 之前的数据不应再参与寻峰
+    virtual void discontinuity() {}
+    // 算法内部状态; restore 必须完整解析成功后才替换当前状态
+    virtual void saveDetectorState(QDataStream& out) const = 0;
+    virtual bool restoreDetectorState(QDataStream& in) = 0;
+
+    // ---- 派生类使用 ----
+    // 逐点流程的两端: 原始值入回溯缓冲 / 推进待定位心搏与全局索引
+    // 派生类重写 processSamples 时, 每个样本须按 beginSample -> 判决 -> endSample 调用
+    void beginSample(double value);
+    void endSample();
+
+    // 回溯缓冲中 [from, to] 范围 (截断到缓冲与输入中断之后) 原始值最大的样本
+    // 范围内无数据时返回-1
+    int findRawMaximum(int from, int to) const;
+    double rawSample(int index) const { return m_originalBuf[index - m_originalBufStart]; }
+
+    // 确认一个R波: 计算R-R与瞬时心率, 排队等待特征点定位, 更新平均心率并发出信号
+    void reportPeak(int sampleIndex, double amplitude);
+    void updateHeartRate();
+    // 记录一个已定位的心搏: 计入间期统计, 逐搏结果只保留最近的 kBeatHistory 个以上
+    void appendBeat(const BeatInfo& beat);
+
+    int m_sampleRate = 200;
+    int m_globalIndex = 0;
+    int m_discontinuityIndex = 0;    // 输入中断后的首个样本, 此前的R波不参与R-R计算
+
+    // 原始值环形缓冲 (用于回溯)
+    std::deque<double> m_originalBuf;
+    int m_originalBufStart = 0; // 缓冲起始的全局索引
+
+    // 检测结果
+    QVector<RPeakInfo> m_peaks;
+    QVector<BeatInfo> m_beats;
+    int m_currentHR = 0;
+
+    // 特征点定位的平滑/斜率暂存, 逐搏复用
+    std::unique_ptr<EcgDelineator::Workspace> m_delineationWork;
+
+private:
+    // 特征点定位: 等待T波窗口数据到齐的R波 (m_peaks 下标)
+    void delineatePending(bool flush = false);
+    std::deque<int> m_pendingBeats;
+    QVector<double> m_delineationBuf;
+    bool m_delineationEnabled = true;
+
+    // 全部已定位心搏的间期累计 (逐搏结果有界, 报告仍覆盖整段记录)
+    struct IntervalTotals {
+        int beats = 0;
+        double qrsWidth = 0.0;
+        double st = 0.0;
+        int prCount = 0;
+        double pr = 0.0;
+        int qtCount = 0;
+        double qt = 0.0;
+        int qtcCount = 0;
+        double qtc = 0.0;
+    };
+    IntervalTotals m_intervalTotals;
+};
@@ -0,0 +1,233 @@
+#include "qrsfrontend.h"
+#include "ecgfilters.h"
+#include <QDataStream>
+#include <array>
+#include <algorithm>
+
+namespace {
+
+// 积分窗口 ~150ms, 与 RPeakDetector::configure 的取整方式一致
+constexpr int integrationWindow(int sampleRate)
+{
+    return qMax(1, static_cast<int>(0.15 * sampleRate));
+}
+
+// ============================================================
+// 采样率参数: 编译期常量 / 运行期变量, 提供相同的接口给内核
+// ============================================================
+
+template <int SampleRate>
+struct FixedRate {
+    static constexpr bool kSpecialised = true;
+    static constexpr int kWindow = integrationWindow(SampleRate);
+    static constexpr BiquadCoeffs kLowpass =
+        EcgFilters::butterworthLowpass(EcgFilters::kQrsBandHighHz, SampleRate);
+    static constexpr BiquadCoeffs kHighpass =
+        EcgFilters::butterworthHighpass(EcgFilters::kQrsBandLowHz, SampleRate);
+
+    using Ring = std::array<double, kWindow>;
+
+    constexpr int sampleRate() const { return SampleRate; }
+    constexpr int window() const { return kWindow; }
+    constexpr BiquadCoeffs lowpass() const { return kLowpass; }
+    constexpr BiquadCoeffs highpass() const { return kHighpass; }
+    Ring makeRing() const { return Ring{}; }
+};
+
+struct RuntimeRate {
+    static constexpr bool kSpecialised = false;
+
+    using Ring = QVector<double>;
+
+    explicit RuntimeRate(int sampleRate)
+        : m_sampleRate(sampleRate)
+        , m_window(integrationWindow(sampleRate))
+        , m_lowpass(EcgFilters::butterworthLowpass(EcgFilters::kQrsBandHighHz, sampleRate))
+        , m_highpass(EcgFilters::butterworthHighpass(EcgFilters::kQrsBandLowHz, sampleRate))
+    {
+    }
+
+    int sampleRate() const { return m_sampleRate; }
+    int window() const { return m_window; }
+    BiquadCoeffs lowpass() const { return m_lowpass; }
+    BiquadCoeffs highpass() const { return m_highpass; }
+    Ring makeRing() const { return Ring(m_window, 0.0); }
+
+    int m_sampleRate;
+    int m_window;
+    BiquadCoeffs m_lowpass;
+    BiquadCoeffs m_highpass;
+};
+
+// ============================================================
+// 前端内核: 整个处理块内状态保持在局部变量中, 系数为常量时可被编译器折叠
+// ============================================================
+
+template <class Rate>
+class FrontEnd final : public QrsFrontEnd {
+public:
+    explicit FrontEnd(Rate rate = Rate())
+        : m_rate(rate)
+    {
+        reset();
+    }
+
+    int sampleRate() const override { return m_rate.sampleRate(); }
+    int windowSize() const override { return m_rate.window(); }
+    bool isSpecialised() const override { return Rate::kSpecialised; }
+
+    void reset() override
+    {
+        m_lp = BiquadState();
+        m_hp = BiquadState();
+        std::fill(std::begin(m_diffHist), std::end(m_diffHist), 0.0);
+        m_diffWarmup = 4;
+        m_ring = m_rate.makeRing();
+        m_ringPos = 0;
+        m_intSum = 0.0;
+    }
+
+    void process(const double* in, double* out, int count) override
+    {
+        const BiquadCoeffs lp = m_rate.lowpass();
+        const BiquadCoeffs hp = m_rate.highpass();
+        const int window = m_rate.window();
+        const double invWindow = 1.0 / window;
+
+        BiquadState l = m_lp;
+        BiquadState h = m_hp;
+        double d1 = m_diffHist[0], d2 = m_diffHist[1], d3 = m_diffHist[2], d4 = m_diffHist[3];
+        int warmup = m_diffWarmup;
+        double sum = m_intSum;
+        int pos = m_ringPos;
+
+        for (int i = 0; i < count; ++i) {
+            // 带通: 低通 (~15Hz) 后接高通 (~5Hz)
+            const double x = in[i];
+            const double lpOut = lp.a0 * x + lp.a1 * l.x1 + lp.a2 * l.x2 - lp.b1 * l.y1 - lp.b2 * l.y2;
+            l.x2 = l.x1; l.x1 = x;
+            l.y2 = l.y1; l.y1 = lpOut;
+
+            const double bp = hp.a0 * lpOut + hp.a1 * h.x1 + hp.a2 * h.x2 - hp.b1 * h.y1 - hp.b2 * h.y2;
+            h.x2 = h.x1; h.x1 = lpOut;
+            h.y2 = h.y1; h.y1 = bp;
+
+            // 因果五点微分: y[n] = (2x[n] + x[n-1] - x[n-3] - 2x[n-4]) / 8, 历史不足5点时输出0
+            double diff = 0.0;
+            if (warmup > 0) {
+                --warmup;
+            } else {
+                diff = (2.0 * bp + d1 - d3 - 2.0 * d4) / 8.0;
+            }
+            d4 = d3; d3 = d2; d2 = d1; d1 = bp;
+
+            // 平方 + 滑动窗口积分
+            const double sq = diff * diff;
+            sum += sq - m_ring[pos];
+            m_ring[pos] = sq;
+            if (++pos == window) pos = 0;
+
+            out[i] = sum * invWindow;
+        }
+
+        m_lp = l;
+        m_hp = h;
+        m_diffHist[0] = d1; m_diffHist[1] = d2; m_diffHist[2] = d3; m_diffHist[3] = d4;
+        m_diffWarmup = warmup;
+        m_intSum = sum;
+        m_ringPos = pos;
+    }
+
+    void saveState(QDataStream& out) const override
+    {
+        const int window = m_rate.window();
+        out << qint32(window);
+        for (const BiquadState* f : { &m_lp, &m_hp }) {
+            out << f->x1 << f->x2 << f->y1 << f->y2;
+        }
+        for (double d : m_diffHist) out << d;
+        out << qint32(m_diffWarmup) << m_intSum;
+        // 积分窗口按时间顺序写出 (最旧在前), 恢复时从位置0开始
+        for (int i = 0; i < window; ++i) {
+            out << m_ring[(m_ringPos + i) % window];
+        }
+    }
+
+    bool restoreState(QDataStream& in) override
+    {
+        qint32 window = 0;
+        in >> window;
+        if (in.status() != QDataStream::Ok || window != m_rate.window()) return false;
+
+        BiquadState lp, hp;
+        for (BiquadState* f : { &lp, &hp }) {
+            in >> f->x1 >> f->x2 >> f->y1 >> f->y2;
+        }
+        double diffHist[4];
+        for (double& d : diffHist) in >> d;
+        qint32 warmup = 0;
+        double intSum = 0.0;
+        in >> warmup >> intSum;
+        typename Rate::Ring ring = m_rate.makeRing();
+        for (int i = 0; i < window; ++i) in >> ring[i];
+        if (in.status() != QDataStream::Ok) return false;
+
+        m_lp = lp;
+        m_hp = hp;
+        std::copy(std::begin(diffHist), std::end(diffHist), std::begin(m_diffHist));
+        m_diffWarmup = qBound(0, static_cast<int>(warmup), 4);
+        m_intSum = intSum;
+        m_ring = ring;
+        m_ringPos = 0;
+        return true;
+    }
+
+private:
+    struct BiquadState {
+        double x1 = 0.0, x2 = 0.0, y1 = 0.0, y2 = 0.0;
+    };
+
+    Rate m_rate;
+    BiquadState m_lp;
+    BiquadState m_hp;
+    double m_diffHist[4] = {};  // 最近4个带通输出, [0] 为最新
+    int m_diffWarmup = 4;
+    typename Rate::Ring m_ring;
+    int m_ringPos = 0;
+    double m_intSum = 0.0;
+};
+
+template <int SampleRate>
+std::unique_ptr<QrsFrontEnd> makeFixed()
+{
+    return std::make_unique<FrontEnd<FixedRate<SampleRate>>>();
+}
+
+} // namespace
+
+std::unique_ptr<QrsFrontEnd> QrsFrontEnd::create(int sampleRate)
+{
+    switch (sampleRate) {
+    case 125: return makeFixed<125>();
+    case 200: return makeFixed<200>();
+    case 250: return makeFixed<250>();
+    case 360: return makeFixed<360>();
+    case 500: return makeFixed<500>();
+    default:  return createGeneric(sampleRate);
+    }
+}
+
+std::unique_ptr<QrsFrontEnd> QrsFrontEnd::createGeneric(int sampleRate)
+{
+    return std::make_unique<FrontEnd<RuntimeRate>>(RuntimeRate(sampleRate));
+}
+
+bool QrsFrontEnd::hasSpecialisation(int sampleRate)
+{
+    switch (sampleRate) {
+    case 125: case 200: case 250: case 360: case 500:
+        return true;
+    default:
+        return false;
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <memory>
+
+class QDataStream;
+
+// Pan-Tompkins 前端: 带通 -> 因果五点微分 -> 平方 -> 滑动窗口积分
+// 输入滤波后的mV值, 输出积分信号, 供 RPeakDetector 的阈值判决使用
+//
+// 常用采样率 (125/200/250/360/500 Hz) 有编译期特化版本: 滤波系数、积分窗口长度
+// 均为 constexpr, 积分环形缓冲为定长数组; 其他采样率使用运行期参数的通用版本
+// 两者共用同一份内核代码, 对同一输入输出完全一致
+class QrsFrontEnd {
+public:
+    virtual ~QrsFrontEnd() = default;
+
+    // 按采样率选择特化版本, 无对应特化时回退到通用版本
+    static std::unique_ptr<QrsFrontEnd> create(int sampleRate);
+    // 始终使用运行期参数 (基准对比用)
+    static std::unique_ptr<QrsFrontEnd> createGeneric(int sampleRate);
+    static bool hasSpecialisation(int sampleRate);
+
+    virtual int sampleRate() const = 0;
+    virtual int windowSize() const = 0;
+    virtual bool isSpecialised() const = 0;
+
+    virtual void reset() = 0;
+    // 逐块处理, out 与 in 等长, 可以是同一数组
+    virtual void process(const double* in, double* out, int count) = 0;
+
+    // 内部状态 (滤波历史、微分历史、积分窗口) 的二进制快照; 窗口长度不符或数据不足时返回false
+    virtual void saveState(QDataStream& out) const = 0;
+    virtual bool restoreState(QDataStream& in) = 0;
+};
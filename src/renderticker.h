@@ -0,0 +1,40 @@
+#pragma once
+#include <QObject>
+#include <QTimer>
+
+// 全局渲染节拍: 所有波形/趋势控件共用一个定时器, 数据到达时只写入缓冲并标记待绘制,
+// 每个节拍统一重绘一次。重绘开销只取决于帧率, 与数据包到达频率无关
+//
+// 没有客户端时定时器停止, 不产生空转唤醒
+class RenderTicker : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int kDefaultFrameRate = 30;
+    static constexpr int kMinFrameRate = 1;
+    static constexpr int kMaxFrameRate = 120;
+
+    // 进程内共享实例 (随 QCoreApplication 销毁)
+    static RenderTicker* shared();
+
+    explicit RenderTicker(QObject* parent = nullptr);
+
+    void setFrameRate(int fps);
+    int frameRate() const { return m_frameRate; }
+    int frameIntervalMs() const { return m_timer->interval(); }
+
+    // 客户端计数: 有客户端时定时器运行, 客户端销毁时自动注销
+    void addClient(QObject* client);
+    void removeClient(QObject* client);
+    int clientCount() const { return m_clients.size(); }
+
+signals:
+    void tick();
+
+private:
+    void updateTimer();
+
+    QTimer* m_timer;
+    int m_frameRate = kDefaultFrameRate;
+    QList<QObject*> m_clients;
+};
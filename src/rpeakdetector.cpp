@@ -1,159 +1,78 @@
 #include "rpeakdetector.h"
+#include "ecgdelineator.h"
+#include "qrsfrontend.h"
 #include <QtMath>
-#include <QDebug>
+#include <QDataStream>
 #include <algorithm>
-#include <numeric>
+
+namespace {
+
+constexpr int kBlockSize = 256;  // 批量处理时前端的分块长度
+
+} // namespace
 
 RPeakDetector::RPeakDetector(QObject* parent)
-    : QObject(parent)
+    : QrsDetector(parent)
 {
     setSampleRate(200);
 }
 
-void RPeakDetector::setSampleRate(int sampleRate)
+RPeakDetector::~RPeakDetector() = default;
+
+bool RPeakDetector::isSampleRateSpecialised() const
+{
+    return m_frontEnd->isSpecialised();
+}
+
+void RPeakDetector::configure()
 {
-    m_sampleRate = sampleRate;
     // 滑动窗口 ~150ms
-    m_windowSize = qMax(1, static_cast<int>(0.15 * sampleRate));
+    m_windowSize = qMax(1, static_cast<int>(0.15 * m_sampleRate));
     // 不应期 ~200ms (生理上QRS波群最短间隔)
-    m_refractorySamples = static_cast<int>(0.2 * sampleRate);
-    reset();
+    m_refractorySamples = static_cast<int>(0.2 * m_sampleRate);
+    // 带通系数只依赖采样率, 预先计算
+    m_lpCoeffs = EcgFilters::butterworthLowpass(EcgFilters::kQrsBandHighHz, m_sampleRate);
+    m_hpCoeffs = EcgFilters::butterworthHighpass(EcgFilters::kQrsBandLowHz, m_sampleRate);
+    m_frontEnd = QrsFrontEnd::create(m_sampleRate);
 }
 
-void RPeakDetector::reset()
+void RPeakDetector::resetDetector()
 {
-    m_globalIndex = 0;
-    std::fill(std::begin(m_bpX), std::end(m_bpX), 0.0);
-    std::fill(std::begin(m_bpY), std::end(m_bpY), 0.0);
-    std::fill(std::begin(m_hpX), std::end(m_hpX), 0.0);
-    std::fill(std::begin(m_hpY), std::end(m_hpY), 0.0);
-    m_diffBuf.clear();
-    m_intBuf.clear();
-    m_intSum = 0.0;
+    m_frontEnd->reset();
     m_threshold = 0.0;
     m_signalLevel = 0.0;
     m_noiseLevel = 0.0;
     m_lastPeakIndex = -1;
+    m_lastSearchbackIndex = -1;
     m_rising = false;
     m_candidateMax = 0.0;
     m_candidateIndex = -1;
-    m_candidateOriginal = 0.0;
-    m_candidateOriginalIndex = -1;
-    m_originalBuf.clear();
-    m_originalBufStart = 0;
-    m_peaks.clear();
-    m_currentHR = 0;
 }
 
-void RPeakDetector::processSample(double value)
+void RPeakDetector::detect(double value)
 {
-    // 保存原始值用于回溯找R波真实幅值
-    m_originalBuf.push_back(value);
-    // 保留最近2秒数据
-    int maxBuf = m_sampleRate * 2;
-    while (static_cast<int>(m_originalBuf.size()) > maxBuf) {
-        m_originalBuf.pop_front();
-        m_originalBufStart++;
-    }
-
-    // Pan-Tompkins 处理流水线
-    double bp = bandpassFilter(value);
-    double diff = derivative(bp);
-    double sq = squaring(diff);
-    double integ = movingWindowIntegration(sq);
-
-    detectPeak(integ, value);
-
-    m_globalIndex++;
+    double integ = 0.0;
+    m_frontEnd->process(&value, &integ, 1);
+    detectPeak(integ);
 }
 
 void RPeakDetector::processSamples(const QVector<double>& values)
 {
-    for (double v : values) {
-        processSample(v);
-    }
-}
-
-// ============================================================
-// 带通滤波: 低通 + 高通 实现 5-15Hz 带通
-// 使用二阶Butterworth IIR滤波器
-// ============================================================
-
-double RPeakDetector::bandpassFilter(double x)
-{
-    // --- 低通滤波 (截止频率 ~15Hz) ---
-    // 二阶Butterworth低通, 根据采样率计算系数
-    // 使用预翘曲的双线性变换简化系数
-    double fc_lp = 15.0;
-    double w_lp = qTan(M_PI * fc_lp / m_sampleRate);
-    double w2_lp = w_lp * w_lp;
-    double k_lp = 1.0 / (1.0 + M_SQRT2 * w_lp + w2_lp);
-
-    double a0_lp = w2_lp * k_lp;
-    double a1_lp = 2.0 * a0_lp;
-    double a2_lp = a0_lp;
-    double b1_lp = 2.0 * (w2_lp - 1.0) * k_lp;
-    double b2_lp = (1.0 - M_SQRT2 * w_lp + w2_lp) * k_lp;
-
-    // 移位
-    m_bpX[2] = m_bpX[1]; m_bpX[1] = m_bpX[0]; m_bpX[0] = x;
-    m_bpY[2] = m_bpY[1]; m_bpY[1] = m_bpY[0];
-    m_bpY[0] = a0_lp * m_bpX[0] + a1_lp * m_bpX[1] + a2_lp * m_bpX[2]
-               - b1_lp * m_bpY[1] - b2_lp * m_bpY[2];
-
-    double lpOut = m_bpY[0];
-
-    // --- 高通滤波 (截止频率 ~5Hz) ---
-    double fc_hp = 5.0;
-    double w_hp = qTan(M_PI * fc_hp / m_sampleRate);
-    double w2_hp = w_hp * w_hp;
-    double k_hp = 1.0 / (1.0 + M_SQRT2 * w_hp + w2_hp);
-
-    double a0_hp = k_hp;
-    double a1_hp = -2.0 * k_hp;
-    double a2_hp = k_hp;
-    double b1_hp = 2.0 * (w2_hp - 1.0) * k_hp;
-    double b2_hp = (1.0 - M_SQRT2 * w_hp + w2_hp) * k_hp;
-
-    m_hpX[2] = m_hpX[1]; m_hpX[1] = m_hpX[0]; m_hpX[0] = lpOut;
-    m_hpY[2] = m_hpY[1]; m_hpY[1] = m_hpY[0];
-    m_hpY[0] = a0_hp * m_hpX[0] + a1_hp * m_hpX[1] + a2_hp * m_hpX[2]
-               - b1_hp * m_hpY[1] - b2_hp * m_hpY[2];
-
-    return m_hpY[0];
-}
-
-double RPeakDetector::derivative(double x)
-{
-    // 五点微分: y[n] = (1/8T)(-x[n-2] - 2x[n-1] + 2x[n+1] + x[n+2])
-    // 因为实时处理, 使用因果版本: y[n] = (2x[n] + x[n-1] - x[n-3] - 2x[n-4]) / 8
-    m_diffBuf.push_back(x);
-    if (m_diffBuf.size() < 5) return 0.0;
-    if (m_diffBuf.size() > 5) m_diffBuf.pop_front();
-
-    double y = (2.0 * m_diffBuf[4] + m_diffBuf[3] - m_diffBuf[1] - 2.0 * m_diffBuf[0]) / 8.0;
-    return y;
-}
-
-double RPeakDetector::squaring(double x)
-{
-    return x * x;
-}
-
-double RPeakDetector::movingWindowIntegration(double x)
-{
-    m_intBuf.push_back(x);
-    m_intSum += x;
-
-    while (static_cast<int>(m_intBuf.size()) > m_windowSize) {
-        m_intSum -= m_intBuf.front();
-        m_intBuf.pop_front();
+    // 前端按块处理 (与判决无反馈, 可先行计算), 判决仍逐点进行
+    m_frontEndOut.resize(kBlockSize);
+    const double* in = values.constData();
+    for (int offset = 0; offset < values.size(); offset += kBlockSize) {
+        int n = qMin(kBlockSize, values.size() - offset);
+        m_frontEnd->process(in + offset, m_frontEndOut.data(), n);
+        for (int i = 0; i < n; ++i) {
+            beginSample(in[offset + i]);
+            detectPeak(m_frontEndOut[i]);
+            endSample();
+        }
     }
-
-    return m_intSum / m_windowSize;
 }
 
-void RPeakDetector::detectPeak(double integratedValue, double originalValue)
+void RPeakDetector::detectPeak(double integratedValue)
 {
     // 初始学习阶段: 前2秒只收集统计数据
     if (m_globalIndex < m_sampleRate * 2) {
@@ -165,6 +84,11 @@ void RPeakDetector::detectPeak(double integratedValue, double originalValue)
         return;
     }
 
+    // 输入中断后, 前端滤波器对不连续处的阶跃响应尚未衰减, 期间不形成候选
+    if (m_globalIndex < m_discontinuityIndex + m_refractorySamples + m_windowSize) {
+        return;
+    }
+
     // 跟踪上升/下降沿
     if (integratedValue > m_candidateMax) {
         m_candidateMax = integratedValue;
@@ -180,46 +104,13 @@ void RPeakDetector::detectPeak(double integratedValue, double originalValue)
         if (m_lastPeakIndex < 0 ||
             (m_candidateIndex - m_lastPeakIndex) >= m_refractorySamples) {
 
-            // 在候选点附近的原始信号中找真正的R波峰值
-            int searchStart = m_candidateIndex - m_windowSize;
-            int searchEnd = m_candidateIndex + 2;
-            double maxOriginal = -1e9;
-            int maxOriginalIdx = m_candidateIndex;
-
-            for (int i = searchStart; i <= searchEnd; ++i) {
-                int bufIdx = i - m_originalBufStart;
-                if (bufIdx >= 0 && bufIdx < static_cast<int>(m_originalBuf.size())) {
-                    if (m_originalBuf[bufIdx] > maxOriginal) {
-                        maxOriginal = m_originalBuf[bufIdx];
-                        maxOriginalIdx = i;
-                    }
-                }
+            // 在候选点附近的原始信号中找真正的R波峰值 (不回溯到输入中断之前的数据)
+            int peakIndex = findRawMaximum(m_candidateIndex - m_windowSize, m_candidateIndex + 2);
+            if (peakIndex >= 0) {
+                m_lastPeakIndex = peakIndex;
+                updateThreshold(m_candidateMax, true);
+                reportPeak(peakIndex, rawSample(peakIndex));
             }
-
-            // 构建R波信息
-            RPeakInfo peak;
-            peak.sampleIndex = maxOriginalIdx;
-            peak.amplitude = maxOriginal;
-            peak.timestamp = static_cast<double>(maxOriginalIdx) / m_sampleRate;
-
-            if (!m_peaks.isEmpty()) {
-                const RPeakInfo& prev = m_peaks.last();
-                peak.rrInterval = peak.timestamp - prev.timestamp;
-                if (peak.rrInterval > 0.0) {
-                    peak.instantHR = 60.0 / peak.rrInterval;
-                }
-            } else {
-                peak.rrInterval = 0.0;
-                peak.instantHR = 0.0;
-            }
-
-            m_peaks.append(peak);
-            m_lastPeakIndex = maxOriginalIdx;
-
-            updateThreshold(m_candidateMax, true);
-            updateHeartRate();
-
-            emit rPeakDetected(peak);
         } else {
             // 不应期内, 视为噪声
             updateThreshold(m_candidateMax, false);
@@ -232,203 +123,203 @@ void RPeakDetector::detectPeak(double integratedValue, double originalValue)
     }
 
     // 如果长时间没有检测到峰值 (>1.66s, 即<36bpm), 降低阈值
+    // 每个回溯周期只降低一次; 逐点减半会使阈值衰减到零且候选被反复清空, 检测器停滞
     if (m_lastPeakIndex >= 0 &&
-        (m_globalIndex - m_lastPeakIndex) > static_cast<int>(1.66 * m_sampleRate)) {
+        (m_globalIndex - qMax(m_lastPeakIndex, m_lastSearchbackIndex)) > static_cast<int>(1.66 * m_sampleRate)) {
         m_threshold *= 0.5;
-        // 重置上升沿跟踪以重新寻找
-        m_candidateMax = 0.0;
-        m_rising = false;
+        m_lastSearchbackIndex = m_globalIndex;
+        // 重置已过时的候选以重新寻找; 正在形成的QRS候选保留
+        if (m_globalIndex - m_candidateIndex > m_windowSize) {
+            m_candidateMax = 0.0;
+            m_rising = false;
+        }
     }
 }
 
-void RPeakDetector::updateThreshold(double peakValue, bool isSignal)
+// ============================================================
+// 状态快照与输入中断
+// ============================================================
+
+void RPeakDetector::saveDetectorState(QDataStream& out) const
 {
-    if (isSignal) {
-        // 信号峰: signalLevel = 0.125 * peak + 0.875 * signalLevel
-        m_signalLevel = 0.125 * peakValue + 0.875 * m_signalLevel;
-    } else {
-        // 噪声峰: noiseLevel = 0.125 * peak + 0.875 * noiseLevel
-        m_noiseLevel = 0.125 * peakValue + 0.875 * m_noiseLevel;
-    }
-    // 阈值 = noiseLevel + 0.25 * (signalLevel - noiseLevel)
-    m_threshold = m_noiseLevel + 0.25 * (m_signalLevel - m_noiseLevel);
+    m_frontEnd->saveState(out);
+    out << m_threshold << m_signalLevel << m_noiseLevel
+        << qint32(m_lastPeakIndex) << qint32(m_lastSearchbackIndex)
+        << m_rising << m_candidateMax << qint32(m_candidateIndex);
 }
 
-void RPeakDetector::updateHeartRate()
+bool RPeakDetector::restoreDetectorState(QDataStream& in)
 {
-    // 用最近8个R-R间隔计算平均心率
-    int count = m_peaks.size();
-    if (count < 2) return;
-
-    int n = qMin(8, count - 1);
-    double sumRR = 0.0;
-    for (int i = count - n; i < count; ++i) {
-        sumRR += m_peaks[i].rrInterval;
-    }
+    std::unique_ptr<QrsFrontEnd> frontEnd = QrsFrontEnd::create(m_sampleRate);
+    if (!frontEnd->restoreState(in)) return false;
+
+    qint32 lastPeakIndex, lastSearchbackIndex, candidateIndex;
+    double threshold, signalLevel, noiseLevel, candidateMax;
+    bool rising;
+    in >> threshold >> signalLevel >> noiseLevel
+       >> lastPeakIndex >> lastSearchbackIndex
+       >> rising >> candidateMax >> candidateIndex;
+    if (in.status() != QDataStream::Ok) return false;
+
+    m_frontEnd = std::move(frontEnd);
+    m_threshold = threshold;
+    m_signalLevel = signalLevel;
+    m_noiseLevel = noiseLevel;
+    m_lastPeakIndex = lastPeakIndex;
+    m_lastSearchbackIndex = lastSearchbackIndex;
+    m_rising = rising;
+    m_candidateMax = candidateMax;
+    m_candidateIndex = candidateIndex;
+    return true;
+}
 
-    double avgRR = sumRR / n;
-    if (avgRR > 0.0) {
-        int hr = qRound(60.0 / avgRR);
-        // 合理范围 30-220 bpm
-        if (hr >= 30 && hr <= 220) {
-            m_currentHR = hr;
-            emit heartRateUpdated(m_currentHR);
-        }
+void RPeakDetector::discontinuity()
+{
+    m_candidateMax = 0.0;
+    m_candidateIndex = -1;
+    m_rising = false;
+    // 回溯降阈值从恢复时刻重新计时
+    if (m_lastPeakIndex >= 0) {
+        m_lastSearchbackIndex = m_globalIndex;
     }
 }
 
-double RPeakDetector::lastRRInterval() const
+// ============================================================
+// 离线零相位分析: 各阶段在整段连续数组上批量完成, 不经过逐点接口
+// ============================================================
+
+void RPeakDetector::analyzeRecord(const QVector<double>& samples)
 {
-    if (m_peaks.size() < 2) return 0.0;
-    return m_peaks.last().rrInterval;
+    analyzeSegments({samples});
 }
 
-RPeakDetector::AnalysisReport RPeakDetector::generateReport() const
+void RPeakDetector::analyzeSegments(const QVector<QVector<double>>& segments)
 {
-    AnalysisReport report;
-    report.totalPeaks = m_peaks.size();
-
-    if (m_peaks.size() < 2) {
-        report.findings.append(QStringLiteral("数据不足，无法进行有效分析（至少需要2个R波）"));
-        return report;
+    reset();
+    int firstIndex = 0;
+    for (const QVector<double>& samples : segments) {
+        // 各段独立滤波和学习阈值, 段间不做零相位滤波也不计 R-R
+        resetDetector();
+        analyzeSegment(samples, firstIndex);
+        firstIndex += samples.size();
     }
+    m_globalIndex = firstIndex;
+    updateHeartRate();
+}
 
-    report.durationSeconds = m_peaks.last().timestamp - m_peaks.first().timestamp;
-
-    // ---- 收集有效的R-R间期和瞬时心率 ----
-    QVector<double> rrIntervals;  // 秒
-    QVector<double> heartRates;   // bpm
-    QVector<double> amplitudes;
-
-    for (int i = 0; i < m_peaks.size(); ++i) {
-        amplitudes.append(m_peaks[i].amplitude);
-        if (i > 0 && m_peaks[i].rrInterval > 0.0) {
-            rrIntervals.append(m_peaks[i].rrInterval);
-            heartRates.append(m_peaks[i].instantHR);
+void RPeakDetector::analyzeSegment(const QVector<double>& samples, int firstIndex)
+{
+    const int n = samples.size();
+    if (n < m_sampleRate) return;  // 不足1秒
+    const int segmentFirstPeak = m_peaks.size();
+
+    QVector<double> bandpassed = samples;
+    EcgFilters::filtfilt(m_lpCoeffs, bandpassed);
+    EcgFilters::filtfilt(m_hpCoeffs, bandpassed);
+
+    QVector<double> squared = EcgFilters::centralDerivative(bandpassed);
+    for (double& v : squared) v *= v;
+    const QVector<double> integrated = EcgFilters::centeredMovingAverage(squared, m_windowSize);
+
+    // 离线可前视: 用前2秒最大值初始化阈值, 前2秒也参与检测
+    int learnEnd = qMin(n, m_sampleRate * 2);
+    m_signalLevel = *std::max_element(integrated.constBegin(), integrated.constBegin() + learnEnd);
+    m_threshold = m_signalLevel * 0.25;
+
+    const int halfWindow = m_windowSize / 2;
+    const int searchbackSamples = static_cast<int>(1.66 * m_sampleRate);
+
+    for (int i = 0; i < n; ++i) {
+        double value = integrated[i];
+        if (value > m_candidateMax) {
+            m_candidateMax = value;
+            m_candidateIndex = i;
+            m_rising = true;
         }
-    }
-
-    if (rrIntervals.isEmpty()) return report;
-
-    // ---- 心率统计 ----
-    double sumHR = std::accumulate(heartRates.begin(), heartRates.end(), 0.0);
-    report.avgHR = sumHR / heartRates.size();
-    report.minHR = *std::min_element(heartRates.begin(), heartRates.end());
-    report.maxHR = *std::max_element(heartRates.begin(), heartRates.end());
-
-    double sqSumHR = 0.0;
-    for (double hr : heartRates) sqSumHR += (hr - report.avgHR) * (hr - report.avgHR);
-    report.stdHR = qSqrt(sqSumHR / heartRates.size());
-
-    // ---- R-R间期统计 (转ms) ----
-    QVector<double> rrMs;
-    for (double rr : rrIntervals) rrMs.append(rr * 1000.0);
-
-    double sumRR = std::accumulate(rrMs.begin(), rrMs.end(), 0.0);
-    report.avgRR = sumRR / rrMs.size();
-    report.minRR = *std::min_element(rrMs.begin(), rrMs.end());
-    report.maxRR = *std::max_element(rrMs.begin(), rrMs.end());
-
-    double sqSumRR = 0.0;
-    for (double rr : rrMs) sqSumRR += (rr - report.avgRR) * (rr - report.avgRR);
-    report.stdRR = qSqrt(sqSumRR / rrMs.size());
-
-    // ---- HRV 指标 ----
-    // SDNN: R-R间期标准差
-    report.sdnn = report.stdRR;
-
-    // RMSSD: 相邻R-R间期差值的均方根
-    double sumDiffSq = 0.0;
-    int nn50Count = 0;
-    for (int i = 1; i < rrMs.size(); ++i) {
-        double diff = rrMs[i] - rrMs[i - 1];
-        sumDiffSq += diff * diff;
-        if (qAbs(diff) > 50.0) nn50Count++;
-    }
-    if (rrMs.size() > 1) {
-        report.rmssd = qSqrt(sumDiffSq / (rrMs.size() - 1));
-        report.pnn50 = 100.0 * nn50Count / (rrMs.size() - 1);
-    }
 
-    // ---- R波幅值统计 ----
-    double sumAmp = std::accumulate(amplitudes.begin(), amplitudes.end(), 0.0);
-    report.avgAmplitude = sumAmp / amplitudes.size();
-    report.minAmplitude = *std::min_element(amplitudes.begin(), amplitudes.end());
-    report.maxAmplitude = *std::max_element(amplitudes.begin(), amplitudes.end());
-
-    // ============================================================
-    // 医学评估
-    // ============================================================
-
-    // -- 心率评估 --
-    if (report.avgHR < 60.0) {
-        report.findings.append(QStringLiteral("窦性心动过缓: 平均心率 %1 bpm (< 60 bpm)")
-                                   .arg(report.avgHR, 0, 'f', 1));
-        if (report.avgHR < 50.0) {
-            report.suggestions.append(QStringLiteral("心率显著偏低，建议进一步检查是否存在房室传导阻滞"));
-        } else {
-            report.suggestions.append(QStringLiteral("轻度心动过缓，运动员或睡眠状态可能属正常，如有头晕等症状建议就医"));
-        }
-    } else if (report.avgHR > 100.0) {
-        report.findings.append(QStringLiteral("窦性心动过速: 平均心率 %1 bpm (> 100 bpm)")
-                                   .arg(report.avgHR, 0, 'f', 1));
-        if (report.avgHR > 150.0) {
-            report.suggestions.append(QStringLiteral("心率过快，建议立即就医排除室上性心动过速等病因"));
-        } else {
-            report.suggestions.append(QStringLiteral("心率偏快，可能与运动、情绪、发热等有关，持续出现建议就医"));
-        }
-    } else {
-        report.findings.append(QStringLiteral("心率正常: 平均 %1 bpm (60-100 bpm)")
-                                   .arg(report.avgHR, 0, 'f', 1));
-    }
+        bool pastPeak = m_rising && (value < m_candidateMax * 0.6);
+        if (pastPeak && m_candidateMax > m_threshold) {
+            if (m_lastPeakIndex < 0 ||
+                (m_candidateIndex - m_lastPeakIndex) >= m_refractorySamples) {
+
+                // 零相位下R波位于积分峰两侧半窗内
+                int searchStart = qMax(0, m_candidateIndex - halfWindow);
+                int searchEnd = qMin(n - 1, m_candidateIndex + halfWindow);
+                int maxIdx = searchStart;
+                for (int k = searchStart + 1; k <= searchEnd; ++k) {
+                    if (samples[k] > samples[maxIdx]) maxIdx = k;
+                }
 
-    // -- 心率变异性评估 --
-    double rrVariation = (report.maxRR - report.minRR) / report.avgRR * 100.0;
-    if (rrVariation > 20.0) {
-        report.findings.append(QStringLiteral("R-R间期变异较大 (%.1f%%), 可能存在心律不齐")
-                                   .arg(rrVariation));
-        report.suggestions.append(QStringLiteral("建议进行24小时动态心电图(Holter)检查以明确心律失常类型"));
-    }
+                // 三点抛物线插值求亚样本峰位置
+                double offset = 0.0;
+                if (maxIdx > 0 && maxIdx < n - 1) {
+                    double y0 = samples[maxIdx - 1];
+                    double y1 = samples[maxIdx];
+                    double y2 = samples[maxIdx + 1];
+                    double denom = y0 - 2.0 * y1 + y2;
+                    if (denom < 0.0) {
+                        offset = qBound(-0.5, 0.5 * (y0 - y2) / denom, 0.5);
+                    }
+                }
 
-    // -- SDNN 评估 --
-    if (report.sdnn < 50.0 && rrIntervals.size() >= 10) {
-        report.findings.append(QStringLiteral("HRV偏低: SDNN = %.1f ms (< 50 ms)").arg(report.sdnn));
-        report.suggestions.append(QStringLiteral("心率变异性偏低可能与自主神经功能下降有关，建议关注心血管健康"));
-    } else if (report.sdnn > 50.0 && report.sdnn < 100.0 && rrIntervals.size() >= 10) {
-        report.findings.append(QStringLiteral("HRV正常: SDNN = %.1f ms").arg(report.sdnn));
-    } else if (report.sdnn >= 100.0 && rrIntervals.size() >= 10) {
-        report.findings.append(QStringLiteral("HRV良好: SDNN = %.1f ms").arg(report.sdnn));
-    }
+                RPeakInfo peak;
+                peak.sampleIndex = firstIndex + maxIdx;
+                peak.amplitude = samples[maxIdx];
+                peak.timestamp = (firstIndex + maxIdx + offset) / m_sampleRate;
+                peak.rrInterval = 0.0;
+                peak.instantHR = 0.0;
+                if (m_peaks.size() > segmentFirstPeak) {
+                    peak.rrInterval = peak.timestamp - m_peaks.last().timestamp;
+                    if (peak.rrInterval > 0.0) {
+                        peak.instantHR = 60.0 / peak.rrInterval;
+                    }
+                }
 
-    // -- R波幅值评估 --
-    double ampVariation = (report.maxAmplitude - report.minAmplitude);
-    if (report.avgAmplitude > 0 && ampVariation / report.avgAmplitude > 0.5) {
-        report.findings.append(QStringLiteral("R波幅值变异较大 (%.0f - %.0f mV), 注意电极接触")
-                                   .arg(report.minAmplitude).arg(report.maxAmplitude));
-    }
+                m_peaks.append(peak);
+                m_lastPeakIndex = maxIdx;
+                updateThreshold(m_candidateMax, true);
+            } else {
+                updateThreshold(m_candidateMax, false);
+            }
 
-    // -- 早搏检测 (R-R间期突然缩短>20%) --
-    int prematureCount = 0;
-    for (int i = 2; i < rrIntervals.size(); ++i) {
-        double prevAvg = (rrIntervals[i - 1] + rrIntervals[i - 2]) / 2.0;
-        if (prevAvg > 0 && rrIntervals[i] < prevAvg * 0.80) {
-            prematureCount++;
+            m_candidateMax = 0.0;
+            m_candidateIndex = -1;
+            m_rising = false;
         }
-    }
-    if (prematureCount > 0) {
-        report.findings.append(QStringLiteral("检测到 %1 次疑似早搏 (R-R间期突然缩短>20%)")
-                                   .arg(prematureCount));
-        if (prematureCount > 5) {
-            report.suggestions.append(QStringLiteral("频发早搏，建议心内科进一步评估"));
-        } else {
-            report.suggestions.append(QStringLiteral("偶发早搏，多数情况下无需特殊处理，如有症状建议就医"));
+
+        if (m_lastPeakIndex >= 0 && (i - qMax(m_lastPeakIndex, m_lastSearchbackIndex)) > searchbackSamples) {
+            m_threshold *= 0.5;
+            m_lastSearchbackIndex = i;
+            if (i - m_candidateIndex > m_windowSize) {
+                m_candidateMax = 0.0;
+                m_rising = false;
+            }
         }
     }
 
-    // -- 总结建议 --
-    if (report.suggestions.isEmpty()) {
-        report.suggestions.append(QStringLiteral("各项指标在正常范围内，请继续保持健康的生活方式"));
+    // 整段数据可用, 直接在记录上逐搏定位特征点 (下标均为全局下标); 与实时路径一样受
+    // setDelineationEnabled 控制
+    if (!isDelineationEnabled()) return;
+    const int before = EcgDelineator::samplesBefore(m_sampleRate);
+    const int last = firstIndex + n - 1;
+    for (int p = segmentFirstPeak; p < m_peaks.size(); ++p) {
+        const RPeakInfo& peak = m_peaks[p];
+        int start = qMax(firstIndex, peak.sampleIndex - before);
+        int end = qMin(last, peak.sampleIndex + EcgDelineator::samplesAfter(m_sampleRate, peak.rrInterval));
+        appendBeat(EcgDelineator::delineate(peak, samples.constData() + (start - firstIndex),
+                                            end - start + 1, start, m_sampleRate, *m_delineationWork));
     }
+}
 
-    return report;
+void RPeakDetector::updateThreshold(double peakValue, bool isSignal)
+{
+    if (isSignal) {
+        // 信号峰: signalLevel = 0.125 * peak + 0.875 * signalLevel
+        m_signalLevel = 0.125 * peakValue + 0.875 * m_signalLevel;
+    } else {
+        // 噪声峰: noiseLevel = 0.125 * peak + 0.875 * noiseLevel
+        m_noiseLevel = 0.125 * peakValue + 0.875 * m_noiseLevel;
+    }
+    // 阈值 = noiseLevel + 0.25 * (signalLevel - noiseLevel)
+    m_threshold = m_noiseLevel + 0.25 * (m_signalLevel - m_noiseLevel);
 }
@@ -1,120 +1,69 @@
 #pragma once
-#include <QObject>
-#include <QVector>
-#include <QPointF>
-#include <deque>
+#include "qrsdetector.h"
+#include "ecgfilters.h"
+#include <memory>
 
-// R波检测结果
-struct RPeakInfo {
-    int sampleIndex;       // R波在全局样本中的索引
-    double amplitude;      // R波幅值 (mV)
-    double timestamp;      // R波时间 (秒)
-    double rrInterval;     // 与前一个R波的间隔 (秒), 首个为0
-    double instantHR;      // 瞬时心率 (bpm), 首个为0
-};
+class QrsFrontEnd;
 
 // 基于简化Pan-Tompkins算法的实时R波检测器
-class RPeakDetector : public QObject {
+class RPeakDetector : public QrsDetector {
     Q_OBJECT
 
 public:
     explicit RPeakDetector(QObject* parent = nullptr);
+    ~RPeakDetector() override;
 
-    void setSampleRate(int sampleRate);
-    int sampleRate() const { return m_sampleRate; }
-
-    // 逐点/批量输入 (滤波后的mV值)
-    void processSample(double value);
-    void processSamples(const QVector<double>& values);
-
-    void reset();
+    Algorithm algorithm() const override { return Algorithm::PanTompkins; }
 
-    // 查询结果
-    const QVector<RPeakInfo>& detectedPeaks() const { return m_peaks; }
-    int currentHeartRate() const { return m_currentHR; }
-    double lastRRInterval() const;
+    // 125/200/250/360/500 Hz 使用编译期特化的前端, 其他采样率使用通用前端
+    bool isSampleRateSpecialised() const;
 
-    // 综合分析报告
-    struct AnalysisReport {
-        int totalPeaks = 0;
-        double durationSeconds = 0.0;
-        // 心率统计
-        double avgHR = 0.0;
-        double minHR = 0.0;
-        double maxHR = 0.0;
-        double stdHR = 0.0;
-        // R-R间期统计 (ms)
-        double avgRR = 0.0;
-        double minRR = 0.0;
-        double maxRR = 0.0;
-        double stdRR = 0.0;
-        // HRV指标
-        double sdnn = 0.0;    // R-R间期标准差 (ms)
-        double rmssd = 0.0;   // 相邻R-R间期差值的均方根 (ms)
-        double pnn50 = 0.0;   // 相邻R-R间期差值>50ms的百分比 (%)
-        // R波幅值
-        double avgAmplitude = 0.0;
-        double minAmplitude = 0.0;
-        double maxAmplitude = 0.0;
-        // 医学评估
-        QStringList findings;     // 发现的问题
-        QStringList suggestions;  // 建议
-    };
+    void processSamples(const QVector<double>& values) override;
 
-    AnalysisReport generateReport() const;
+    // 离线整段分析 (存储记录): 前向-后向零相位带通 + 中心微分 + 居中积分,
+    // 无群延迟, R波时刻经抛物线插值细化到亚样本精度, 用于HRV报告
+    // 结果替换 detectedPeaks(), 之后可直接调用 generateReport()
+    void analyzeRecord(const QVector<double>& samples);
+    // 多段互不相连的记录: 逐段独立分析, 结果按段首尾相接排列 (时间不含段间空白),
+    // 各段第一个心搏不计 R-R, 跨段间隔不进入报告统计
+    void analyzeSegments(const QVector<QVector<double>>& segments);
 
-signals:
-    void rPeakDetected(const RPeakInfo& peak);
-    void heartRateUpdated(int bpm);
+protected:
+    void configure() override;
+    void resetDetector() override;
+    void detect(double value) override;
+    void discontinuity() override;
+    void saveDetectorState(QDataStream& out) const override;
+    bool restoreDetectorState(QDataStream& in) override;
 
 private:
-    // Pan-Tompkins 各阶段
-    double bandpassFilter(double x);
-    double derivative(double x);
-    double squaring(double x);
-    double movingWindowIntegration(double x);
-    void detectPeak(double integratedValue, double originalValue);
+    // 前端输出一个积分值后的判决
+    void detectPeak(double integratedValue);
+    // 离线分析一段连续记录, 检测结果追加在已有结果之后; firstIndex 为该段首样本的全局下标
+    void analyzeSegment(const QVector<double>& samples, int firstIndex);
 
-    int m_sampleRate = 200;
-    int m_globalIndex = 0;
+    // Pan-Tompkins 前端 (带通/微分/平方/积分), 按采样率选择特化实现
+    std::unique_ptr<QrsFrontEnd> m_frontEnd;
+    QVector<double> m_frontEndOut;  // 批量处理的积分输出暂存
 
-    // 带通滤波器状态 (二阶IIR: 5-15Hz)
-    double m_bpX[3] = {};  // 输入历史
-    double m_bpY[3] = {};  // 输出历史
-    // 高通部分
-    double m_hpX[3] = {};
-    double m_hpY[3] = {};
+    // 带通滤波器系数 (离线零相位分析使用)
+    BiquadCoeffs m_lpCoeffs;
+    BiquadCoeffs m_hpCoeffs;
 
-    // 微分器缓存
-    std::deque<double> m_diffBuf;
-
-    // 滑动窗口积分
-    std::deque<double> m_intBuf;
-    double m_intSum = 0.0;
-    int m_windowSize = 30; // ~150ms at 200Hz
+    int m_windowSize = 30; // 积分窗口 ~150ms at 200Hz
 
     // 峰值检测
     double m_threshold = 0.0;
     double m_signalLevel = 0.0;
     double m_noiseLevel = 0.0;
     int m_lastPeakIndex = -1;
+    int m_lastSearchbackIndex = -1;  // 上次因长时间无检出而降低阈值的位置
     int m_refractorySamples = 40; // 200ms at 200Hz
 
     // 寻峰缓冲 (在积分信号上升沿结束后回溯找原始信号最大值)
     bool m_rising = false;
     double m_candidateMax = 0.0;
     int m_candidateIndex = -1;
-    double m_candidateOriginal = 0.0;
-    int m_candidateOriginalIndex = -1;
-
-    // 原始值环形缓冲 (用于回溯)
-    std::deque<double> m_originalBuf;
-    int m_originalBufStart = 0; // 缓冲起始的全局索引
-
-    // 检测结果
-    QVector<RPeakInfo> m_peaks;
-    int m_currentHR = 0;
 
-    void updateHeartRate();
     void updateThreshold(double peakValue, bool isSignal);
 };
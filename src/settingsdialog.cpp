@@ -144,6 +144,29 @@ void SettingsDialog::setupUI()
     mqttTopicLayout->addRow(QStringLiteral("心率主题:"), m_hrTopicEdit);
     mqttTopicLayout->addRow(QStringLiteral("血氧主题:"), m_spo2TopicEdit);
     mqttTopicLayout->addRow(QStringLiteral("心电主题:"), m_ecgTopicEdit);
+
+    // 设备心电采样率, 非200Hz时自动重采样到处理采样率
+    m_ecgSampleRateCombo = new QComboBox();
+    for (int rate : {125, 200, 250, 360, 500, 1000}) {
+        m_ecgSampleRateCombo->addItem(QStringLiteral("%1 Hz").arg(rate), rate);
+    }
+    m_ecgSampleRateCombo->setCurrentIndex(m_ecgSampleRateCombo->findData(200));
+    mqttTopicLayout->addRow(QStringLiteral("心电采样率:"), m_ecgSampleRateCombo);
+
+    // R波检测算法, 按设备与主机性能选择
+    m_qrsAlgorithmCombo = new QComboBox();
+    for (QrsDetector::Algorithm algorithm : QrsDetector::algorithms()) {
+        m_qrsAlgorithmCombo->addItem(QrsDetector::algorithmName(algorithm),
+                                     QrsDetector::algorithmKey(algorithm));
+    }
+    mqttTopicLayout->addRow(QStringLiteral("R波检测算法:"), m_qrsAlgorithmCombo);
+
+    m_fixedPointDetectionCheck = new QCheckBox(QStringLiteral("定点检测 (直接处理ADC原始计数)"));
+    m_fixedPointDetectionCheck->setChecked(false);
+    m_fixedPointDetectionCheck->setToolTip(QStringLiteral(
+        "设备心电的心率与R-R间期由全程整数运算的检测器从ADC计数得出, 与嵌入式网关一致\n"
+        "启用后波形上不显示R波标记; 模拟数据仍使用上面选择的算法"));
+    mqttTopicLayout->addRow(m_fixedPointDetectionCheck);
     
     mqttLayout->addWidget(mqttTopicGroup);
     
@@ -264,8 +287,20 @@ void SettingsDialog::setupUI()
     m_vitalsRangeCombo->addItem(QStringLiteral("6小时"), 360);
     m_vitalsRangeCombo->setCurrentIndex(2);
     
+    m_frameRateCombo = new QComboBox();
+    m_frameRateCombo->addItem(QStringLiteral("30 帧/秒"), 30);
+    m_frameRateCombo->addItem(QStringLiteral("60 帧/秒"), 60);
+    m_frameRateCombo->setCurrentIndex(0);
+    m_frameRateCombo->setToolTip(QStringLiteral("波形与趋势图的统一刷新频率\n与数据到达频率无关, 低配主机建议30帧"));
+
+    m_ecgSweepModeCheck = new QCheckBox(QStringLiteral("扫描显示 (监护仪样式)"));
+    m_ecgSweepModeCheck->setChecked(false);
+    m_ecgSweepModeCheck->setToolTip(QStringLiteral("心电波形从左到右扫描覆盖, 每帧只绘制新数据\n固定增益 ±500mV, 不显示坐标轴"));
+
     displayFormLayout->addRow(QStringLiteral("心电图显示时长:"), m_ecgDurationSpin);
     displayFormLayout->addRow(QStringLiteral("趋势图时间范围:"), m_vitalsRangeCombo);
+    displayFormLayout->addRow(QStringLiteral("刷新帧率:"), m_frameRateCombo);
+    displayFormLayout->addRow(QStringLiteral("心电图样式:"), m_ecgSweepModeCheck);
 
     displayLayout->addWidget(displayGroup);
 
@@ -318,6 +353,13 @@ void SettingsDialog::setupUI()
     ));
     filterHintLabel->setStyleSheet("color: #7a8899; font-size: 11px; padding: 8px;");
     filterFormLayout->addRow(filterHintLabel);
+
+    m_ecgWaveletDenoiseCheck = new QCheckBox(QStringLiteral("小波去噪 (代替低通滤波)"));
+    m_ecgWaveletDenoiseCheck->setChecked(false);
+    m_ecgWaveletDenoiseCheck->setToolTip(QStringLiteral(
+        "按噪声电平自适应收缩小波系数, 保留R波幅度与QRS宽度\n"
+        "波形显示延后约0.5秒; 历史记录分析同样先做小波去噪"));
+    filterFormLayout->addRow(m_ecgWaveletDenoiseCheck);
     
     displayLayout->addWidget(filterGroup);
     displayLayout->addStretch();
@@ -360,6 +402,12 @@ void SettingsDialog::loadSettings()
     m_hrTopicEdit->setText(settings.value("mqtt/hrTopic", "health/heartrate").toString());
     m_spo2TopicEdit->setText(settings.value("mqtt/spo2Topic", "health/spo2").toString());
     m_ecgTopicEdit->setText(settings.value("mqtt/ecgTopic", "health/ecg").toString());
+    int rateIndex = m_ecgSampleRateCombo->findData(settings.value("ecg/deviceSampleRate", 200).toInt());
+    if (rateIndex >= 0) m_ecgSampleRateCombo->setCurrentIndex(rateIndex);
+    int algorithmIndex = m_qrsAlgorithmCombo->findData(QrsDetector::algorithmKey(
+        QrsDetector::algorithmFromKey(settings.value("ecg/qrsAlgorithm").toString())));
+    if (algorithmIndex >= 0) m_qrsAlgorithmCombo->setCurrentIndex(algorithmIndex);
+    m_fixedPointDetectionCheck->setChecked(settings.value("ecg/fixedPointDetection", false).toBool());
     
     // 报警阈值
     m_tempHighSpin->setValue(settings.value("alarm/tempHigh", 37.5).toDouble());
@@ -380,10 +428,14 @@ void SettingsDialog::loadSettings()
     m_ecgDurationSpin->setValue(settings.value("display/ecgDuration", 5).toInt());
     int vitalsIndex = m_vitalsRangeCombo->findData(settings.value("display/vitalsRange", 60).toInt());
     if (vitalsIndex >= 0) m_vitalsRangeCombo->setCurrentIndex(vitalsIndex);
+    int frameRateIndex = m_frameRateCombo->findData(settings.value("display/frameRate", 30).toInt());
+    if (frameRateIndex >= 0) m_frameRateCombo->setCurrentIndex(frameRateIndex);
+    m_ecgSweepModeCheck->setChecked(settings.value("display/ecgSweepMode", false).toBool());
     
     // ECG滤波设置
     m_ecgFilterEnabledCheck->setChecked(settings.value("ecg/filterEnabled", true).toBool());
     m_ecgFilterCoefficientSpin->setValue(settings.value("ecg/filterCoefficient", 0.25).toDouble());
+    m_ecgWaveletDenoiseCheck->setChecked(settings.value("ecg/waveletDenoise", false).toBool());
 
     // 显示信息选择
     m_showTempCheck->setChecked(settings.value("display/showTemp", true).toBool());
@@ -405,6 +457,9 @@ void SettingsDialog::saveSettings()
     settings.setValue("mqtt/hrTopic", m_hrTopicEdit->text());
     settings.setValue("mqtt/spo2Topic", m_spo2TopicEdit->text());
     settings.setValue("mqtt/ecgTopic", m_ecgTopicEdit->text());
+    settings.setValue("ecg/deviceSampleRate", m_ecgSampleRateCombo->currentData().toInt());
+    settings.setValue("ecg/qrsAlgorithm", m_qrsAlgorithmCombo->currentData().toString());
+    settings.setValue("ecg/fixedPointDetection", m_fixedPointDetectionCheck->isChecked());
     
     // 报警阈值
     settings.setValue("alarm/tempHigh", m_tempHighSpin->value());
@@ -424,10 +479,13 @@ void SettingsDialog::saveSettings()
     // 显示设置
     settings.setValue("display/ecgDuration", m_ecgDurationSpin->value());
     settings.setValue("display/vitalsRange", m_vitalsRangeCombo->currentData().toInt());
+    settings.setValue("display/frameRate", m_frameRateCombo->currentData().toInt());
+    settings.setValue("display/ecgSweepMode", m_ecgSweepModeCheck->isChecked());
     
     // ECG滤波设置
     settings.setValue("ecg/filterEnabled", m_ecgFilterEnabledCheck->isChecked());
     settings.setValue("ecg/filterCoefficient", m_ecgFilterCoefficientSpin->value());
+    settings.setValue("ecg/waveletDenoise", m_ecgWaveletDenoiseCheck->isChecked());
 
     // 显示信息选择
     settings.setValue("display/showTemp", m_showTempCheck->isChecked());
@@ -443,6 +501,12 @@ QString SettingsDialog::getTempTopic() const { return m_tempTopicEdit->text(); }
 QString SettingsDialog::getHrTopic() const { return m_hrTopicEdit->text(); }
 QString SettingsDialog::getSpo2Topic() const { return m_spo2TopicEdit->text(); }
 QString SettingsDialog::getEcgTopic() const { return m_ecgTopicEdit->text(); }
+int SettingsDialog::getEcgSampleRate() const { return m_ecgSampleRateCombo->currentData().toInt(); }
+QrsDetector::Algorithm SettingsDialog::getQrsAlgorithm() const
+{
+    return QrsDetector::algorithmFromKey(m_qrsAlgorithmCombo->currentData().toString());
+}
+bool SettingsDialog::isFixedPointDetectionEnabled() const { return m_fixedPointDetectionCheck->isChecked(); }
 
 void SettingsDialog::setMqttSettings(const QString& host, quint16 port,
                                       const QString& username, const QString& password)
@@ -500,6 +564,8 @@ void SettingsDialog::setCloudSettings(const QString& url, const QString& apiKey,
 
 int SettingsDialog::getEcgDisplayDuration() const { return m_ecgDurationSpin->value(); }
 int SettingsDialog::getVitalsTimeRange() const { return m_vitalsRangeCombo->currentData().toInt(); }
+int SettingsDialog::getRenderFrameRate() const { return m_frameRateCombo->currentData().toInt(); }
+bool SettingsDialog::isEcgSweepMode() const { return m_ecgSweepModeCheck->isChecked(); }
 bool SettingsDialog::isAlarmSoundEnabled() const { return m_alarmSoundCheck->isChecked(); }
 
 void SettingsDialog::setDisplaySettings(int ecgDuration, int vitalsRange, bool alarmSound)
@@ -526,6 +592,11 @@ void SettingsDialog::setEcgFilterSettings(bool enabled, double coefficient)
     m_ecgFilterCoefficientSpin->setValue(coefficient);
 }
 
+bool SettingsDialog::isEcgWaveletDenoiseEnabled() const
+{
+    return m_ecgWaveletDenoiseCheck->isChecked();
+}
+
 bool SettingsDialog::isShowTemperature() const { return m_showTempCheck->isChecked(); }
 bool SettingsDialog::isShowHeartRate() const    { return m_showHrCheck->isChecked(); }
 bool SettingsDialog::isShowBloodOxygen() const  { return m_showSpo2Check->isChecked(); }
@@ -564,6 +635,9 @@ void SettingsDialog::onResetDefaults()
         m_hrTopicEdit->setText("health/heartrate");
         m_spo2TopicEdit->setText("health/spo2");
         m_ecgTopicEdit->setText("health/ecg");
+        m_ecgSampleRateCombo->setCurrentIndex(m_ecgSampleRateCombo->findData(200));
+        m_qrsAlgorithmCombo->setCurrentIndex(0);
+        m_fixedPointDetectionCheck->setChecked(false);
         
         m_tempHighSpin->setValue(37.5);
         m_tempLowSpin->setValue(35.0);
@@ -577,9 +651,12 @@ void SettingsDialog::onResetDefaults()
         
         m_ecgDurationSpin->setValue(5);
         m_vitalsRangeCombo->setCurrentIndex(2);
+        m_frameRateCombo->setCurrentIndex(0);
+        m_ecgSweepModeCheck->setChecked(false);
         
         m_ecgFilterEnabledCheck->setChecked(true);
         m_ecgFilterCoefficientSpin->setValue(0.25);
+        m_ecgWaveletDenoiseCheck->setChecked(false);
 
         m_showTempCheck->setChecked(true);
         m_showHrCheck->setChecked(true);
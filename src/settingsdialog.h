@@ -8,6 +8,7 @@
 #include <QPushButton>
 #include <QTabWidget>
 #include "vitaldata.h"
+#include "qrsdetector.h"
 
 class SettingsDialog : public QDialog {
     Q_OBJECT
@@ -25,6 +26,9 @@ public:
     QString getHrTopic() const;
     QString getSpo2Topic() const;
     QString getEcgTopic() const;
+    int getEcgSampleRate() const;
+    QrsDetector::Algorithm getQrsAlgorithm() const;
+    bool isFixedPointDetectionEnabled() const;
     
     void setMqttSettings(const QString& host, quint16 port,
                          const QString& username, const QString& password);
@@ -48,6 +52,8 @@ public:
     // 显示设置
     int getEcgDisplayDuration() const;
     int getVitalsTimeRange() const;
+    int getRenderFrameRate() const;
+    bool isEcgSweepMode() const;
     bool isAlarmSoundEnabled() const;
     
     void setDisplaySettings(int ecgDuration, int vitalsRange, bool alarmSound);
@@ -56,6 +62,7 @@ public:
     bool isEcgFilterEnabled() const;
     double getEcgFilterCoefficient() const;
     void setEcgFilterSettings(bool enabled, double coefficient);
+    bool isEcgWaveletDenoiseEnabled() const;
 
     // 显示信息选择
     bool isShowTemperature() const;
@@ -89,6 +96,9 @@ private:
     QLineEdit* m_hrTopicEdit;
     QLineEdit* m_spo2TopicEdit;
     QLineEdit* m_ecgTopicEdit;
+    QComboBox* m_ecgSampleRateCombo;
+    QComboBox* m_qrsAlgorithmCombo;
+    QCheckBox* m_fixedPointDetectionCheck;
     QPushButton* m_testMqttButton;
     
     // 报警阈值控件
@@ -110,6 +120,8 @@ private:
     // 显示设置控件
     QSpinBox* m_ecgDurationSpin;
     QComboBox* m_vitalsRangeCombo;
+    QComboBox* m_frameRateCombo;
+    QCheckBox* m_ecgSweepModeCheck;
 
     // 显示信息选择控件
     QCheckBox* m_showTempCheck;
@@ -119,4 +131,5 @@ private:
     // ECG滤波控件
     QCheckBox* m_ecgFilterEnabledCheck;
     QDoubleSpinBox* m_ecgFilterCoefficientSpin;
+    QCheckBox* m_ecgWaveletDenoiseCheck;
 };
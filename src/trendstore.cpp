@@ -0,0 +1,202 @@
+#include "trendstore.h"
+#include <algorithm>
+
+namespace {
+
+constexpr qint64 kSecondMs = 1000;
+constexpr qint64 kMinuteMs = 60 * kSecondMs;
+constexpr qint64 kHourMs = 60 * kMinuteMs;
+constexpr qint64 kDayMs = 24 * kHourMs;
+
+} // namespace
+
+TrendStore::TrendStore()
+{
+}
+
+qint64 TrendStore::bucketMs(Level level)
+{
+    switch (level) {
+    case TenSeconds: return 10 * kSecondMs;
+    case OneMinute:  return kMinuteMs;
+    case TenMinutes: return 10 * kMinuteMs;
+    default:         return 0;
+    }
+}
+
+qint64 TrendStore::retentionMs(Level level)
+{
+    switch (level) {
+    case Raw:        return kHourMs;
+    case TenSeconds: return kDayMs;
+    case OneMinute:  return 7 * kDayMs;
+    default:         return 90 * kDayMs;
+    }
+}
+
+void TrendStore::clear()
+{
+    for (int level = 0; level < LevelCount; ++level) {
+        m_levels[level].clear();
+        m_open[level] = Accumulator();
+        m_trimmed[level] = false;
+    }
+}
+
+// ============================================================
+// 追加
+// ============================================================
+
+void TrendStore::Accumulator::add(const Bucket& bucket)
+{
+    if (count == 0) {
+        min = bucket.min;
+        max = bucket.max;
+    } else {
+        min = qMin(min, bucket.min);
+        max = qMax(max, bucket.max);
+    }
+    sum += bucket.mean * bucket.count;
+    count += bucket.count;
+}
+
+TrendStore::Bucket TrendStore::Accumulator::toBucket() const
+{
+    Bucket bucket;
+    bucket.timeMs = timeMs;
+    bucket.min = min;
+    bucket.max = max;
+    bucket.mean = count > 0 ? sum / count : 0.0;
+    bucket.count = count;
+    return bucket;
+}
+
+void TrendStore::append(qint64 timeMs, double value)
+{
+    appendBucket(Bucket{timeMs, value, value, value, 1});
+}
+
+void TrendStore::appendBucket(const Bucket& sample)
+{
+    if (sample.count <= 0) return;
+    const qint64 timeMs = sample.timeMs;
+
+    // 原始级: 个别迟到样本按时间插入, 保持有序
+    QList<Bucket>& raw = m_levels[Raw];
+    if (raw.isEmpty() || timeMs >= raw.last().timeMs) {
+        raw.append(sample);
+    } else {
+        auto pos = std::upper_bound(raw.begin(), raw.end(), timeMs,
+                                    [](qint64 t, const Bucket& b) { return t < b.timeMs; });
+        raw.insert(pos, sample);
+    }
+    trim(Raw);
+
+    for (int l = TenSeconds; l < LevelCount; ++l) {
+        const Level level = static_cast<Level>(l);
+        const qint64 width = bucketMs(level);
+        const qint64 start = timeMs - ((timeMs % width) + width) % width;
+        Accumulator& open = m_open[level];
+        if (open.count > 0 && start > open.timeMs) {
+            m_levels[level].append(open.toBucket());
+            trim(level);
+            open = Accumulator();
+        }
+        if (open.count == 0) {
+            open.timeMs = start;
+        }
+        open.add(sample);
+    }
+}
+
+void TrendStore::trim(Level level)
+{
+    // 以该级最新数据为基准丢弃超出保留时长的部分; 过期部分累积到总量的 1/4 再成批删除,
+    // 均摊 O(1), 保留时长最多多出约三分之一
+    QList<Bucket>& data = m_levels[level];
+    if (data.isEmpty()) return;
+    const int expired = lowerBound(level, data.last().timeMs - retentionMs(level));
+    if (expired > 0 && expired >= data.size() / 4) {
+        data.remove(0, expired);
+        m_trimmed[level] = true;
+    }
+}
+
+// ============================================================
+// 查询
+// ============================================================
+
+int TrendStore::lowerBound(Level level, qint64 timeMs) const
+{
+    const QList<Bucket>& data = m_levels[level];
+    auto pos = std::lower_bound(data.cbegin(), data.cend(), timeMs,
+                                [](const Bucket& b, qint64 t) { return b.timeMs < t; });
+    return static_cast<int>(pos - data.cbegin());
+}
+
+TrendStore::Level TrendStore::levelFor(qint64 fromMs, qint64 toMs, int maxPoints) const
+{
+    for (int l = Raw; l < TenMinutes; ++l) {
+        const Level level = static_cast<Level>(l);
+        const QList<Bucket>& data = m_levels[level];
+
+        // 该级丢弃过数据且最早的数据晚于查询起点: 覆盖不到, 换更粗的一级
+        if (m_trimmed[level] && (data.isEmpty() || data.first().timeMs > fromMs)) continue;
+
+        qint64 count;
+        if (level == Raw) {
+            count = lowerBound(Raw, toMs + 1) - lowerBound(Raw, fromMs);
+        } else {
+            count = (toMs - fromMs) / bucketMs(level) + 1;
+        }
+        if (count <= maxPoints) return level;
+    }
+    return TenMinutes;
+}
+
+QList<TrendStore::Bucket> TrendStore::query(Level level, qint64 fromMs, qint64 toMs) const
+{
+    QList<Bucket> result;
+    if (toMs < fromMs) return result;
+
+    // 与区间有重叠的桶: 起始时间在 (fromMs - 桶宽, toMs] 内
+    const QList<Bucket>& data = m_levels[level];
+    const qint64 width = bucketMs(level);
+    const int first = lowerBound(level, fromMs - width + 1);
+    const int last = lowerBound(level, toMs + 1);
+    result.reserve(last - first + 1);
+    for (int i = first; i < last; ++i) {
+        result.append(data[i]);
+    }
+
+    if (level != Raw) {
+        const Accumulator& open = m_open[level];
+        if (open.count > 0 && open.timeMs <= toMs && open.timeMs + width > fromMs) {
+            result.append(open.toBucket());
+        }
+    }
+    return result;
+}
+
+QList<QPointF> TrendStore::trendPoints(qint64 fromMs, qint64 toMs, int maxPoints) const
+{
+    const Level level = levelFor(fromMs, toMs, maxPoints);
+    const QList<Bucket> buckets = query(level, fromMs, toMs);
+    const double offset = bucketMs(level) / 2.0;
+
+    QList<QPointF> points;
+    points.reserve(2 * buckets.size());
+    for (const Bucket& bucket : buckets) {
+        const double x = bucket.timeMs + offset;
+        if (bucket.min == bucket.max) {
+            points.append(QPointF(x, bucket.min));
+            continue;
+        }
+        // 先到与上一点较近的一端, 相邻桶之间不产生多余的跨越
+        const bool minFirst = !points.isEmpty()
+            && qAbs(points.last().y() - bucket.min) < qAbs(points.last().y() - bucket.max);
+        points.append(QPointF(x, minFirst ? bucket.min : bucket.max));
+        points.append(QPointF(x, minFirst ? bucket.max : bucket.min));
+    }
+    return points;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <QList>
+#include <QPointF>
+#include <QtGlobal>
+
+// 生命体征多分辨率趋势存储: 原始点与 10秒 / 1分钟 / 10分钟 三级时间桶同时维护,
+// 每个桶记录最小/最大/均值。追加一个样本只更新各级当前桶, O(1)
+//
+// 各级保留时长不同 (原始1小时, 10秒级24小时, 1分钟级7天, 10分钟级90天), 总内存有界;
+// 趋势图按时间范围选择点数不超过上限的最细一级, 24小时、7天的趋势直接取现成的桶,
+// 绘制点数与时间范围无关
+class TrendStore {
+public:
+    enum Level {
+        Raw,
+        TenSeconds,
+        OneMinute,
+        TenMinutes,
+        LevelCount
+    };
+
+    // 时间桶 (原始级为单个样本 min = max = mean, count = 1, 或 appendBucket() 追加的预聚合桶)
+    struct Bucket {
+        qint64 timeMs = 0;   // 桶起始时间 (原始级为样本时间), 毫秒时间戳
+        double min = 0.0;
+        double max = 0.0;
+        double mean = 0.0;
+        int count = 0;
+    };
+
+    TrendStore();
+
+    // 样本按时间顺序追加; 早于当前桶的迟到样本并入当前桶
+    void append(qint64 timeMs, double value);
+    // 外部预聚合的桶 (如数据库按时间桶聚合的历史): 原始级存为一项, 各聚合级按最小/最大/均值并入
+    void appendBucket(const Bucket& bucket);
+    void clear();
+    bool isEmpty() const { return m_open[TenSeconds].count == 0; }
+
+    // 桶宽 (原始级为0) 与保留时长, 毫秒
+    static qint64 bucketMs(Level level);
+    static qint64 retentionMs(Level level);
+
+    // [fromMs, toMs] 内点数不超过 maxPoints 且覆盖 fromMs 的最细一级; 都不满足时取最粗一级
+    Level levelFor(qint64 fromMs, qint64 toMs, int maxPoints) const;
+
+    // 指定级别在 [fromMs, toMs] 内的桶 (含尚未结束的当前桶)
+    QList<Bucket> query(Level level, qint64 fromMs, qint64 toMs) const;
+
+    // 趋势曲线: 每个桶画出其最小/最大值的包络 (桶内只有一个值时为一点), x 取桶中点
+    // (原始级为样本时间), 毫秒时间戳。两端按与上一点的远近排序, 折线经过每个桶的全部范围,
+    // 短暂的血氧下降或心率骤升在粗粒度级别上也不会被均值抹平
+    QList<QPointF> trendPoints(qint64 fromMs, qint64 toMs, int maxPoints) const;
+
+private:
+    struct Accumulator {
+        qint64 timeMs = 0;
+        double min = 0.0;
+        double max = 0.0;
+        double sum = 0.0;
+        int count = 0;
+
+        void add(const Bucket& bucket);
+        Bucket toBucket() const;
+    };
+
+    // level 级已结束的桶中第一个 timeMs >= timeMs 的位置
+    int lowerBound(Level level, qint64 timeMs) const;
+    void trim(Level level);
+
+    QList<Bucket> m_levels[LevelCount];   // 各级已结束的桶 (原始级为全部样本), 按时间递增
+    Accumulator m_open[LevelCount];       // 聚合级当前桶 (下标 Raw 不使用)
+    bool m_trimmed[LevelCount] = {};      // 该级是否已因保留时长丢弃过数据
+};
@@ -52,6 +52,101 @@ struct VitalData {
     }
 };
 
+// 历史查询的列式结果集 (一页): 每列一个连续数组, 不含心电原始数据 (只记录点数, 回放时按 id
+// 单独读取), 表格模型按需格式化单元格
+struct VitalColumns {
+    QVector<qint64> ids;
+    QVector<qint64> timestamps;       // 毫秒时间戳
+    QVector<float> temperatures;      // 体温 (°C), 0 为无数据
+    QVector<qint16> heartRates;       // 心率 (bpm), 0 为无数据
+    QVector<qint16> bloodOxygens;     // 血氧 (%), 0 为无数据
+    QVector<qint32> ecgCounts;        // 心电点数, 0 为无心电数据
+
+    int size() const { return ids.size(); }
+    bool isEmpty() const { return ids.isEmpty(); }
+
+    void clear() {
+        ids.clear();
+        timestamps.clear();
+        temperatures.clear();
+        heartRates.clear();
+        bloodOxygens.clear();
+        ecgCounts.clear();
+    }
+
+    void append(const VitalColumns& other) {
+        ids += other.ids;
+        timestamps += other.timestamps;
+        temperatures += other.temperatures;
+        heartRates += other.heartRates;
+        bloodOxygens += other.bloodOxygens;
+        ecgCounts += other.ecgCounts;
+    }
+};
+
+// 列式分页查询的位置: 上一页最后一行的时间戳原文与 id, 为空时从查询范围起点开始
+struct VitalPageCursor {
+    QString timestamp;
+    qint64 id = 0;
+};
+
+// 历史趋势的一个时间桶: 桶内有效值 (> 0) 的最小/最大/均值, count 为有效值个数
+struct VitalTrendBucket {
+    qint64 timeMs = 0;   // 桶起始时间, 毫秒时间戳
+    double min = 0.0;
+    double max = 0.0;
+    double mean = 0.0;
+    int count = 0;
+};
+
+// 按时间桶聚合的历史趋势, 各项只含有数据的桶
+struct VitalTrend {
+    qint64 bucketMs = 0;
+    QVector<VitalTrendBucket> temperatures;
+    QVector<VitalTrendBucket> heartRates;
+    QVector<VitalTrendBucket> bloodOxygens;
+};
+
+// 一次上报的心电数据 (数据库中的一行), 时间戳精确到秒
+struct EcgSegment {
+    qint64 timeMs = 0;
+    QVector<double> samples;
+};
+
+// 逐包存储的心电在时间轴上的排布: 时间戳相同 (同一秒) 的各包按存储顺序、按采样率首尾相接,
+// 每个新的时间戳从时间戳本身开始。排布只取决于同一秒内的包, 心电摘要金字塔 (实时写入与重建)
+// 和全览读取原始样本用它得到相同的样本时刻, 与从哪一包开始读取无关
+class EcgSampleClock {
+public:
+    explicit EcgSampleClock(int sampleRate = 200)
+        : m_periodMs(1000.0 / qMax(1, sampleRate)) {}
+
+    double periodMs() const { return m_periodMs; }
+
+    // 一包心电首个样本的时刻 (毫秒时间戳), 其后的样本依次加一个采样周期
+    double place(qint64 packetMs, int sampleCount) {
+        if (packetMs != m_packetMs) {
+            m_packetMs = packetMs;
+            m_nextMs = static_cast<double>(packetMs);
+        }
+        const double start = m_nextMs;
+        m_nextMs += sampleCount * m_periodMs;
+        return start;
+    }
+
+private:
+    double m_periodMs;
+    qint64 m_packetMs = -1;
+    double m_nextMs = 0.0;
+};
+
+// 心电摘要金字塔的一个桶: 覆盖时间内样本的最小/最大值
+struct EcgSummaryBucket {
+    qint64 startMs = 0;
+    float min = 0.0f;
+    float max = 0.0f;
+};
+
 // 报警信息结构
 struct AlarmInfo {
     enum AlarmType {
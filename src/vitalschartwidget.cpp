@@ -1,14 +1,22 @@
 #include "vitalschartwidget.h"
+#include "renderticker.h"
 #include <QVBoxLayout>
 #include <QPen>
 #include <QBrush>
 
 using namespace Qt;
 
+namespace {
+
+// 趋势曲线桶数下限 (控件尚未显示、宽度为0时)
+constexpr int kMinTrendPoints = 200;
+
+} // namespace
+
 VitalsChartWidget::VitalsChartWidget(ChartType type, QWidget* parent)
     : QWidget(parent)
     , m_chartType(type)
-    , m_chartView(new QChartView(this))
+    , m_chartView(new CachedChartView(this))
     , m_chart(new QChart())
     , m_tempSeries(new QLineSeries())
     , m_hrSeries(new QLineSeries())
@@ -23,6 +31,11 @@ VitalsChartWidget::VitalsChartWidget(ChartType type, QWidget* parent)
     QVBoxLayout* layout = new QVBoxLayout(this);
     layout->setContentsMargins(0, 0, 0, 0);
     layout->addWidget(m_chartView);
+
+    // 新数据只写入趋势存储, 曲线与时间轴在渲染节拍上统一更新
+    RenderTicker* ticker = RenderTicker::shared();
+    connect(ticker, &RenderTicker::tick, this, &VitalsChartWidget::onRenderTick);
+    ticker->addClient(this);
 }
 
 VitalsChartWidget::~VitalsChartWidget()
@@ -44,7 +57,7 @@ void VitalsChartWidget::setupChart()
     m_axisX->setTitleText(QStringLiteral("时间"));
     m_axisX->setTitleBrush(QBrush(Qt::white));
     m_axisX->setLabelsBrush(QBrush(Qt::white));
-    m_axisX->setGridLineColor(QColor("#2a4a6a"));
+    m_axisX->setGridLineVisible(false);
     m_chart->addAxis(m_axisX, Qt::AlignBottom);
     
     // 体温系列 - 橙红色
@@ -57,7 +70,7 @@ void VitalsChartWidget::setupChart()
     m_axisYTemp->setTitleText(QStringLiteral("体温 (°C)"));
     m_axisYTemp->setTitleBrush(QBrush(QColor("#ff6b6b")));
     m_axisYTemp->setLabelsBrush(QBrush(QColor("#ff6b6b")));
-    m_axisYTemp->setGridLineColor(QColor("#2a4a6a"));
+    m_axisYTemp->setGridLineVisible(false);
     
     // 心率系列 - 青色
     m_hrSeries->setName(QStringLiteral("心率 (bpm)"));
@@ -69,7 +82,7 @@ void VitalsChartWidget::setupChart()
     m_axisYHr->setTitleText(QStringLiteral("心率 (bpm)"));
     m_axisYHr->setTitleBrush(QBrush(QColor("#4ecdc4")));
     m_axisYHr->setLabelsBrush(QBrush(QColor("#4ecdc4")));
-    m_axisYHr->setGridLineColor(QColor("#2a4a6a"));
+    m_axisYHr->setGridLineVisible(false);
     
     // 血氧系列 - 蓝色
     m_spo2Series->setName(QStringLiteral("血氧 (%)"));
@@ -81,7 +94,7 @@ void VitalsChartWidget::setupChart()
     m_axisYSpo2->setTitleText(QStringLiteral("血氧 (%)"));
     m_axisYSpo2->setTitleBrush(QBrush(QColor("#45b7d1")));
     m_axisYSpo2->setLabelsBrush(QBrush(QColor("#45b7d1")));
-    m_axisYSpo2->setGridLineColor(QColor("#2a4a6a"));
+    m_axisYSpo2->setGridLineVisible(false);
     
     // 根据图表类型添加系列和轴
     switch (m_chartType) {
@@ -138,76 +151,76 @@ void VitalsChartWidget::setupChart()
 
 void VitalsChartWidget::applyTheme()
 {
+    // 图表背景与视图同色, 由视图的静态图层连同网格一起绘制, 曲线更新时不随场景重画
     QColor bgColor("#0a1628");
-    m_chart->setBackgroundBrush(QBrush(bgColor));
-    m_chart->setBackgroundRoundness(8);
+    m_chart->setBackgroundVisible(false);
     m_chartView->setBackgroundBrush(QBrush(bgColor));
+    m_chartView->setGridColor(QColor("#2a4a6a"));
 }
 
 void VitalsChartWidget::addTemperaturePoint(double value, const QDateTime& timestamp)
 {
-    m_tempSeries->append(timestamp.toMSecsSinceEpoch(), value);
-    
-    while (m_tempSeries->count() > m_maxPoints) {
-        m_tempSeries->remove(0);
-    }
-    
-    updateTimeAxis();
+    m_tempTrend.append(timestamp.toMSecsSinceEpoch(), value);
+    m_seriesDirty = true;
 }
 
 void VitalsChartWidget::addHeartRatePoint(int value, const QDateTime& timestamp)
 {
-    m_hrSeries->append(timestamp.toMSecsSinceEpoch(), value);
-    
-    while (m_hrSeries->count() > m_maxPoints) {
-        m_hrSeries->remove(0);
-    }
-    
-    updateTimeAxis();
+    m_hrTrend.append(timestamp.toMSecsSinceEpoch(), value);
+    m_seriesDirty = true;
 }
 
 void VitalsChartWidget::addBloodOxygenPoint(int value, const QDateTime& timestamp)
 {
-    m_spo2Series->append(timestamp.toMSecsSinceEpoch(), value);
-    
-    while (m_spo2Series->count() > m_maxPoints) {
-        m_spo2Series->remove(0);
-    }
-    
-    updateTimeAxis();
+    m_spo2Trend.append(timestamp.toMSecsSinceEpoch(), value);
+    m_seriesDirty = true;
 }
 
-void VitalsChartWidget::setData(const QVector<QPair<QDateTime, double>>& tempData,
-                                 const QVector<QPair<QDateTime, int>>& hrData,
-                                 const QVector<QPair<QDateTime, int>>& spo2Data)
+void VitalsChartWidget::setData(const VitalTrend& trend)
 {
-    m_tempSeries->clear();
-    m_hrSeries->clear();
-    m_spo2Series->clear();
+    // 历史查询在数据库中按时间桶聚合, 桶数与记录数无关; 每个桶以其中点进入趋势存储,
+    // 曲线按时间范围取合适的分辨率
+    const qint64 offset = trend.bucketMs / 2;
+    const auto fill = [offset](TrendStore& store, const QVector<VitalTrendBucket>& buckets) {
+        store.clear();
+        for (const VitalTrendBucket& b : buckets) {
+            store.appendBucket(TrendStore::Bucket{b.timeMs + offset, b.min, b.max, b.mean, b.count});
+        }
+    };
+    fill(m_tempTrend, trend.temperatures);
+    fill(m_hrTrend, trend.heartRates);
+    fill(m_spo2Trend, trend.bloodOxygens);
     
-    for (const auto& pair : tempData) {
-        m_tempSeries->append(pair.first.toMSecsSinceEpoch(), pair.second);
-    }
-    
-    for (const auto& pair : hrData) {
-        m_hrSeries->append(pair.first.toMSecsSinceEpoch(), pair.second);
-    }
-    
-    for (const auto& pair : spo2Data) {
-        m_spo2Series->append(pair.first.toMSecsSinceEpoch(), pair.second);
-    }
-    
-    updateTimeAxis();
+    m_seriesDirty = true;
+}
+
+void VitalsChartWidget::refreshSeries()
+{
+    // 桶数上限为绘图区像素列数, 每个桶画最小/最大两点, 与 M4 抽取一样每列不超过4点;
+    // 绘图区尚未布局时按整个视图宽度估计
+    qreal width = m_chart->plotArea().width();
+    if (width <= 0) width = m_chartView->width();
+    const int maxPoints = qMax(kMinTrendPoints, qRound(width * devicePixelRatioF()));
+
+    const qint64 to = QDateTime::currentMSecsSinceEpoch();
+    const qint64 from = to - qint64(m_timeRangeMinutes) * 60 * 1000;
+    m_tempSeries->replace(m_tempTrend.trendPoints(from, to, maxPoints));
+    m_hrSeries->replace(m_hrTrend.trendPoints(from, to, maxPoints));
+    m_spo2Series->replace(m_spo2Trend.trendPoints(from, to, maxPoints));
 }
 
 void VitalsChartWidget::setTimeRange(int minutes)
 {
     m_timeRangeMinutes = minutes;
+    m_seriesDirty = true;
     updateTimeAxis();
 }
 
 void VitalsChartWidget::clear()
 {
+    m_tempTrend.clear();
+    m_hrTrend.clear();
+    m_spo2Trend.clear();
     m_tempSeries->clear();
     m_hrSeries->clear();
     m_spo2Series->clear();
@@ -229,6 +242,35 @@ void VitalsChartWidget::setChartType(ChartType type)
     m_spo2Series = new QLineSeries();
     
     setupChart();
+    refreshSeries();
+}
+
+void VitalsChartWidget::onRenderTick()
+{
+    // 隐藏或最小化时数据照常进入趋势存储, 重新可见后的首个节拍补绘
+    if (!isVisible() || window()->isMinimized()) return;
+
+    if (m_seriesDirty) {
+        m_seriesDirty = false;
+        refreshSeries();
+    }
+    advanceTimeAxis();
+}
+
+void VitalsChartWidget::advanceTimeAxis()
+{
+    // 时间轴每走过一个像素才移动一次: 以1000像素宽为例, 1小时范围约每3.6秒一次, 5分钟范围
+    // 约每0.3秒一次 (30帧/秒时约每9帧); 逐像素移动看起来仍是平滑滚动, 而坐标轴重新布局的
+    // 次数与数据到达频率无关
+    qreal width = m_chart->plotArea().width();
+    if (width <= 0) width = m_chartView->width();
+    const qint64 rangeMs = qint64(m_timeRangeMinutes) * 60 * 1000;
+    const qint64 pixelMs = qMax<qint64>(1, qRound64(rangeMs / qMax<qreal>(1.0, width * devicePixelRatioF())));
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (now - m_axisEndMs < pixelMs) return;
+
+    m_axisEndMs = now;
+    m_axisX->setRange(QDateTime::fromMSecsSinceEpoch(now - rangeMs), QDateTime::fromMSecsSinceEpoch(now));
 }
 
 void VitalsChartWidget::updateTimeAxis()
@@ -237,6 +279,7 @@ void VitalsChartWidget::updateTimeAxis()
     QDateTime start = now.addSecs(-m_timeRangeMinutes * 60);
     
     m_axisX->setRange(start, now);
+    m_axisEndMs = now.toMSecsSinceEpoch();
     
     // 根据时间范围调整时间格式
     if (m_timeRangeMinutes <= 5) {
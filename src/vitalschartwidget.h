@@ -6,6 +6,9 @@
 #include <QtCharts/QValueAxis>
 #include <QVector>
 #include <QDateTime>
+#include "trendstore.h"
+#include "vitaldata.h"
+#include "cachedchartview.h"
 
 class VitalsChartWidget : public QWidget {
     Q_OBJECT
@@ -21,13 +24,13 @@ public:
     explicit VitalsChartWidget(ChartType type = Combined, QWidget* parent = nullptr);
     ~VitalsChartWidget();
 
+    // 数据立即写入趋势存储, 曲线在下一个渲染节拍统一刷新
     void addTemperaturePoint(double value, const QDateTime& timestamp = QDateTime::currentDateTime());
     void addHeartRatePoint(int value, const QDateTime& timestamp = QDateTime::currentDateTime());
     void addBloodOxygenPoint(int value, const QDateTime& timestamp = QDateTime::currentDateTime());
     
-    void setData(const QVector<QPair<QDateTime, double>>& tempData,
-                 const QVector<QPair<QDateTime, int>>& hrData,
-                 const QVector<QPair<QDateTime, int>>& spo2Data);
+    // 历史趋势: 以数据库聚合的时间桶替换趋势存储的内容
+    void setData(const VitalTrend& trend);
     
     void setTimeRange(int minutes);
     void clear();
@@ -35,14 +38,22 @@ public:
     void setChartType(ChartType type);
     ChartType chartType() const { return m_chartType; }
 
+private slots:
+    // RenderTicker 节拍: 有新数据时刷新曲线, 时间轴按像素步进
+    void onRenderTick();
+
 private:
     void setupChart();
+    // 立即按当前时间重设时间轴范围和格式 (时间范围或图表类型变化时)
     void updateTimeAxis();
+    void advanceTimeAxis();
     void applyTheme();
+    // 按当前时间范围与绘图区宽度从趋势存储取点, 整体替换三条曲线
+    void refreshSeries();
 
     ChartType m_chartType;
     
-    QChartView* m_chartView;
+    CachedChartView* m_chartView;   // 背景与网格为缓存图层, 场景中只有坐标轴、图例与曲线
     QChart* m_chart;
     
     QLineSeries* m_tempSeries;
@@ -55,5 +66,11 @@ private:
     QValueAxis* m_axisYSpo2;
     
     int m_timeRangeMinutes = 60;
-    int m_maxPoints = 360;  // 最多显示的点数
+    qint64 m_axisEndMs = 0;      // 时间轴当前右端 (毫秒时间戳)
+    bool m_seriesDirty = false;  // 趋势存储有曲线尚未反映的新数据
+
+    // 多分辨率趋势数据, 曲线只是其在当前时间范围内的视图
+    TrendStore m_tempTrend;
+    TrendStore m_hrTrend;
+    TrendStore m_spo2Trend;
 };
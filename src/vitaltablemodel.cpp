@@ -0,0 +1,132 @@
+#include "vitaltablemodel.h"
+#include "datamanager.h"
+
+namespace {
+
+// 每次从数据库读取并暴露给视图的行数, 约为几屏的高度
+constexpr int kFetchBatch = 256;
+
+} // namespace
+
+VitalTableModel::VitalTableModel(DataManager* dataManager, QObject* parent)
+    : QAbstractTableModel(parent)
+    , m_dataManager(dataManager)
+{
+}
+
+void VitalTableModel::setRange(const QDateTime& start, const QDateTime& end)
+{
+    beginResetModel();
+    m_start = start;
+    m_end = end;
+    m_cursor = VitalPageCursor();
+    m_columns.clear();
+    m_exhausted = false;
+    endResetModel();
+
+    fetchBatch();
+}
+
+void VitalTableModel::clear()
+{
+    beginResetModel();
+    m_columns.clear();
+    m_cursor = VitalPageCursor();
+    m_exhausted = true;
+    endResetModel();
+}
+
+int VitalTableModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_columns.size();
+}
+
+int VitalTableModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant VitalTableModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_columns.size()) {
+        return QVariant();
+    }
+
+    if (role == Qt::TextAlignmentRole) {
+        return index.column() == TimeColumn
+            ? QVariant(Qt::AlignLeft | Qt::AlignVCenter)
+            : QVariant(Qt::AlignRight | Qt::AlignVCenter);
+    }
+
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+
+    const int row = index.row();
+    switch (index.column()) {
+    case TimeColumn:
+        return QDateTime::fromMSecsSinceEpoch(m_columns.timestamps[row])
+            .toString("yyyy-MM-dd HH:mm:ss");
+    case TemperatureColumn: {
+        const float temp = m_columns.temperatures[row];
+        return temp > 0 ? QString::number(temp, 'f', 1) : QStringLiteral("--");
+    }
+    case HeartRateColumn: {
+        const int hr = m_columns.heartRates[row];
+        return hr > 0 ? QString::number(hr) : QStringLiteral("--");
+    }
+    case BloodOxygenColumn: {
+        const int spo2 = m_columns.bloodOxygens[row];
+        return spo2 > 0 ? QString::number(spo2) : QStringLiteral("--");
+    }
+    case EcgColumn: {
+        const int count = m_columns.ecgCounts[row];
+        return count > 0 ? QStringLiteral("%1 点").arg(count) : QStringLiteral("无");
+    }
+    default:
+        return QVariant();
+    }
+}
+
+QVariant VitalTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    if (orientation == Qt::Vertical) {
+        return section + 1;
+    }
+
+    switch (section) {
+    case TimeColumn: return QStringLiteral("时间");
+    case TemperatureColumn: return QStringLiteral("体温 (°C)");
+    case HeartRateColumn: return QStringLiteral("心率 (bpm)");
+    case BloodOxygenColumn: return QStringLiteral("血氧 (%)");
+    case EcgColumn: return QStringLiteral("心电数据");
+    default: return QVariant();
+    }
+}
+
+bool VitalTableModel::canFetchMore(const QModelIndex& parent) const
+{
+    return !parent.isValid() && !m_exhausted;
+}
+
+void VitalTableModel::fetchMore(const QModelIndex& parent)
+{
+    if (parent.isValid()) return;
+    fetchBatch();
+}
+
+void VitalTableModel::fetchBatch()
+{
+    if (m_exhausted || !m_dataManager) return;
+
+    const VitalColumns page = m_dataManager->getVitalColumns(m_start, m_end, &m_cursor, kFetchBatch);
+    m_exhausted = page.size() < kFetchBatch;
+    if (page.isEmpty()) return;
+
+    beginInsertRows(QModelIndex(), m_columns.size(), m_columns.size() + page.size() - 1);
+    m_columns.append(page);
+    endInsertRows();
+}
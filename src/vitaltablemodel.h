@@ -0,0 +1,54 @@
+#pragma once
+#include <QAbstractTableModel>
+#include <QDateTime>
+#include "vitaldata.h"
+
+class DataManager;
+
+// 历史数据表格模型: 列式存放已读取的行, 不为每个单元格创建对象
+//
+// 行按批次从数据库分页读取: 设置查询范围时只读第一批, 滚动到底部时视图通过
+// canFetchMore/fetchMore 取下一批, 打开对话框的开销与记录数无关; 单元格文本在 data()
+// 中按需格式化, 只有可见行会被请求
+class VitalTableModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    enum Column {
+        TimeColumn,
+        TemperatureColumn,
+        HeartRateColumn,
+        BloodOxygenColumn,
+        EcgColumn,
+        ColumnCount
+    };
+
+    explicit VitalTableModel(DataManager* dataManager, QObject* parent = nullptr);
+
+    // 重置为新的查询范围并读取第一批
+    void setRange(const QDateTime& start, const QDateTime& end);
+    void clear();
+
+    qint64 recordId(int row) const { return m_columns.ids.value(row); }
+    int ecgCount(int row) const { return m_columns.ecgCounts.value(row); }
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+
+private:
+    // 读取下一批并追加到已读取的行之后
+    void fetchBatch();
+
+    DataManager* m_dataManager;
+    QDateTime m_start;
+    QDateTime m_end;
+    VitalPageCursor m_cursor;   // 已读取的最后一行
+    bool m_exhausted = true;    // 查询范围内的行已全部读取
+    VitalColumns m_columns;
+};
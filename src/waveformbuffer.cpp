@@ -0,0 +1,135 @@
+#include "waveformbuffer.h"
+
+WaveformBuffer::WaveformBuffer(int capacity)
+{
+    setCapacity(capacity);
+}
+
+void WaveformBuffer::setCapacity(int capacity)
+{
+    capacity = qMax(0, capacity);
+    if (capacity == m_data.size()) return;
+
+    // 按时间顺序重排, 只保留最新的 capacity 个样本
+    const int keep = qMin(m_size, capacity);
+    QVector<double> data(capacity, 0.0);
+    for (int i = 0; i < keep; ++i) {
+        data[i] = at(m_size - keep + i);
+    }
+    m_data = data;
+    m_head = 0;
+    m_size = keep;
+    rebuildExtremes();
+}
+
+void WaveformBuffer::rebuildExtremes()
+{
+    m_minQueue.reset(m_data.size());
+    m_maxQueue.reset(m_data.size());
+    const qint64 first = firstIndex();
+    for (int i = 0; i < m_size; ++i) {
+        m_minQueue.push(first + i, at(i));
+        m_maxQueue.push(first + i, at(i));
+    }
+}
+
+void WaveformBuffer::clear(qint64 nextIndex)
+{
+    m_head = 0;
+    m_size = 0;
+    m_nextIndex = nextIndex;
+    m_minQueue.reset(m_data.size());
+    m_maxQueue.reset(m_data.size());
+}
+
+void WaveformBuffer::append(double value)
+{
+    ++m_nextIndex;
+    const int capacity = m_data.size();
+    if (capacity == 0) return;
+
+    if (m_size < capacity) {
+        int pos = m_head + m_size;
+        if (pos >= capacity) pos -= capacity;
+        m_data[pos] = value;
+        ++m_size;
+    } else {
+        m_data[m_head] = value;
+        if (++m_head == capacity) m_head = 0;
+    }
+
+    const qint64 index = m_nextIndex - 1;
+    m_minQueue.expire(firstIndex());
+    m_maxQueue.expire(firstIndex());
+    m_minQueue.push(index, value);
+    m_maxQueue.push(index, value);
+}
+
+void WaveformBuffer::append(const double* values, int count)
+{
+    // 超过容量的部分只有最后 capacity 个样本会留下
+    const int capacity = m_data.size();
+    if (count > capacity) {
+        m_nextIndex += count - capacity;
+        values += count - capacity;
+        count = capacity;
+    }
+    for (int i = 0; i < count; ++i) {
+        append(values[i]);
+    }
+}
+
+QList<QPointF> WaveformBuffer::toPoints(double sampleRate) const
+{
+    QList<QPointF> points(m_size);
+    const double dt = 1.0 / sampleRate;
+    const qint64 first = firstIndex();
+
+    // 环形缓冲最多分两段连续存储
+    const int firstRun = qMin(m_size, m_data.size() - m_head);
+    const double* data = m_data.constData();
+    QPointF* out = points.data();
+    for (int i = 0; i < firstRun; ++i) {
+        out[i] = QPointF((first + i) * dt, data[m_head + i]);
+    }
+    for (int i = firstRun; i < m_size; ++i) {
+        out[i] = QPointF((first + i) * dt, data[i - firstRun]);
+    }
+    return points;
+}
+
+// ============================================================
+// 单调队列
+// ============================================================
+
+void WaveformBuffer::ExtremeQueue::reset(int capacity)
+{
+    m_items.resize(capacity);
+    m_head = 0;
+    m_count = 0;
+}
+
+void WaveformBuffer::ExtremeQueue::push(qint64 index, double value)
+{
+    // 被新样本支配的候选 (更早且不更极端) 不会再成为极值, 从队尾弹出
+    const int capacity = m_items.size();
+    while (m_count > 0) {
+        int back = m_head + m_count - 1;
+        if (back >= capacity) back -= capacity;
+        const double v = m_items[back].value;
+        if (m_trackMax ? v > value : v < value) break;
+        --m_count;
+    }
+    int pos = m_head + m_count;
+    if (pos >= capacity) pos -= capacity;
+    m_items[pos] = Item{index, value};
+    ++m_count;
+}
+
+void WaveformBuffer::ExtremeQueue::expire(qint64 firstIndex)
+{
+    while (m_count > 0 && m_items[m_head].index < firstIndex) {
+        if (++m_head == m_items.size()) m_head = 0;
+        --m_count;
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <QList>
+#include <QPointF>
+#include <QVector>
+
+// 波形显示环形缓冲: 保存显示窗口内最近 capacity 个样本值, 样本按全局索引等间隔排列
+// (x = 索引 / 采样率), 只存 y 值
+//
+// 追加样本为 O(1), 满后覆盖最旧的样本; 显示端每帧用 toPoints 一次性生成点列,
+// 交给 QXYSeries::replace 整体替换, 取代逐点 append + remove(0)
+//
+// 窗口内最小/最大值由两个单调队列跟踪, 追加均摊 O(1), 查询 O(1), 自动缩放无需遍历
+class WaveformBuffer {
+public:
+    explicit WaveformBuffer(int capacity = 0);
+
+    // 改变容量时保留最新的样本
+    void setCapacity(int capacity);
+    int capacity() const { return m_data.size(); }
+
+    int size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+    bool isFull() const { return m_size == m_data.size(); }
+
+    // 清空, 下一个样本的全局索引为 nextIndex
+    void clear(qint64 nextIndex = 0);
+
+    void append(double value);
+    void append(const double* values, int count);
+
+    // 第 i 个样本 (0 为最旧)
+    double at(int i) const
+    {
+        int pos = m_head + i;
+        if (pos >= m_data.size()) pos -= m_data.size();
+        return m_data[pos];
+    }
+    double last() const { return at(m_size - 1); }
+
+    // 窗口内最小/最大值 (空缓冲返回0)
+    double minimum() const { return m_size > 0 ? m_minQueue.front() : 0.0; }
+    double maximum() const { return m_size > 0 ? m_maxQueue.front() : 0.0; }
+
+    // 最旧样本 / 下一个样本的全局索引
+    qint64 firstIndex() const { return m_nextIndex - m_size; }
+    qint64 nextIndex() const { return m_nextIndex; }
+
+    // 按时间顺序生成显示点列 (x 单位为秒)
+    QList<QPointF> toPoints(double sampleRate) const;
+
+private:
+    // 单调队列: 候选样本按索引递增存放, 值单调 (最小队列递增, 最大队列递减),
+    // 队首即窗口极值。候选数不超过窗口长度, 用定长环形数组存放
+    class ExtremeQueue {
+    public:
+        explicit ExtremeQueue(bool trackMax) : m_trackMax(trackMax) {}
+        void reset(int capacity);
+        void push(qint64 index, double value);
+        // 移除索引小于 firstIndex 的候选 (已滑出窗口)
+        void expire(qint64 firstIndex);
+        double front() const { return m_items[m_head].value; }
+
+    private:
+        struct Item {
+            qint64 index;
+            double value;
+        };
+        bool m_trackMax;
+        QVector<Item> m_items;
+        int m_head = 0;
+        int m_count = 0;
+    };
+
+    void rebuildExtremes();
+
+    ExtremeQueue m_minQueue{false};
+    ExtremeQueue m_maxQueue{true};
+    QVector<double> m_data;
+    int m_head = 0;      // 最旧样本在 m_data 中的位置
+    int m_size = 0;
+    qint64 m_nextIndex = 0;
+};
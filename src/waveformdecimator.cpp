@@ -0,0 +1,158 @@
+#include "waveformdecimator.h"
+#include <cmath>
+#include <algorithm>
+
+namespace {
+
+// 单列的四个代表点 (下标)
+struct Column {
+    int first = -1;
+    int last = -1;
+    int min = -1;
+    int max = -1;
+
+    bool isEmpty() const { return first < 0; }
+
+    template <typename ValueAt>
+    void add(int i, ValueAt valueAt)
+    {
+        if (first < 0) {
+            first = last = min = max = i;
+            return;
+        }
+        last = i;
+        const double v = valueAt(i);
+        if (v < valueAt(min)) min = i;
+        if (v > valueAt(max)) max = i;
+    }
+
+    // 按下标顺序输出去重后的代表点
+    template <typename PointAt>
+    void flush(QList<QPointF>& out, PointAt pointAt)
+    {
+        if (first < 0) return;
+        int picks[4] = {first, min, max, last};
+        std::sort(picks, picks + 4);
+        int previous = -1;
+        for (int i : picks) {
+            if (i != previous) out.append(pointAt(i));
+            previous = i;
+        }
+        *this = Column();
+    }
+};
+
+// 全局样本索引 [from, to) 的样本按 perColumn 对齐分列抽取, 追加到 out
+void appendColumns(const WaveformBuffer& buffer, double sampleRate, int perColumn,
+                   qint64 from, qint64 to, QList<QPointF>& out)
+{
+    const double dt = 1.0 / sampleRate;
+    const qint64 first = buffer.firstIndex();
+    auto valueAt = [&](int i) { return buffer.at(i); };
+    auto pointAt = [&](int i) { return QPointF((first + i) * dt, buffer.at(i)); };
+
+    Column column;
+    int i = static_cast<int>(from - first);
+    const int size = static_cast<int>(to - first);
+    while (i < size) {
+        // 本列的剩余样本数 (首列可能不完整)
+        const int offset = static_cast<int>((first + i) % perColumn);
+        const int end = qMin(size, i + perColumn - offset);
+        for (; i < end; ++i) {
+            column.add(i, valueAt);
+        }
+        column.flush(out, pointAt);
+    }
+}
+
+} // namespace
+
+namespace WaveformDecimator {
+
+QList<QPointF> decimate(const QList<QPointF>& points, double columnWidth)
+{
+    if (points.isEmpty() || columnWidth <= 0.0) return points;
+    const double span = points.last().x() - points.first().x();
+    if (points.size() <= kMinPointsPerColumn * (span / columnWidth + 1.0)) return points;
+
+    QList<QPointF> out;
+    out.reserve(static_cast<int>(4 * (span / columnWidth + 2.0)));
+
+    auto valueAt = [&](int i) { return points[i].y(); };
+    auto pointAt = [&](int i) { return points[i]; };
+    Column column;
+    qint64 currentColumn = 0;
+    for (int i = 0; i < points.size(); ++i) {
+        const qint64 c = static_cast<qint64>(std::floor(points[i].x() / columnWidth));
+        if (!column.isEmpty() && c != currentColumn) {
+            column.flush(out, pointAt);
+        }
+        currentColumn = c;
+        column.add(i, valueAt);
+    }
+    column.flush(out, pointAt);
+    return out;
+}
+
+QList<QPointF> decimate(const WaveformBuffer& buffer, double sampleRate, int columns)
+{
+    const int size = buffer.size();
+    if (columns <= 0 || size == 0) return buffer.toPoints(sampleRate);
+
+    // 每列整数个样本, 按全局索引对齐
+    const int perColumn = qMax(1, buffer.capacity() / columns);
+    if (perColumn <= kMinPointsPerColumn) return buffer.toPoints(sampleRate);
+
+    QList<QPointF> out;
+    out.reserve(4 * (size / perColumn + 2));
+    appendColumns(buffer, sampleRate, perColumn, buffer.firstIndex(), buffer.nextIndex(), out);
+    return out;
+}
+
+void ColumnCache::reset()
+{
+    m_points.clear();
+    m_perColumn = 0;
+    m_nextIndex = 0;
+}
+
+const QList<QPointF>& ColumnCache::update(const WaveformBuffer& buffer, double sampleRate, int columns)
+{
+    const int perColumn = columns > 0 ? qMax(1, buffer.capacity() / columns) : 0;
+    if (buffer.size() == 0 || perColumn <= kMinPointsPerColumn) {
+        reset();
+        m_points = decimate(buffer, sampleRate, columns);
+        return m_points;
+    }
+
+    const qint64 first = buffer.firstIndex();
+    const qint64 next = buffer.nextIndex();
+    if (perColumn != m_perColumn || sampleRate != m_sampleRate || m_nextIndex > next) {
+        m_points.clear();
+        appendColumns(buffer, sampleRate, perColumn, first, next, m_points);
+    } else {
+        // 保留 [headEnd, tailStart) 内各完整列的结果: 左端列已有样本滚出, 上一帧的末列可能不完整
+        const qint64 headEnd = qMin(next, (first / perColumn + 1) * perColumn);
+        const qint64 tailStart = qMax(headEnd, (m_nextIndex - 1) / perColumn * perColumn);
+        auto indexOf = [sampleRate](const QPointF& p) { return qRound64(p.x() * sampleRate); };
+
+        int keepFrom = 0;
+        while (keepFrom < m_points.size() && indexOf(m_points[keepFrom]) < headEnd) ++keepFrom;
+        int keepTo = m_points.size();
+        while (keepTo > keepFrom && indexOf(m_points[keepTo - 1]) >= tailStart) --keepTo;
+
+        QList<QPointF> points;
+        points.reserve(4 * (buffer.capacity() / perColumn + 2));
+        appendColumns(buffer, sampleRate, perColumn, first, headEnd, points);
+        points.append(m_points.mid(keepFrom, keepTo - keepFrom));
+        appendColumns(buffer, sampleRate, perColumn, tailStart, next, points);
+        m_points = points;
+    }
+
+    m_sampleRate = sampleRate;
+    m_perColumn = perColumn;
+    m_nextIndex = next;
+    return m_points;
+}
+
+} // namespace WaveformDecimator
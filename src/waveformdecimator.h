@@ -0,0 +1,38 @@
+#pragma once
+#include <QList>
+#include <QPointF>
+#include "waveformbuffer.h"
+
+// 按像素列的 M4 抽取: 落在同一列的点只保留首点、末点、最小点和最大点 (保持 x 顺序),
+// 绘制点数受控件宽度约束 (每列最多4点), 而折线的包络与逐点绘制一致, QRS 尖峰不会丢失
+//
+// 列边界按 x 的绝对位置划分 (不随窗口起点移动), 数据滚动时已有列的抽取结果保持不变,
+// 波形不会闪烁
+namespace WaveformDecimator {
+
+// 每列点数不超过该值时抽取没有收益, 直接返回原始点
+constexpr int kMinPointsPerColumn = 4;
+
+// 任意 x 递增的点列, columnWidth 为一个像素列对应的 x 跨度
+QList<QPointF> decimate(const QList<QPointF>& points, double columnWidth);
+
+// 显示环形缓冲: 按 columns 个像素列铺满缓冲容量 (显示窗口), x 单位为秒;
+// 等价于 decimate(buffer.toPoints(sampleRate), ...) 但不生成中间点列
+QList<QPointF> decimate(const WaveformBuffer& buffer, double sampleRate, int columns);
+
+// 同一显示环形缓冲的逐帧抽取: 与 decimate(buffer, ...) 结果相同, 但保留上一帧的结果,
+// 每帧只重算左端滚出一部分的列和有新样本的列, 代价与新样本数加列数成正比
+class ColumnCache {
+public:
+    // 缓冲被清空或改变容量后调用
+    void reset();
+    const QList<QPointF>& update(const WaveformBuffer& buffer, double sampleRate, int columns);
+
+private:
+    QList<QPointF> m_points;
+    double m_sampleRate = 0.0;
+    int m_perColumn = 0;
+    qint64 m_nextIndex = 0;     // 上一帧的缓冲末端 (全局样本索引)
+};
+
+} // namespace WaveformDecimator
@@ -0,0 +1,253 @@
+#include "waveletdenoiser.h"
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// CDF 9/7 提升系数 (Daubechies & Sweldens 1998), 两次预测 + 两次更新 + 缩放
+constexpr double kAlpha = -1.586134342059924;
+constexpr double kBeta = -0.052980118572961;
+constexpr double kGamma = 0.882911075530934;
+constexpr double kDelta = 0.443506852043971;
+// 近似 x ζ、细节 / ζ: 近似直流增益为 √2, 两路白噪声增益均接近1, 各级细节可共用一个噪声估计
+constexpr double kZeta = 1.149604398860241;
+
+constexpr double kCoarsestDetailHz = 8.0;   // 最粗一级细节频带下限, 其下的P/T波与基线不做处理
+constexpr int kMaxLevels = 6;
+constexpr double kThresholdFactor = 2.0;    // 阈值 = 2σ
+constexpr double kMadScale = 0.6745;        // 高斯噪声 MAD / σ
+constexpr double kSigmaSmoothing = 0.2;     // 流式噪声估计的逐帧平滑系数
+constexpr double kMinEnergy = 1e-300;       // 零系数的收缩增益按0计, 避免 0/0
+
+// 帧长按 2^L 的整数倍取, 每级分解长度均为偶数; 上下文长度覆盖 L 级滤波器的影响范围,
+// 使帧边界处的延拓误差远小于阈值
+constexpr int kHopBlocks = 4;
+constexpr int kMarginBlocks = 2;
+
+// ============================================================
+// 提升内核: 近似/细节分存两个数组, 每一步是一个连续访存的循环, 便于编译器向量化
+// 边界为整样本对称延拓: s[h] = s[h-1], d[-1] = d[0]
+// ============================================================
+
+void predict(const double* s, double* d, int h, double c)
+{
+    for (int i = 0; i < h - 1; ++i) {
+        d[i] += c * (s[i] + s[i + 1]);
+    }
+    d[h - 1] += 2.0 * c * s[h - 1];
+}
+
+void update(double* s, const double* d, int h, double c)
+{
+    s[0] += 2.0 * c * d[0];
+    for (int i = 1; i < h; ++i) {
+        s[i] += c * (d[i - 1] + d[i]);
+    }
+}
+
+// 一级正变换: x[0, n) (n 为偶数) 变为 [近似 n/2 | 细节 n/2], tmp 至少 n 个元素
+void forwardLevel(double* x, int n, double* tmp)
+{
+    const int h = n / 2;
+    double* s = tmp;
+    double* d = tmp + h;
+    for (int i = 0; i < h; ++i) {
+        s[i] = x[2 * i];
+        d[i] = x[2 * i + 1];
+    }
+    predict(s, d, h, kAlpha);
+    update(s, d, h, kBeta);
+    predict(s, d, h, kGamma);
+    update(s, d, h, kDelta);
+    for (int i = 0; i < h; ++i) {
+        x[i] = s[i] * kZeta;
+        x[h + i] = d[i] * (1.0 / kZeta);
+    }
+}
+
+void inverseLevel(double* x, int n, double* tmp)
+{
+    const int h = n / 2;
+    double* s = tmp;
+    double* d = tmp + h;
+    for (int i = 0; i < h; ++i) {
+        s[i] = x[i] * (1.0 / kZeta);
+        d[i] = x[h + i] * kZeta;
+    }
+    update(s, d, h, -kDelta);
+    predict(s, d, h, -kGamma);
+    update(s, d, h, -kBeta);
+    predict(s, d, h, -kAlpha);
+    for (int i = 0; i < h; ++i) {
+        x[2 * i] = s[i];
+        x[2 * i + 1] = d[i];
+    }
+}
+
+// 非负 garrote 收缩: |c| <= λ 置零, 其余 c - λ²/c
+// 小系数与软阈值一样连续收缩 (无硬阈值的振铃), 大系数近似无偏: 软阈值对QRS系数
+// 一律减去 λ, 在 denoise_bench 中使R波幅度损失 7-20%, garrote 损失不到 4%
+void garroteShrink(double* c, int n, double lambda)
+{
+    const double lambda2 = lambda * lambda;
+    for (int i = 0; i < n; ++i) {
+        // 写成增益 max(0, 1 - λ²/c²) 的形式, 循环内无分支, 可向量化
+        const double v = c[i];
+        c[i] = v * std::max(0.0, 1.0 - lambda2 / std::max(v * v, kMinEnergy));
+    }
+}
+
+// 最细一级细节系数的 MAD 噪声估计, scratch 至少 n 个元素
+double estimateSigma(const double* detail, int n, double* scratch)
+{
+    for (int i = 0; i < n; ++i) scratch[i] = std::abs(detail[i]);
+    double* mid = scratch + n / 2;
+    std::nth_element(scratch, mid, scratch + n);
+    return *mid / kMadScale;
+}
+
+// x[0, n) 就地分解 levels 级 (n 须为 2^levels 的整数倍)
+void decompose(double* x, int n, int levels, double* tmp)
+{
+    for (int k = 0; k < levels; ++k) {
+        forwardLevel(x, n >> k, tmp);
+    }
+}
+
+// 收缩全部细节系数后就地重构
+void shrinkAndReconstruct(double* x, int n, int levels, double lambda, double* tmp)
+{
+    const int approx = n >> levels;
+    garroteShrink(x + approx, n - approx, lambda);
+    for (int k = levels - 1; k >= 0; --k) {
+        inverseLevel(x, n >> k, tmp);
+    }
+}
+
+} // namespace
+
+WaveletDenoiser::WaveletDenoiser()
+{
+    setSampleRate(200);
+}
+
+WaveletDenoiser::WaveletDenoiser(int sampleRate)
+{
+    setSampleRate(sampleRate);
+}
+
+int WaveletDenoiser::levelsForRate(int sampleRate)
+{
+    // 第 L 级细节频带约为 [fs/2^(L+1), fs/2^L]
+    return qBound(1, qRound(std::log2(qMax(1, sampleRate) / (2.0 * kCoarsestDetailHz))), kMaxLevels);
+}
+
+void WaveletDenoiser::setSampleRate(int sampleRate)
+{
+    m_sampleRate = qMax(1, sampleRate);
+    m_levels = levelsForRate(m_sampleRate);
+    m_hop = kHopBlocks << m_levels;
+    m_margin = kMarginBlocks << m_levels;
+
+    const int frame = m_hop + 2 * m_margin;
+    m_coeffs.resize(frame);
+    m_scratch.resize(frame);
+    reset();
+}
+
+void WaveletDenoiser::reset()
+{
+    m_buffer.clear();
+    m_buffer.reserve(m_hop + 2 * m_margin);
+    m_started = false;
+    m_sigma = 0.0;
+}
+
+// ============================================================
+// 流式处理
+// ============================================================
+
+QVector<double> WaveletDenoiser::process(const QVector<double>& input)
+{
+    QVector<double> output;
+    output.reserve(input.size() + m_hop);
+    process(input.constData(), input.size(), output);
+    return output;
+}
+
+void WaveletDenoiser::process(const double* input, int count, QVector<double>& output)
+{
+    if (count <= 0) return;
+
+    // 首帧左侧上下文以首个样本填充, 直流偏置不在开头形成阶跃
+    if (!m_started) {
+        m_buffer.fill(input[0], m_margin);
+        m_started = true;
+    }
+
+    const int frame = m_hop + 2 * m_margin;
+    for (int i = 0; i < count; ) {
+        const int filled = m_buffer.size();
+        const int take = qMin(count - i, frame - filled);
+        m_buffer.resize(filled + take);
+        std::copy(input + i, input + i + take, m_buffer.begin() + filled);
+        i += take;
+        if (m_buffer.size() == frame) {
+            processFrame(output);
+        }
+    }
+}
+
+void WaveletDenoiser::processFrame(QVector<double>& output)
+{
+    const int frame = m_buffer.size();
+    double* x = m_coeffs.data();
+    std::copy(m_buffer.constBegin(), m_buffer.constEnd(), x);
+
+    decompose(x, frame, m_levels, m_scratch.data());
+
+    // 噪声电平逐帧估计后平滑, 单帧内的QRS不会使阈值跳变
+    const double sigma = estimateSigma(x + frame / 2, frame / 2, m_scratch.data());
+    m_sigma = m_sigma > 0.0 ? m_sigma + kSigmaSmoothing * (sigma - m_sigma) : sigma;
+
+    shrinkAndReconstruct(x, frame, m_levels, kThresholdFactor * m_sigma, m_scratch.data());
+
+    // 只输出中段, 两侧上下文吸收帧边界的延拓误差
+    const int produced = output.size();
+    output.resize(produced + m_hop);
+    std::copy(x + m_margin, x + m_margin + m_hop, output.begin() + produced);
+    std::copy(m_buffer.constBegin() + m_hop, m_buffer.constEnd(), m_buffer.begin());
+    m_buffer.resize(frame - m_hop);
+}
+
+// ============================================================
+// 离线整段去噪
+// ============================================================
+
+QVector<double> WaveletDenoiser::denoise(const QVector<double>& input, int sampleRate)
+{
+    const int n = input.size();
+    if (n < 2) return input;
+
+    const int levels = levelsForRate(sampleRate);
+    const int block = 1 << levels;
+    const int padded = (n + block - 1) / block * block;
+
+    // 末尾按整样本对称延拓补齐到 2^L 的整数倍 (周期 2(n-1) 的镜像)
+    QVector<double> x(padded);
+    std::copy(input.constBegin(), input.constEnd(), x.begin());
+    const int period = 2 * (n - 1);
+    for (int i = n; i < padded; ++i) {
+        int j = i % period;
+        x[i] = input[j < n ? j : period - j];
+    }
+
+    QVector<double> tmp(padded);
+    decompose(x.data(), padded, levels, tmp.data());
+    const double sigma = estimateSigma(x.constData() + padded / 2, padded / 2, tmp.data());
+    shrinkAndReconstruct(x.data(), padded, levels, kThresholdFactor * sigma, tmp.data());
+
+    x.resize(n);
+    return x;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <QVector>
+
+// 小波阈值去噪: CDF 9/7 双正交小波 (提升格式) 多级分解, 细节系数阈值收缩后重构
+//
+// 与单极点低通相比, QRS 的陡峭边沿集中在少数大幅值细节系数上, 阈值收缩只去掉噪声
+// 主导的小系数, R波幅度和宽度基本不受影响; 低于最粗一级细节频带的P/T波与基线
+// 留在近似系数中不做处理。CDF 9/7 滤波器对称 (线性相位), 边界采用整样本对称延拓,
+// 重构无相位失真
+//
+// 噪声标准差取最细一级细节系数的 MAD / 0.6745 (Donoho), 阈值为其固定倍数,
+// 对噪声电平变化自适应
+class WaveletDenoiser {
+public:
+    WaveletDenoiser();
+    explicit WaveletDenoiser(int sampleRate);
+
+    void setSampleRate(int sampleRate);
+    int sampleRate() const { return m_sampleRate; }
+
+    // 分解层数: 最粗一级细节频带下限约 8Hz, 随采样率选取
+    int levels() const { return m_levels; }
+    static int levelsForRate(int sampleRate);
+
+    // 流式处理按帧进行: 每帧输出 hopSize 个样本, 两侧各带 marginSize 个样本的重叠上下文
+    int hopSize() const { return m_hop; }
+    int marginSize() const { return m_margin; }
+    // 输出相对输入的最大延迟 (样本); 输出样本与输入样本一一对应, 不改变时间轴
+    int latencySamples() const { return m_hop + m_margin - 1; }
+
+    // 当前噪声标准差估计 (mV), 尚未处理完整一帧时为0
+    double noiseSigma() const { return m_sigma; }
+
+    // 流式处理: 输入任意长度数据块, 返回本块可产生的输出样本
+    QVector<double> process(const QVector<double>& input);
+    void process(const double* input, int count, QVector<double>& output);
+
+    void reset();
+
+    // 离线整段去噪: 输出与输入等长, 噪声按整段估计
+    static QVector<double> denoise(const QVector<double>& input, int sampleRate);
+
+private:
+    void processFrame(QVector<double>& output);
+
+    int m_sampleRate = 200;
+    int m_levels = 4;
+    int m_hop = 64;
+    int m_margin = 64;
+
+    // 输入缓冲: 当前帧的 [左侧上下文 | 输出段 | 右侧上下文], 凑满一帧即处理并前移 m_hop
+    QVector<double> m_buffer;
+    bool m_started = false;
+
+    // 变换工作区, 避免逐帧分配
+    QVector<double> m_coeffs;
+    QVector<double> m_scratch;
+    double m_sigma = 0.0;
+};
@@ -0,0 +1,234 @@
+#include "waveletqrsdetector.h"
+#include <QtMath>
+#include <QDataStream>
+#include <algorithm>
+
+namespace {
+
+constexpr double kScaleCentreHz = 15.6;     // 尺度 2^J 的选取: fs / 2^J 最接近该值
+constexpr double kPairWindowSec = 0.12;     // 正负模极大值的最大间隔
+constexpr double kPairRatio = 0.3;          // 较弱一极需达到较强一极的30%才构成极大值对
+constexpr double kThresholdFraction = 0.3;  // 阈值 = 噪声 + 30% × (信号 - 噪声)
+constexpr double kTWaveSec = 0.36;
+constexpr double kTWaveRatio = 0.5;         // 上一搏360ms内的候选需达到上一搏的一半
+constexpr double kRSearchSec = 0.05;
+constexpr double kSearchbackSec = 1.66;
+
+int lineLength(int level)
+{
+    return 1 << (level + 1);
+}
+
+} // namespace
+
+WaveletQrsDetector::WaveletQrsDetector(QObject* parent)
+    : QrsDetector(parent)
+{
+    setSampleRate(200);
+}
+
+void WaveletQrsDetector::configure()
+{
+    m_levels = qBound(1, qRound(std::log2(m_sampleRate / kScaleCentreHz)), kMaxLevels);
+    // 各级 h 的群延迟 1.5 × 2^(k-1), 末级 g 为 0.5 × 2^(J-1), 合计 2^J - 1.5
+    m_groupDelay = qRound((1 << m_levels) - 1.5);
+    m_pairWindow = qMax(2, qRound(kPairWindowSec * m_sampleRate));
+    m_refractorySamples = static_cast<int>(0.2 * m_sampleRate);
+    m_tWaveSamples = qRound(kTWaveSec * m_sampleRate);
+    m_rSearch = qMax(1, qRound(kRSearchSec * m_sampleRate));
+
+    int total = 0;
+    for (int k = 1; k <= m_levels; ++k) {
+        m_lineOffset[k - 1] = total;
+        total += lineLength(k);
+    }
+    m_lines.resize(total);
+}
+
+void WaveletQrsDetector::resetDetector()
+{
+    m_lines.fill(0.0);
+    std::fill(std::begin(m_linePos), std::end(m_linePos), 0);
+    m_threshold = 0.0;
+    m_signalLevel = 0.0;
+    m_noiseLevel = 0.0;
+    m_lastPairValue = 0.0;
+    m_lastPeakIndex = -1;
+    m_lastSearchbackIndex = -1;
+    m_inEvent = false;
+    m_eventStart = -1;
+    m_eventMax = 0.0;
+    m_eventMaxIndex = -1;
+    m_eventMin = 0.0;
+    m_eventMinIndex = -1;
+}
+
+double WaveletQrsDetector::transform(double value)
+{
+    double a = value;
+    for (int k = 1; k <= m_levels; ++k) {
+        double* line = m_lines.data() + m_lineOffset[k - 1];
+        const int mask = lineLength(k) - 1;
+        const int step = 1 << (k - 1);
+        int& pos = m_linePos[k - 1];
+
+        line[pos] = a;
+        const double x1 = line[(pos - step) & mask];
+        if (k == m_levels) {
+            // 细节: g = [2 -2]
+            pos = (pos + 1) & mask;
+            return 2.0 * (a - x1);
+        }
+        // 近似: h = [1 3 3 1] / 8
+        const double x2 = line[(pos - 2 * step) & mask];
+        const double x3 = line[(pos - 3 * step) & mask];
+        pos = (pos + 1) & mask;
+        a = (a + 3.0 * (x1 + x2) + x3) * 0.125;
+    }
+    return a;
+}
+
+void WaveletQrsDetector::detect(double value)
+{
+    // 延迟线以首个样本填充, 直流偏置不在开头形成阶跃
+    if (m_globalIndex == 0) m_lines.fill(value);
+    const double w = transform(value);
+
+    // 初始学习阶段: 前2秒只收集统计数据
+    if (m_globalIndex < m_sampleRate * 2) {
+        m_signalLevel = qMax(m_signalLevel, qAbs(w));
+        m_threshold = m_signalLevel * kThresholdFraction;
+        return;
+    }
+
+    // 输入中断后, 滤波器组对阶跃的响应衰减前不形成候选
+    if (m_globalIndex < m_discontinuityIndex + m_refractorySamples + 2 * m_groupDelay) {
+        return;
+    }
+
+    if (!m_inEvent) {
+        if (qAbs(w) > m_threshold) {
+            m_inEvent = true;
+            m_eventStart = m_globalIndex;
+            m_eventMax = qMax(w, 0.0);
+            m_eventMaxIndex = m_globalIndex;
+            m_eventMin = qMin(w, 0.0);
+            m_eventMinIndex = m_globalIndex;
+        }
+    } else {
+        if (w > m_eventMax) {
+            m_eventMax = w;
+            m_eventMaxIndex = m_globalIndex;
+        }
+        if (w < m_eventMin) {
+            m_eventMin = w;
+            m_eventMinIndex = m_globalIndex;
+        }
+        if (m_globalIndex - m_eventStart >= m_pairWindow) {
+            closeEvent();
+        }
+    }
+
+    // 长时间没有检出 (>1.66s) 时阈值减半, 每个回溯周期只降低一次
+    if (m_lastPeakIndex >= 0 &&
+        (m_globalIndex - qMax(m_lastPeakIndex, m_lastSearchbackIndex)) > static_cast<int>(kSearchbackSec * m_sampleRate)) {
+        m_threshold *= 0.5;
+        m_lastSearchbackIndex = m_globalIndex;
+    }
+}
+
+void WaveletQrsDetector::closeEvent()
+{
+    m_inEvent = false;
+
+    const double strong = qMax(m_eventMax, -m_eventMin);
+    const double weak = qMin(m_eventMax, -m_eventMin);
+    // 过零点近似取两极值中点, 扣除滤波器组群延迟换算回输入时刻
+    const int centre = (m_eventMaxIndex + m_eventMinIndex) / 2 - m_groupDelay;
+
+    if (m_lastPeakIndex >= 0 && centre - m_lastPeakIndex < m_refractorySamples) {
+        return;  // 同一QRS的后续波峰
+    }
+    const bool tWave = m_lastPeakIndex >= 0 && centre - m_lastPeakIndex < m_tWaveSamples &&
+                       strong < kTWaveRatio * m_lastPairValue;
+    if (weak < kPairRatio * strong || tWave) {
+        updateThreshold(strong, false);
+        return;
+    }
+
+    int peakIndex = findRawMaximum(centre - m_rSearch, centre + m_rSearch);
+    if (peakIndex < 0) return;
+
+    m_lastPeakIndex = peakIndex;
+    m_lastPairValue = strong;
+    updateThreshold(strong, true);
+    reportPeak(peakIndex, rawSample(peakIndex));
+}
+
+void WaveletQrsDetector::updateThreshold(double pairValue, bool isSignal)
+{
+    if (isSignal) {
+        m_signalLevel = 0.125 * pairValue + 0.875 * m_signalLevel;
+    } else {
+        m_noiseLevel = 0.125 * pairValue + 0.875 * m_noiseLevel;
+    }
+    m_threshold = m_noiseLevel + kThresholdFraction * (m_signalLevel - m_noiseLevel);
+}
+
+// ============================================================
+// 状态快照与输入中断
+// ============================================================
+
+void WaveletQrsDetector::discontinuity()
+{
+    m_inEvent = false;
+    if (m_lastPeakIndex >= 0) {
+        m_lastSearchbackIndex = m_globalIndex;
+    }
+}
+
+void WaveletQrsDetector::saveDetectorState(QDataStream& out) const
+{
+    out << qint32(m_levels) << m_lines;
+    for (int k = 0; k < m_levels; ++k) out << qint32(m_linePos[k]);
+    out << m_threshold << m_signalLevel << m_noiseLevel << m_lastPairValue
+        << qint32(m_lastPeakIndex) << qint32(m_lastSearchbackIndex)
+        << m_inEvent << qint32(m_eventStart)
+        << m_eventMax << qint32(m_eventMaxIndex) << m_eventMin << qint32(m_eventMinIndex);
+}
+
+bool WaveletQrsDetector::restoreDetectorState(QDataStream& in)
+{
+    qint32 levels = 0;
+    QVector<double> lines;
+    in >> levels >> lines;
+    if (in.status() != QDataStream::Ok || levels != m_levels || lines.size() != m_lines.size()) {
+        return false;
+    }
+    qint32 linePos[kMaxLevels] = {};
+    for (int k = 0; k < m_levels; ++k) in >> linePos[k];
+
+    double threshold, signalLevel, noiseLevel, lastPairValue, eventMax, eventMin;
+    qint32 lastPeakIndex, lastSearchbackIndex, eventStart, eventMaxIndex, eventMinIndex;
+    bool inEvent;
+    in >> threshold >> signalLevel >> noiseLevel >> lastPairValue
+       >> lastPeakIndex >> lastSearchbackIndex
+       >> inEvent >> eventStart >> eventMax >> eventMaxIndex >> eventMin >> eventMinIndex;
+    if (in.status() != QDataStream::Ok) return false;
+
+    m_lines = lines;
+    for (int k = 0; k < m_levels; ++k) m_linePos[k] = linePos[k] & (lineLength(k + 1) - 1);
+    m_threshold = threshold;
+    m_signalLevel = signalLevel;
+    m_noiseLevel = noiseLevel;
+    m_lastPairValue = lastPairValue;
+    m_lastPeakIndex = lastPeakIndex;
+    m_lastSearchbackIndex = lastSearchbackIndex;
+    m_inEvent = inEvent;
+    m_eventStart = eventStart;
+    m_eventMax = eventMax;
+    m_eventMaxIndex = eventMaxIndex;
+    m_eventMin = eventMin;
+    m_eventMinIndex = eventMinIndex;
+    return true;
+}
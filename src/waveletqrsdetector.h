@@ -0,0 +1,65 @@
+#pragma once
+#include "qrsdetector.h"
+
+// 基于二次样条小波的实时R波检测器 (Li 1995 / Martinez 2004 思路的流式简化)
+//
+// à trous 滤波器组 h = [1 3 3 1]/8, g = [2 -2], 逐级插零展宽, 只计算QRS能量集中的
+// 一个尺度 2^J (中心频率约 10-15 Hz, J 按采样率选取)。R波在该尺度上表现为一对
+// 符号相反的模极大值, 其间的过零点即R波位置; 单极性的基线阶跃、运动伪迹不构成
+// 极大值对, 会被拒绝。基线漂移在该尺度上几乎没有响应, 无需额外高通
+class WaveletQrsDetector : public QrsDetector {
+    Q_OBJECT
+
+public:
+    explicit WaveletQrsDetector(QObject* parent = nullptr);
+
+    Algorithm algorithm() const override { return Algorithm::Wavelet; }
+
+    int scale() const { return m_levels; }   // 使用的尺度 J (2^J)
+
+protected:
+    void configure() override;
+    void resetDetector() override;
+    void detect(double value) override;
+    void discontinuity() override;
+    void saveDetectorState(QDataStream& out) const override;
+    bool restoreDetectorState(QDataStream& in) override;
+
+private:
+    // 一个样本通过滤波器组, 返回尺度 2^J 的细节系数
+    double transform(double value);
+    // 极大值对窗口结束: 判定是否为QRS
+    void closeEvent();
+    void updateThreshold(double pairValue, bool isSignal);
+
+    static constexpr int kMaxLevels = 6;
+
+    int m_levels = 4;
+    int m_groupDelay = 14;        // 细节系数相对输入的延迟 (样本)
+    int m_pairWindow = 24;        // 极大值对的最大间隔 ~120ms
+    int m_refractorySamples = 40; // 200ms
+    int m_tWaveSamples = 72;      // 360ms 内的候选需与上一搏可比, 避免T波误检
+    int m_rSearch = 10;           // 过零点两侧寻找原始最大值的范围 ~50ms
+
+    // 各级输入的延迟线: 第 k 级 (k = 1..J) 滤波器抽头间隔 2^(k-1), 最多回看 3 * 2^(k-1) 个样本,
+    // 取 2^(k+1) 长的环形缓冲以便用掩码取模; 各级共用一块存储, m_lineOffset[k-1] 为起点
+    QVector<double> m_lines;
+    int m_lineOffset[kMaxLevels] = {};
+    int m_linePos[kMaxLevels] = {};
+
+    // 阈值
+    double m_threshold = 0.0;
+    double m_signalLevel = 0.0;
+    double m_noiseLevel = 0.0;
+    double m_lastPairValue = 0.0;
+    int m_lastPeakIndex = -1;
+    int m_lastSearchbackIndex = -1;
+
+    // 当前候选 (首次越过阈值后 m_pairWindow 个样本内的正负极值)
+    bool m_inEvent = false;
+    int m_eventStart = -1;
+    double m_eventMax = 0.0;
+    int m_eventMaxIndex = -1;
+    double m_eventMin = 0.0;
+    int m_eventMinIndex = -1;
+};